@@ -0,0 +1,510 @@
+#include "asset_cache.hpp"
+#include "file_watcher.hpp"
+#include "frame_profiler.hpp"
+#include "heap_tracker.hpp"
+#include "job_system.hpp"
+#include "resource_pack.hpp"
+#include "sdl_subsystems.hpp"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+
+const char* const DEFAULT_FONT_PATHS[] = {
+    "assets/fonts/apple2.ttf",
+    "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+    "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+    "/usr/share/fonts/truetype/liberation/LiberationMono-Regular.ttf",
+    nullptr
+};
+
+namespace {
+
+// SDL_ttf shares one FreeType library between all fonts, and FreeType
+// needs opening and closing faces serialized. Drawing with a font that is
+// already open does not take this lock.
+std::mutex& fontLibraryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t fileSize(const std::string& path) {
+    struct stat info;
+    return ::stat(path.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+}
+
+void logLoad(const AssetInfo& info) {
+    if (info.loaded) {
+        std::cout << "Loaded " << info.kind << " " << info.name << " in " << std::fixed << std::setprecision(2)
+                  << info.loadMilliseconds << " ms (" << info.bytes << " bytes)" << std::defaultfloat << std::endl;
+    } else {
+        std::cerr << "Failed to load " << info.kind << " " << info.name << std::endl;
+    }
+}
+
+std::string fontKey(const std::string& path, int pointSize) {
+    return "font:" + path + "@" + std::to_string(pointSize);
+}
+
+std::string requestKey(const AssetRequest& request) {
+    return request.kind == "font" ? fontKey(request.path, request.pointSize) : request.kind + ":" + request.path;
+}
+
+// Decoders. Safe on any thread: none of them touch the renderer. What they
+// allocate is charged to assets whichever thread runs them.
+
+std::shared_ptr<TTF_Font> decodeFont(const ResourcePack* pack, const std::string& path, int pointSize,
+                                     AssetInfo& info) {
+    HeapScope scope(HeapSubsystem::Assets);
+    auto start = std::chrono::steady_clock::now();
+    PackBlob blob;
+    bool packed = pack && pack->read(path, blob);
+    TTF_Font* font = nullptr;
+    if (requireFontLoader()) {
+        std::lock_guard<std::mutex> lock(fontLibraryMutex());
+        font = packed ? TTF_OpenFontRW(blob.openRW(), 1, pointSize) : TTF_OpenFont(path.c_str(), pointSize);
+    }
+    info.kind = "font";
+    info.name = path + " " + std::to_string(pointSize) + "pt";
+    info.loaded = font != nullptr;
+    info.loadMilliseconds = millisecondsSince(start);
+    // FreeType reads the face from the file as needed; its glyph cache
+    // comes on top of this
+    info.bytes = font ? (packed ? blob.size : fileSize(path)) : 0;
+    if (!font) {
+        return nullptr;
+    }
+    // A packed font reads from the blob for as long as it is open
+    return std::shared_ptr<TTF_Font>(font, [blob](TTF_Font* closing) {
+        std::lock_guard<std::mutex> lock(fontLibraryMutex());
+        TTF_CloseFont(closing);
+    });
+}
+
+std::shared_ptr<SDL_Surface> decodeImage(const ResourcePack* pack, const std::string& path, AssetInfo& info) {
+    HeapScope scope(HeapSubsystem::Assets);
+    auto start = std::chrono::steady_clock::now();
+    PackBlob blob;
+    SDL_Surface* surface = nullptr;
+    if (requireImageLoader()) {
+        surface = pack && pack->read(path, blob) ? IMG_Load_RW(blob.openRW(), 1) : IMG_Load(path.c_str());
+    }
+    info.kind = "image";
+    info.name = path;
+    info.loaded = surface != nullptr;
+    info.loadMilliseconds = millisecondsSince(start);
+    info.bytes = surface ? static_cast<size_t>(surface->w) * static_cast<size_t>(surface->h) * 4 : 0;
+    if (!surface) {
+        return nullptr;
+    }
+    return std::shared_ptr<SDL_Surface>(surface, SDL_FreeSurface);
+}
+
+std::shared_ptr<Mix_Chunk> decodeSound(const ResourcePack* pack, const std::string& path, AssetInfo& info) {
+    HeapScope scope(HeapSubsystem::Assets);
+    auto start = std::chrono::steady_clock::now();
+    PackBlob blob;
+    Mix_Chunk* chunk = nullptr;
+    if (requireAudio()) {
+        chunk = pack && pack->read(path, blob) ? Mix_LoadWAV_RW(blob.openRW(), 1) : Mix_LoadWAV(path.c_str());
+    }
+    info.kind = "sound";
+    info.name = path;
+    info.loaded = chunk != nullptr;
+    info.loadMilliseconds = millisecondsSince(start);
+    info.bytes = chunk ? chunk->alen : 0;
+    if (!chunk) {
+        return nullptr;
+    }
+    return std::shared_ptr<Mix_Chunk>(chunk, Mix_FreeChunk);
+}
+
+void splitLines(std::istream& input, std::vector<std::string>& lines, size_t& bytes) {
+    std::string line;
+    while (std::getline(input, line)) {
+        bytes += line.size() + 1;
+        lines.push_back(line);
+    }
+}
+
+std::shared_ptr<std::vector<std::string>> decodeText(const ResourcePack* pack, const std::string& path,
+                                                     AssetInfo& info) {
+    HeapScope scope(HeapSubsystem::Assets);
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<std::vector<std::string>> lines;
+    size_t bytes = 0;
+    PackBlob blob;
+    if (pack && pack->read(path, blob)) {
+        lines = std::make_shared<std::vector<std::string>>();
+        std::istringstream input(std::string(reinterpret_cast<const char*>(blob.data), blob.size));
+        splitLines(input, *lines, bytes);
+    } else {
+        std::ifstream file(path);
+        if (file.is_open()) {
+            lines = std::make_shared<std::vector<std::string>>();
+            splitLines(file, *lines, bytes);
+        }
+    }
+    info.kind = "text";
+    info.name = path;
+    info.loaded = lines != nullptr;
+    info.loadMilliseconds = millisecondsSince(start);
+    info.bytes = bytes;
+    return lines;
+}
+
+} // namespace
+
+std::vector<AssetRequest> parseAssetManifest(const std::vector<std::string>& lines, const std::string& path) {
+    std::vector<AssetRequest> requests;
+    int lineNumber = 0;
+    for (std::string line : lines) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        AssetRequest request;
+        if (!(fields >> request.kind >> request.path)) {
+            continue;   // Blank or comment
+        }
+        std::string extra;
+        while (fields >> extra) {
+            if (extra == "optional") {
+                request.required = false;
+            } else {
+                request.pointSize = std::atoi(extra.c_str());
+            }
+        }
+
+        bool valid = request.kind == "image" || request.kind == "sound" || request.kind == "text" ||
+                     (request.kind == "font" && request.pointSize > 0);
+        if (!valid) {
+            std::cerr << path << ":" << lineNumber << ": unrecognized asset \"" << line << "\"" << std::endl;
+            continue;
+        }
+        requests.push_back(request);
+    }
+    return requests;
+}
+
+AssetCache::AssetCache(SDL_Renderer* renderer, std::shared_ptr<const ResourcePack> pack)
+    : m_renderer(renderer)
+    , m_pack(std::move(pack))
+{
+}
+
+AssetCache::~AssetCache() {
+    for (const auto& entry : m_entries) {
+        if (entry.second.asset && entry.second.asset.use_count() > 1) {
+            std::cerr << "Asset " << entry.second.info.name << " is still held by "
+                      << entry.second.asset.use_count() - 1 << " user(s) at shutdown" << std::endl;
+        }
+    }
+}
+
+AssetCache::Entry* AssetCache::find(const std::string& key) {
+    auto it = m_entries.find(key);
+    return it != m_entries.end() ? &it->second : nullptr;
+}
+
+AssetCache::Entry& AssetCache::add(const std::string& key, AssetInfo info, std::shared_ptr<void> asset) {
+    HeapScope scope(HeapSubsystem::Assets);
+    logLoad(info);
+    if (m_watcher && info.kind == "text") {
+        m_watcher->watch(info.name);
+    }
+    Entry& entry = m_entries[key];
+    entry.info = std::move(info);
+    entry.asset = std::move(asset);
+    return entry;
+}
+
+std::shared_ptr<SDL_Texture> AssetCache::upload(SDL_Surface* surface) {
+    countTextureUpload();
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(m_renderer, surface);
+    if (!texture) {
+        std::cerr << "Unable to create texture: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    return std::shared_ptr<SDL_Texture>(texture, SDL_DestroyTexture);
+}
+
+std::shared_ptr<TTF_Font> AssetCache::getFont(const std::string& path, int pointSize) {
+    std::string key = fontKey(path, pointSize);
+    Entry* entry = find(key);
+    if (!entry) {
+        AssetInfo info;
+        std::shared_ptr<TTF_Font> font = decodeFont(m_pack.get(), path, pointSize, info);
+        entry = &add(key, std::move(info), std::move(font));
+    }
+    return std::static_pointer_cast<TTF_Font>(entry->asset);
+}
+
+std::shared_ptr<TTF_Font> AssetCache::getDefaultFont(int pointSize, bool loadIfMissing) {
+    auto known = m_defaultFontKeys.find(pointSize);
+    if (known != m_defaultFontKeys.end()) {
+        Entry* entry = find(known->second);
+        if (entry) {
+            return std::static_pointer_cast<TTF_Font>(entry->asset);
+        }
+        if (known->second.empty()) {
+            return nullptr;     // Nothing loads; do not keep trying
+        }
+    }
+
+    for (int i = 0; DEFAULT_FONT_PATHS[i] != nullptr; ++i) {
+        std::string key = fontKey(DEFAULT_FONT_PATHS[i], pointSize);
+        Entry* entry = find(key);
+        if (!entry && !loadIfMissing) {
+            return nullptr;     // Earlier choices not tried yet
+        }
+        std::shared_ptr<TTF_Font> font = getFont(DEFAULT_FONT_PATHS[i], pointSize);
+        if (font) {
+            m_defaultFontKeys[pointSize] = key;
+            return font;
+        }
+    }
+    std::cerr << "Failed to load any font at " << pointSize << "pt" << std::endl;
+    m_defaultFontKeys[pointSize] = "";
+    return nullptr;
+}
+
+std::shared_ptr<SDL_Texture> AssetCache::getImage(const std::string& path, bool loadIfMissing) {
+    std::string key = "image:" + path;
+    Entry* entry = find(key);
+    if (!entry && !loadIfMissing) {
+        return nullptr;
+    }
+    if (!entry) {
+        AssetInfo info;
+        std::shared_ptr<SDL_Surface> surface = decodeImage(m_pack.get(), path, info);
+        std::shared_ptr<SDL_Texture> texture;
+        if (surface) {
+            auto start = std::chrono::steady_clock::now();
+            texture = upload(surface.get());
+            info.loadMilliseconds += millisecondsSince(start);
+            info.loaded = texture != nullptr;
+        }
+        entry = &add(key, std::move(info), std::move(texture));
+    }
+    return std::static_pointer_cast<SDL_Texture>(entry->asset);
+}
+
+std::shared_ptr<Mix_Chunk> AssetCache::getSound(const std::string& path) {
+    std::string key = "sound:" + path;
+    Entry* entry = find(key);
+    if (!entry) {
+        AssetInfo info;
+        std::shared_ptr<Mix_Chunk> sound = decodeSound(m_pack.get(), path, info);
+        entry = &add(key, std::move(info), std::move(sound));
+    }
+    return std::static_pointer_cast<Mix_Chunk>(entry->asset);
+}
+
+std::shared_ptr<const std::vector<std::string>> AssetCache::getTextLines(const std::string& path) {
+    std::string key = "text:" + path;
+    Entry* entry = find(key);
+    if (!entry) {
+        AssetInfo info;
+        std::shared_ptr<std::vector<std::string>> lines = decodeText(m_pack.get(), path, info);
+        entry = &add(key, std::move(info), std::move(lines));
+    }
+    return std::static_pointer_cast<const std::vector<std::string>>(entry->asset);
+}
+
+void AssetCache::preload(const std::vector<AssetRequest>& requests, JobSystem& jobs) {
+    HeapScope scope(HeapSubsystem::Assets);
+    auto start = std::chrono::steady_clock::now();
+    size_t started = 0;
+
+    for (const AssetRequest& request : requests) {
+        std::string key = requestKey(request);
+        if (find(key) || m_inFlight.count(key)) {
+            continue;
+        }
+        m_inFlight.insert(key);
+        ++m_progress.total;
+        if (request.required) {
+            ++m_progress.requiredTotal;
+        }
+        ++m_preloading;
+        ++started;
+
+        // Workers decode; results come back to the main thread between
+        // frames. Images still need a texture, so they queue for upload.
+        jobs.run([this, &jobs, request, key] {
+            AssetInfo info;
+            if (request.kind == "image") {
+                std::shared_ptr<SDL_Surface> surface = decodeImage(m_pack.get(), request.path, info);
+                jobs.post([this, request, key, info, surface] {
+                    --m_preloading;
+                    if (surface) {
+                        m_uploads.push_back(PendingUpload{key, info, surface, request.required});
+                    } else {
+                        finishPreload(key, info, nullptr, request.required);
+                    }
+                });
+                return;
+            }
+
+            std::shared_ptr<void> asset;
+            if (request.kind == "font") {
+                asset = decodeFont(m_pack.get(), request.path, request.pointSize, info);
+            } else if (request.kind == "sound") {
+                asset = decodeSound(m_pack.get(), request.path, info);
+            } else {
+                asset = decodeText(m_pack.get(), request.path, info);
+            }
+            jobs.post([this, request, key, info, asset] {
+                --m_preloading;
+                finishPreload(key, info, asset, request.required);
+            });
+        });
+    }
+
+    if (started > 0) {
+        std::cout << "Preloading " << started << " assets on " << jobs.getWorkerCount() << " workers (queued in "
+                  << std::fixed << std::setprecision(2) << millisecondsSince(start) << " ms)"
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+size_t AssetCache::uploadPending(size_t byteBudget) {
+    HeapScope scope(HeapSubsystem::Assets);
+    size_t uploaded = 0;
+    while (!m_uploads.empty() && (uploaded == 0 || uploaded + m_uploads.front().info.bytes <= byteBudget)) {
+        PendingUpload pending = std::move(m_uploads.front());
+        m_uploads.pop_front();
+
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<SDL_Texture> texture = upload(pending.surface.get());
+        pending.info.loadMilliseconds += millisecondsSince(start);
+        pending.info.loaded = texture != nullptr;
+        uploaded += pending.info.bytes;
+        pending.surface.reset();
+
+        finishPreload(pending.key, pending.info, texture, pending.required);
+    }
+    return uploaded;
+}
+
+void AssetCache::finishPreload(const std::string& key, AssetInfo info, std::shared_ptr<void> asset, bool required) {
+    HeapScope scope(HeapSubsystem::Assets);
+    m_inFlight.erase(key);
+    ++m_progress.finished;
+    if (required) {
+        ++m_progress.requiredFinished;
+    }
+    m_progress.bytes += info.bytes;
+
+    // Someone may have asked for it and loaded it on the spot meanwhile
+    if (!find(key)) {
+        add(key, std::move(info), std::move(asset));
+    }
+}
+
+void AssetCache::onReload(const std::string& path, std::weak_ptr<void> receiver, std::function<void()> callback) {
+    std::vector<ReloadListener>& listeners = m_reloadListeners[path];
+    // States come and go; forget the ones that have gone
+    listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                   [](const ReloadListener& listener) { return listener.receiver.expired(); }),
+                    listeners.end());
+    listeners.push_back(ReloadListener{std::move(receiver), std::move(callback)});
+}
+
+bool AssetCache::reload(const std::string& path) {
+    HeapScope scope(HeapSubsystem::Assets);
+    Entry* entry = find("text:" + path);
+    if (!entry) {
+        return false;
+    }
+
+    AssetInfo info;
+    std::shared_ptr<std::vector<std::string>> lines = decodeText(nullptr, path, info);
+    if (!lines) {
+        std::cerr << "Unable to reload " << path << "; keeping the previous version" << std::endl;
+        return false;
+    }
+    std::cout << "Reloaded " << path << " (" << info.bytes << " bytes)" << std::endl;
+    entry->info = std::move(info);
+    entry->asset = std::move(lines);
+
+    // Callbacks may register listeners of their own, so run a copy
+    std::vector<ReloadListener> listeners = m_reloadListeners[path];
+    for (const ReloadListener& listener : listeners) {
+        if (!listener.receiver.expired()) {
+            listener.callback();
+        }
+    }
+    return true;
+}
+
+bool AssetCache::isCached(const AssetRequest& request) const {
+    return m_entries.count(requestKey(request)) > 0;
+}
+
+bool AssetCache::isLoading(const AssetRequest& request) const {
+    return m_inFlight.count(requestKey(request)) > 0;
+}
+
+size_t AssetCache::release(const AssetRequest& request) {
+    auto it = m_entries.find(requestKey(request));
+    if (it == m_entries.end() || (it->second.asset && it->second.asset.use_count() > 1)) {
+        return 0;
+    }
+    size_t bytes = it->second.info.bytes;
+    std::cout << "Released " << it->second.info.kind << " " << it->second.info.name << std::endl;
+    m_entries.erase(it);
+    return bytes;
+}
+
+size_t AssetCache::releaseUnused() {
+    size_t released = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.asset && it->second.asset.use_count() == 1) {
+            std::cout << "Released " << it->second.info.kind << " " << it->second.info.name << std::endl;
+            it = m_entries.erase(it);
+            ++released;
+        } else {
+            ++it;
+        }
+    }
+    return released;
+}
+
+std::vector<AssetInfo> AssetCache::getReport() const {
+    std::vector<AssetInfo> report;
+    for (const auto& entry : m_entries) {
+        AssetInfo info = entry.second.info;
+        info.users = entry.second.asset ? entry.second.asset.use_count() - 1 : 0;
+        report.push_back(info);
+    }
+    return report;
+}
+
+size_t AssetCache::getTotalBytes() const {
+    size_t total = 0;
+    for (const auto& entry : m_entries) {
+        total += entry.second.info.bytes;
+    }
+    return total;
+}
+
+void AssetCache::printReport(std::ostream& out) const {
+    std::vector<AssetInfo> report = getReport();
+    out << "Assets: " << report.size() << " loaded, " << getTotalBytes() << " bytes" << std::endl;
+    for (const AssetInfo& info : report) {
+        out << "  " << std::left << std::setw(6) << info.kind << std::right << std::setw(10) << info.bytes
+            << " bytes " << std::fixed << std::setprecision(2) << std::setw(8) << info.loadMilliseconds
+            << " ms " << std::setw(3) << info.users << " users  " << info.name
+            << (info.loaded ? "" : " (failed)") << std::defaultfloat << std::endl;
+    }
+}
@@ -0,0 +1,171 @@
+#ifndef ASSET_CACHE_HPP
+#define ASSET_CACHE_HPP
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+class FileWatcher;
+class JobSystem;
+class ResourcePack;
+
+// The game font, and the system fonts tried when it is missing
+extern const char* const DEFAULT_FONT_PATHS[];
+
+// What the cache knows about one loaded asset
+struct AssetInfo {
+    std::string kind;               // "font", "image", "sound" or "text"
+    std::string name;               // Path, plus the point size for fonts
+    bool loaded = false;            // False if loading failed (not retried)
+    double loadMilliseconds = 0.0;  // Reading and decoding, wherever it ran
+    size_t bytes = 0;               // Font file, texture pixels, samples or text
+    long users = 0;                 // Handles held outside the cache
+};
+
+// One line of a preload manifest
+struct AssetRequest {
+    std::string kind;               // As in AssetInfo
+    std::string path;
+    int pointSize = 0;              // Fonts only
+    bool required = true;           // The loading screen waits for it
+};
+
+// Parses a manifest: one "<kind> <path> [point size] [optional]" per line,
+// '#' starts a comment. path names it in messages.
+std::vector<AssetRequest> parseAssetManifest(const std::vector<std::string>& lines, const std::string& path);
+
+// How far a preload has got
+struct PreloadProgress {
+    size_t total = 0;
+    size_t finished = 0;            // Loaded or failed
+    size_t requiredTotal = 0;
+    size_t requiredFinished = 0;
+    size_t bytes = 0;               // Of everything finished so far
+};
+
+// Fonts, images, sounds and text files, each loaded from disk once and
+// shared by every state that asks for it. States come and go (a journey's
+// screens are built for it and dropped after); the cache keeps what they
+// loaded, so switching states does no file I/O.
+//
+// Handles are shared_ptrs: the cache holds one reference to every asset
+// and releaseUnused() drops the assets nobody else holds.
+//
+// preload() reads and decodes on the job system's workers. Only what
+// needs the renderer, turning decoded images into textures, is left to
+// the main thread, which does a budgeted amount of it each frame in
+// uploadPending(). Everything else here is main thread only, like the
+// renderer. The cache must be destroyed before TTF_Quit() and the
+// renderer, after the job system and every state that holds a handle.
+//
+// Paths are looked up in the resource pack first, if there is one, and
+// read from disk only when it does not have them.
+class AssetCache {
+public:
+    explicit AssetCache(SDL_Renderer* renderer, std::shared_ptr<const ResourcePack> pack = nullptr);
+    ~AssetCache();
+
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    // Loaded on the spot unless already cached. Null if the file cannot
+    // be loaded.
+    std::shared_ptr<TTF_Font> getFont(const std::string& path, int pointSize);
+    // With loadIfMissing false, null unless already cached (for drawing
+    // streamed art without ever waiting on the disk).
+    std::shared_ptr<SDL_Texture> getImage(const std::string& path, bool loadIfMissing = true);
+    std::shared_ptr<Mix_Chunk> getSound(const std::string& path);
+    std::shared_ptr<const std::vector<std::string>> getTextLines(const std::string& path);
+
+    // The first of DEFAULT_FONT_PATHS that loads. With loadIfMissing
+    // false, null unless one is already cached.
+    std::shared_ptr<TTF_Font> getDefaultFont(int pointSize = 16, bool loadIfMissing = true);
+
+    // Start loading everything in requests that is not cached or loading yet
+    void preload(const std::vector<AssetRequest>& requests, JobSystem& jobs);
+
+    // Upload decoded images to the GPU, stopping once byteBudget bytes of
+    // pixels have gone this call (but always at least one image). Called
+    // once a frame; returns the bytes uploaded.
+    size_t uploadPending(size_t byteBudget);
+
+    // Assets still being decoded or waiting for upload
+    bool hasPendingWork() const { return m_preloading > 0 || !m_uploads.empty(); }
+    bool hasPendingUploads() const { return !m_uploads.empty(); }
+    bool isRequiredReady() const { return m_progress.requiredFinished == m_progress.requiredTotal; }
+    const PreloadProgress& getPreloadProgress() const { return m_progress; }
+
+    // Cached, whether it loaded or not; false while still loading
+    bool isCached(const AssetRequest& request) const;
+    bool isLoading(const AssetRequest& request) const;
+
+    // Hot reload. With a watcher set, every text file the cache reads is
+    // watched on disk. reload() reads an edited one again, from disk even
+    // if it first came from the resource pack, and then runs the callbacks
+    // registered for it whose receiver (a state's lifetime) still exists,
+    // so only what was parsed from that file is parsed again.
+    void setFileWatcher(FileWatcher* watcher) { m_watcher = watcher; }
+    void onReload(const std::string& path, std::weak_ptr<void> receiver, std::function<void()> callback);
+    bool reload(const std::string& path);
+
+    // Drops one asset if only the cache still holds it; returns the bytes
+    // freed (0 if it is in use, still loading or not cached)
+    size_t release(const AssetRequest& request);
+
+    // Drops every asset only the cache still holds; returns how many
+    size_t releaseUnused();
+
+    std::vector<AssetInfo> getReport() const;
+    size_t getTotalBytes() const;
+    void printReport(std::ostream& out) const;
+
+private:
+    struct Entry {
+        AssetInfo info;
+        std::shared_ptr<void> asset;    // TTF_Font, SDL_Texture, Mix_Chunk or line vector
+    };
+
+    // A decoded image waiting for the renderer
+    struct PendingUpload {
+        std::string key;
+        AssetInfo info;
+        std::shared_ptr<SDL_Surface> surface;
+        bool required = false;
+    };
+
+    Entry* find(const std::string& key);
+    Entry& add(const std::string& key, AssetInfo info, std::shared_ptr<void> asset);
+    std::shared_ptr<SDL_Texture> upload(SDL_Surface* surface);
+    void finishPreload(const std::string& key, AssetInfo info, std::shared_ptr<void> asset, bool required);
+
+    // Told about a change to a file whose contents were loaded
+    struct ReloadListener {
+        std::weak_ptr<void> receiver;
+        std::function<void()> callback;
+    };
+
+    SDL_Renderer* m_renderer;
+    std::shared_ptr<const ResourcePack> m_pack;
+    FileWatcher* m_watcher = nullptr;
+    std::map<std::string, std::vector<ReloadListener>> m_reloadListeners;   // By path
+    std::map<std::string, Entry> m_entries;
+    std::map<int, std::string> m_defaultFontKeys;   // By point size; "" if none loads
+
+    // Preloading (main thread; workers hand results back through the job
+    // system's completion queue)
+    std::deque<PendingUpload> m_uploads;
+    std::set<std::string> m_inFlight;               // Keys queued or decoding
+    size_t m_preloading = 0;                        // Jobs not yet handed back
+    PreloadProgress m_progress;
+};
+
+#endif // ASSET_CACHE_HPP
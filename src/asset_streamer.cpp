@@ -0,0 +1,181 @@
+#include "asset_streamer.hpp"
+#include "job_system.hpp"
+#include "journey.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Landmarks the party will reach within this many seconds of continuous
+// travel are prefetched, beyond the next one which always is. Enough for
+// a cold read of landmark art and a music track from a slow SD card.
+const float PREFETCH_SECONDS = 4.0f;
+
+// ...or within this many days, when travelling a day per key press
+const float MIN_PREFETCH_DAYS = 10.0f;
+
+// Weight kept by the old pace for each day travelled, so a few slow days
+// (a broken wagon, snow) shrink the window without one rest day emptying it
+const float PACE_DECAY_PER_DAY = 0.8f;
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, '|')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+} // namespace
+
+LandmarkAssets parseLandmarkAssets(const std::vector<std::string>& lines, const TrailData& trail) {
+    LandmarkAssets assets(trail.landmarks.size());
+    int lineNumber = 0;
+    for (std::string line : lines) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::vector<std::string> fields = splitFields(line);
+        if (fields.size() < 3) {
+            std::cerr << "Landmark assets line " << lineNumber << " is missing fields" << std::endl;
+            continue;
+        }
+
+        auto landmark = std::find_if(trail.landmarks.begin(), trail.landmarks.end(),
+                                     [&](const Location& location) { return location.name == fields[0]; });
+        if (landmark == trail.landmarks.end()) {
+            std::cerr << "Landmark assets line " << lineNumber << " names unknown landmark \""
+                      << fields[0] << "\"" << std::endl;
+            continue;
+        }
+
+        AssetRequest request;
+        request.kind = fields[1];
+        request.path = fields[2];
+        request.pointSize = fields.size() > 3 ? std::atoi(fields[3].c_str()) : 0;
+        request.required = false;
+        bool valid = request.kind == "image" || request.kind == "sound" || request.kind == "text" ||
+                     (request.kind == "font" && request.pointSize > 0);
+        if (!valid) {
+            std::cerr << "Landmark assets line " << lineNumber << " has an unrecognized asset" << std::endl;
+            continue;
+        }
+        assets[landmark - trail.landmarks.begin()].push_back(request);
+    }
+    return assets;
+}
+
+AssetStreamer::AssetStreamer(AssetCache& cache, JobSystem& jobs, LandmarkAssets assets, size_t byteBudget)
+    : m_cache(cache)
+    , m_jobs(jobs)
+    , m_assets(std::move(assets))
+    , m_byteBudget(byteBudget)
+    , m_resident(m_assets.size(), false)
+{
+}
+
+const std::vector<AssetRequest>& AssetStreamer::getAssets(int landmarkIndex) const {
+    static const std::vector<AssetRequest> none;
+    if (landmarkIndex < 0 || landmarkIndex >= static_cast<int>(m_assets.size())) {
+        return none;
+    }
+    return m_assets[landmarkIndex];
+}
+
+void AssetStreamer::update(const Journey& journey, float travelRate) {
+    int miles = journey.getMilesTraveled();
+    int days = journey.getDaysElapsed();
+    int nextIndex = journey.getNextLandmarkIndex();
+    if (miles == m_lastMiles && nextIndex == m_lastNextIndex) {
+        return;
+    }
+
+    if (m_lastMiles < 0 || miles < m_lastMiles || days <= m_lastDays) {
+        // First update, or a rewind: nothing to learn the pace from
+        if (m_pace <= 0.0f) {
+            m_pace = static_cast<float>(journey.getParams().baseDailyMiles);
+        }
+    } else {
+        float keep = std::pow(PACE_DECAY_PER_DAY, static_cast<float>(days - m_lastDays));
+        float recent = static_cast<float>(miles - m_lastMiles) / (days - m_lastDays);
+        m_pace = keep * m_pace + (1.0f - keep) * recent;
+    }
+    m_lastMiles = miles;
+    m_lastDays = days;
+    m_lastNextIndex = nextIndex;
+
+    const std::vector<Location>& landmarks = journey.getLandmarks();
+    int landmarkCount = std::min(static_cast<int>(landmarks.size()), static_cast<int>(m_assets.size()));
+    int currentIndex = std::max(0, nextIndex - 1);
+
+    // Make room before asking for more
+    evictBehind(currentIndex, nextIndex);
+
+    float aheadDays = std::max(MIN_PREFETCH_DAYS, travelRate * PREFETCH_SECONDS);
+    float aheadMiles = miles + m_pace * aheadDays;
+    for (int i = currentIndex; i < landmarkCount; ++i) {
+        bool needed = i <= nextIndex;
+        if (!needed && landmarks[i].distance > aheadMiles) {
+            break;
+        }
+        if (!needed && m_cache.getTotalBytes() >= m_byteBudget) {
+            if (m_budgetStop != i) {
+                std::cout << "Asset budget of " << m_byteBudget << " bytes reached; not prefetching past "
+                          << landmarks[i - 1].name << std::endl;
+                m_budgetStop = i;
+            }
+            break;
+        }
+        prefetch(i);
+    }
+}
+
+void AssetStreamer::prefetch(int landmarkIndex) {
+    if (m_resident[landmarkIndex] || m_assets[landmarkIndex].empty()) {
+        return;
+    }
+    m_resident[landmarkIndex] = true;
+    m_cache.preload(m_assets[landmarkIndex], m_jobs);
+}
+
+void AssetStreamer::evictBehind(int currentIndex, int nextIndex) {
+    for (int i = 0; i < currentIndex && m_cache.getTotalBytes() > m_byteBudget; ++i) {
+        if (!m_resident[i]) {
+            continue;
+        }
+        // Anything still loading or still held by a state stays, and is
+        // tried again next time the wagon moves
+        bool released = true;
+        for (const AssetRequest& request : m_assets[i]) {
+            if (isWantedFrom(request, currentIndex, nextIndex)) {
+                continue;   // Regional music shared with a landmark ahead
+            }
+            m_cache.release(request);
+            released = released && !m_cache.isCached(request) && !m_cache.isLoading(request);
+        }
+        m_resident[i] = !released;
+    }
+}
+
+bool AssetStreamer::isWantedFrom(const AssetRequest& request, int currentIndex, int nextIndex) const {
+    for (int i = currentIndex; i < static_cast<int>(m_assets.size()); ++i) {
+        if (i > nextIndex && !m_resident[i]) {
+            continue;
+        }
+        for (const AssetRequest& other : m_assets[i]) {
+            if (other.kind == request.kind && other.path == request.path && other.pointSize == request.pointSize) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
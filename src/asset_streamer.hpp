@@ -0,0 +1,64 @@
+#ifndef ASSET_STREAMER_HPP
+#define ASSET_STREAMER_HPP
+
+#include "asset_cache.hpp"
+#include "trail_data.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+class JobSystem;
+class Journey;
+
+// Assets belonging to each landmark of a trail, by landmark index
+using LandmarkAssets = std::vector<std::vector<AssetRequest>>;
+
+// Parses "<landmark name>|<kind>|<path>[|point size]" lines ('#' starts a
+// comment). Lines naming a landmark the trail does not have are reported
+// and skipped. Every request is optional: nothing waits for streamed art.
+LandmarkAssets parseLandmarkAssets(const std::vector<std::string>& lines, const TrailData& trail);
+
+// Keeps the art, ambient audio and music of the landmarks around the wagon
+// in the asset cache, and only those. Ahead of the wagon, the assets of
+// the next landmark are always loading, along with any further landmarks
+// the party will reach within a few seconds at its current pace, so
+// arriving never waits on the disk. Behind the wagon, assets of landmarks
+// already left are released, furthest back first, whenever the cache is
+// over its byte budget. The landmark the wagon is at (or has just left)
+// stays, since its music plays until the next one.
+//
+// Main thread only, like the cache. update() is cheap unless the wagon
+// has moved.
+class AssetStreamer {
+public:
+    AssetStreamer(AssetCache& cache, JobSystem& jobs, LandmarkAssets assets, size_t byteBudget);
+
+    // Called each frame with the journey on screen; travelRate is days of
+    // travel per real second
+    void update(const Journey& journey, float travelRate);
+
+    const std::vector<AssetRequest>& getAssets(int landmarkIndex) const;
+
+    // Miles per day, averaged over recent travel
+    float getPace() const { return m_pace; }
+
+private:
+    void prefetch(int landmarkIndex);
+    void evictBehind(int currentIndex, int nextIndex);
+    bool isWantedFrom(const AssetRequest& request, int currentIndex, int nextIndex) const;
+
+    AssetCache& m_cache;
+    JobSystem& m_jobs;
+    LandmarkAssets m_assets;
+    size_t m_byteBudget;
+
+    std::vector<bool> m_resident;   // Requested and not yet released
+    int m_lastMiles = -1;
+    int m_lastDays = 0;
+    int m_lastNextIndex = -1;
+    float m_pace = 0.0f;
+    int m_budgetStop = -1;          // Landmark prefetching last stopped at, for logging
+};
+
+#endif // ASSET_STREAMER_HPP
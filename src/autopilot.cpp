@@ -0,0 +1,83 @@
+#include "autopilot.hpp"
+
+namespace {
+
+// Upper bound on key presses so a stuck journey can never hang a batch run
+const int MAX_AUTOPILOT_KEYS = 20000;
+
+bool partyNeedsRest(const Journey& journey) {
+    for (const auto& member : journey.getParty()) {
+        if (member.isAlive && member.health < 40) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+SDL_Keycode chooseAutopilotKey(const Journey& journey) {
+    const Resources& resources = journey.getResources();
+    int foodForWeek = journey.getAliveCount() * journey.getParams().foodPerPersonPerDay * 7;
+
+    switch (journey.getSubState()) {
+        case TravelSubState::Traveling:
+            if (partyNeedsRest(journey) && resources.food >= foodForWeek) {
+                return SDLK_1; // Rest
+            }
+            if (resources.food < foodForWeek && resources.ammunition > 0) {
+                return SDLK_2; // Hunt
+            }
+            if (resources.food < foodForWeek && resources.money >= 20) {
+                return SDLK_3; // Trade for food
+            }
+            return SDLK_SPACE;
+
+        case TravelSubState::Resting:
+            return SDLK_2; // Three days
+
+        case TravelSubState::Hunting:
+            return resources.ammunition > 0 ? SDLK_SPACE : SDLK_ESCAPE;
+
+        case TravelSubState::Trading:
+            if (resources.money >= 20 && resources.food < foodForWeek * 2) {
+                return SDLK_1; // Food
+            }
+            return SDLK_ESCAPE;
+
+        case TravelSubState::River: {
+            int depth = journey.getCurrentLandmark().riverDepth;
+            if (depth <= 3) {
+                return SDLK_1; // Ford
+            }
+            if (resources.money >= 40) {
+                return SDLK_3; // Guide
+            }
+            if (resources.wagonParts > 0) {
+                return SDLK_2; // Caulk
+            }
+            return SDLK_1;
+        }
+
+        case TravelSubState::Setup:
+        case TravelSubState::Location:
+        case TravelSubState::Event:
+        case TravelSubState::GameOver:
+            return SDLK_SPACE;
+    }
+    return SDLK_SPACE;
+}
+
+JourneyOutcome runAutopilotJourney(const std::string& profession, uint64_t seed,
+                                   const SimParams& params,
+                                   std::shared_ptr<const TrailData> trail) {
+    Journey journey(profession, seed, params, std::move(trail));
+    journey.setLogging(false);
+    journey.setupInitialJourney();
+
+    for (int keys = 0; keys < MAX_AUTOPILOT_KEYS && !journey.isGameOver(); ++keys) {
+        journey.applyKey(chooseAutopilotKey(journey));
+    }
+
+    return journey.getOutcome();
+}
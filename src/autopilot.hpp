@@ -0,0 +1,18 @@
+#ifndef AUTOPILOT_HPP
+#define AUTOPILOT_HPP
+
+#include "journey.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Chooses the key a sensible player would press in the journey's current
+// sub-state. Used to play journeys without a window.
+SDL_Keycode chooseAutopilotKey(const Journey& journey);
+
+// Plays a whole journey with the autopilot and returns how it ended
+JourneyOutcome runAutopilotJourney(const std::string& profession, uint64_t seed,
+                                   const SimParams& params,
+                                   std::shared_ptr<const TrailData> trail = nullptr);
+
+#endif // AUTOPILOT_HPP
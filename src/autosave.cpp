@@ -0,0 +1,386 @@
+#include "autosave.hpp"
+#include "journey_session.hpp"
+#include "replay.hpp"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const SNAPSHOT_FILE = "/journey.snap";
+const char* const JOURNAL_FILE = "/journey.wal";
+const char* const SNAPSHOT_MAGIC = "OTSAVE 1";
+
+const size_t QUEUE_CAPACITY = 1024;
+const size_t RECORD_SIZE = 16;
+
+uint32_t recordChecksum(const uint8_t* record) {
+    // FNV-1a over the first 12 bytes
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < RECORD_SIZE - 4; ++i) {
+        hash = (hash ^ record[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void putU32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint32_t getU32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+           static_cast<uint32_t>(in[2]) << 16 | static_cast<uint32_t>(in[3]) << 24;
+}
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Makes a rename in directory durable
+void syncDirectory(const std::string& directory) {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+} // namespace
+
+// AutosaveWriter
+
+AutosaveWriter::AutosaveWriter(const std::string& directory)
+    : m_directory(directory)
+    , m_snapshotPath(directory + SNAPSHOT_FILE)
+    , m_journalPath(directory + JOURNAL_FILE)
+    , m_queue(QUEUE_CAPACITY)
+    , m_generation(std::random_device{}())
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    openJournal();
+    m_thread = std::thread(&AutosaveWriter::run, this);
+}
+
+AutosaveWriter::~AutosaveWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_journalFd >= 0) {
+        ::close(m_journalFd);
+    }
+}
+
+void AutosaveWriter::openJournal() {
+    m_journalFd = ::open(m_journalPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_journalFd < 0) {
+        std::cerr << "Unable to open autosave journal " << m_journalPath << ": "
+                  << std::strerror(errno) << std::endl;
+    }
+}
+
+bool AutosaveWriter::submit(AutosaveEntry&& entry) {
+    {
+        // Under the lock, or the notify can fall between the writer checking
+        // for work and going to sleep
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        // Nothing may be queued behind an entry waiting in the latest slot
+        if (m_hasLatest || !m_queue.tryPush(std::move(entry))) {
+            return false;
+        }
+        m_pending = true;
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+void AutosaveWriter::submitLatest(AutosaveEntry&& entry) {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_latest = std::move(entry);
+        m_hasLatest = true;
+        m_pending = true;
+    }
+    m_wake.notify_one();
+}
+
+void AutosaveWriter::run() {
+    for (;;) {
+        // Read the flags first so entries submitted before a stop are written
+        bool stopping = false;
+        bool hasLatest = false;
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait(lock, [this] { return m_pending || m_stopping; });
+            m_pending = false;
+            stopping = m_stopping;
+            hasLatest = m_hasLatest;
+        }
+
+        AutosaveEntry entry;
+        while (m_queue.tryPop(entry)) {
+            process(entry);
+        }
+
+        // Nothing was queued since it arrived, so it goes last; it may have
+        // been replaced by a newer one meanwhile
+        if (hasLatest) {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                entry = std::move(m_latest);
+                m_hasLatest = false;
+            }
+            process(entry);
+        }
+        flushKeys();
+
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void AutosaveWriter::process(AutosaveEntry& entry) {
+    switch (entry.kind) {
+        case AutosaveEntry::Kind::Key: {
+            if (!m_hasSnapshot) {
+                return; // Nothing to replay it onto
+            }
+            uint8_t record[RECORD_SIZE];
+            putU32(record, m_generation);
+            putU32(record + 4, m_sequence++);
+            putU32(record + 8, static_cast<uint32_t>(entry.key));
+            putU32(record + 12, recordChecksum(record));
+            m_keyBuffer.insert(m_keyBuffer.end(), record, record + RECORD_SIZE);
+            break;
+        }
+        case AutosaveEntry::Kind::Snapshot:
+            // Keys still buffered are already part of the snapshot
+            m_keyBuffer.clear();
+            writeSnapshot(entry);
+            break;
+        case AutosaveEntry::Kind::Discard:
+            m_keyBuffer.clear();
+            discardFiles();
+            break;
+    }
+}
+
+void AutosaveWriter::writeSnapshot(const AutosaveEntry& entry) {
+    m_generation++;
+    m_sequence = 0;
+    m_hasSnapshot = false;
+
+    std::ostringstream content;
+    content << SNAPSHOT_MAGIC << "\n"
+            << "generation " << m_generation << "\n"
+            << *entry.header
+            << "state " << entry.state.size() << "\n"
+            << entry.state;
+    std::string data = content.str();
+
+    std::string temporaryPath = m_snapshotPath + ".tmp";
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Unable to write autosave " << temporaryPath << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+    bool written = writeAll(fd, data.data(), data.size()) && ::fdatasync(fd) == 0;
+    ::close(fd);
+    if (!written || std::rename(temporaryPath.c_str(), m_snapshotPath.c_str()) != 0) {
+        std::cerr << "Unable to write autosave " << m_snapshotPath << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+    syncDirectory(m_directory);
+
+    // The journal now only holds keys the snapshot already includes; if we
+    // crash before this, their old generation keeps them from being replayed
+    if (m_journalFd >= 0 && ::ftruncate(m_journalFd, 0) != 0) {
+        std::cerr << "Unable to truncate autosave journal: " << std::strerror(errno) << std::endl;
+    }
+    m_hasSnapshot = true;
+    m_syncCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AutosaveWriter::discardFiles() {
+    m_hasSnapshot = false;
+    std::remove(m_snapshotPath.c_str());
+    if (m_journalFd >= 0 && ::ftruncate(m_journalFd, 0) != 0) {
+        std::cerr << "Unable to truncate autosave journal: " << std::strerror(errno) << std::endl;
+    }
+    syncDirectory(m_directory);
+}
+
+void AutosaveWriter::flushKeys() {
+    if (m_keyBuffer.empty()) {
+        return;
+    }
+    size_t keys = m_keyBuffer.size() / RECORD_SIZE;
+    if (m_journalFd >= 0) {
+        if (writeAll(m_journalFd, m_keyBuffer.data(), m_keyBuffer.size()) && ::fdatasync(m_journalFd) == 0) {
+            m_syncCount.fetch_add(1, std::memory_order_relaxed);
+            m_keysWritten.fetch_add(keys, std::memory_order_relaxed);
+        } else {
+            std::cerr << "Unable to append to autosave journal: " << std::strerror(errno) << std::endl;
+        }
+    }
+    m_keyBuffer.clear();
+}
+
+// AutosaveJournal
+
+AutosaveJournal::AutosaveJournal(AutosaveWriter& writer, const Journey& journey, size_t rewindBudget,
+                                 int compactEvery)
+    : m_writer(writer)
+    , m_compactEvery(compactEvery)
+{
+    std::ostringstream header;
+    writeReplayHeader(header, journey, rewindBudget);
+    m_header = std::make_shared<const std::string>(header.str());
+    saveSnapshot(journey);
+}
+
+void AutosaveJournal::recordKey(SDL_Keycode key, const Journey& after) {
+    m_keysSinceSnapshot++;
+    if (m_keysSinceSnapshot >= m_compactEvery) {
+        saveSnapshot(after);
+        return;
+    }
+
+    AutosaveEntry entry;
+    entry.kind = AutosaveEntry::Kind::Key;
+    entry.key = key;
+    if (!m_writer.submit(std::move(entry))) {
+        // Dropped; a snapshot of the journey after it covers it
+        saveSnapshot(after);
+    }
+}
+
+void AutosaveJournal::saveSnapshot(const Journey& journey) {
+    AutosaveEntry entry;
+    entry.kind = AutosaveEntry::Kind::Snapshot;
+    entry.header = m_header;
+    entry.state = journey.saveState();
+    submitLatest(std::move(entry));
+    m_keysSinceSnapshot = 0;
+}
+
+void AutosaveJournal::discard() {
+    AutosaveEntry entry;
+    entry.kind = AutosaveEntry::Kind::Discard;
+    submitLatest(std::move(entry));
+}
+
+void AutosaveJournal::submitLatest(AutosaveEntry&& entry) {
+    // Queued like any other entry while there is room
+    AutosaveEntry queued = entry;
+    if (!m_writer.submit(std::move(queued))) {
+        m_writer.submitLatest(std::move(entry));
+    }
+}
+
+// Recovery
+
+std::unique_ptr<JourneySession> recoverAutosave(const std::string& directory,
+                                                std::shared_ptr<const TrailData> trail) {
+    std::string snapshotPath = directory + SNAPSHOT_FILE;
+    std::ifstream snapshotFile(snapshotPath, std::ios::binary);
+    if (!snapshotFile.is_open()) {
+        return nullptr;
+    }
+
+    std::string line;
+    if (!std::getline(snapshotFile, line) || line != SNAPSHOT_MAGIC) {
+        std::cerr << "Ignoring unreadable autosave: " << snapshotPath << std::endl;
+        return nullptr;
+    }
+
+    ReplayHeader header;
+    uint32_t generation = 0;
+    size_t stateSize = 0;
+    bool haveState = false;
+    while (std::getline(snapshotFile, line)) {
+        std::istringstream fields(line);
+        std::string field;
+        fields >> field;
+        if (field == "generation") {
+            fields >> generation;
+        } else if (field == "state") {
+            fields >> stateSize;
+            haveState = true;
+            break;
+        } else {
+            parseReplayHeaderLine(line, header);
+        }
+    }
+    std::string state(stateSize, '\0');
+    if (!haveState || !snapshotFile.read(&state[0], static_cast<std::streamsize>(stateSize))) {
+        std::cerr << "Ignoring truncated autosave: " << snapshotPath << std::endl;
+        return nullptr;
+    }
+
+    if (trail && header.trailHash != trail->hash) {
+        std::cerr << "Ignoring autosave made on a different trail: " << snapshotPath << std::endl;
+        return nullptr;
+    }
+
+    Journey journey(header.profession, header.seed, header.params, trail);
+    if (!journey.loadState(state)) {
+        std::cerr << "Ignoring corrupt autosave: " << snapshotPath << std::endl;
+        return nullptr;
+    }
+    if (journey.isGameOver()) {
+        return nullptr;
+    }
+    int snapshotDay = journey.getDaysElapsed();
+
+    auto session = std::make_unique<JourneySession>(std::move(journey), header.rewindBudget);
+    Journey& recovered = session->getJourney();
+
+    // Re-apply the journaled keys up to the first gap or torn record
+    std::ifstream journalFile(directory + JOURNAL_FILE, std::ios::binary);
+    std::vector<uint8_t> records((std::istreambuf_iterator<char>(journalFile)), std::istreambuf_iterator<char>());
+    int keysReplayed = 0;
+    recovered.setLogging(false);
+    for (size_t offset = 0; offset + RECORD_SIZE <= records.size(); offset += RECORD_SIZE) {
+        const uint8_t* record = records.data() + offset;
+        if (getU32(record + 12) != recordChecksum(record) || getU32(record) != generation ||
+            getU32(record + 4) != static_cast<uint32_t>(keysReplayed)) {
+            break;
+        }
+        session->applyKey(static_cast<SDL_Keycode>(getU32(record + 8)));
+        keysReplayed++;
+    }
+    recovered.setLogging(true);
+
+    std::cout << "Recovered autosaved " << header.profession << " journey: snapshot at day "
+              << snapshotDay << " + " << keysReplayed << " journaled key(s), now day "
+              << recovered.getDaysElapsed() << std::endl;
+    return session;
+}
@@ -0,0 +1,133 @@
+#ifndef AUTOSAVE_HPP
+#define AUTOSAVE_HPP
+
+#include "journey.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class JourneySession;
+
+// Crash-safe autosave of the journey being played, for kiosks that get
+// unplugged mid-journey. The directory holds two files:
+//
+//   journey.snap   text header (generation, setup as in a recording), then
+//                  "state <bytes>" and Journey::saveState() data. Replaced
+//                  atomically (write, fsync, rename).
+//   journey.wal    16-byte records {generation, sequence, key, checksum}
+//                  for keys applied after that snapshot.
+//
+// Recovery loads the snapshot and re-applies the journal records that
+// carry its generation, in sequence, up to the first torn or corrupt one.
+// A journal left over from an older snapshot is ignored by generation.
+
+// One unit of work for the writer thread
+struct AutosaveEntry {
+    enum class Kind { Key, Snapshot, Discard };
+    Kind kind = Kind::Key;
+    SDL_Keycode key = 0;
+    std::shared_ptr<const std::string> header;  // Snapshot: setup lines
+    std::string state;                          // Snapshot: saveState() data
+};
+
+// Owns the autosave files and the background thread that writes them.
+// Keys are batched: everything queued while the last fdatasync ran goes
+// out in one write() and one fdatasync.
+class AutosaveWriter {
+public:
+    explicit AutosaveWriter(const std::string& directory);
+    ~AutosaveWriter();   // Writes whatever is still queued
+
+    AutosaveWriter(const AutosaveWriter&) = delete;
+    AutosaveWriter& operator=(const AutosaveWriter&) = delete;
+
+    // Called from the game thread only. Never waits for the disk; false if
+    // the queue is full and the entry was dropped.
+    bool submit(AutosaveEntry&& entry);
+
+    // A snapshot or discard that cannot be dropped. Either one supersedes
+    // everything before it, so it waits in a slot of its own (replacing
+    // one still waiting there) and is written after what is queued. Until
+    // it is written, submit() refuses new entries.
+    void submitLatest(AutosaveEntry&& entry);
+
+    const std::string& getDirectory() const { return m_directory; }
+    uint64_t getSyncCount() const { return m_syncCount.load(std::memory_order_relaxed); }
+    uint64_t getKeysWritten() const { return m_keysWritten.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void process(AutosaveEntry& entry);
+    void writeSnapshot(const AutosaveEntry& entry);
+    void discardFiles();
+    void flushKeys();
+    void openJournal();
+
+    std::string m_directory;
+    std::string m_snapshotPath;
+    std::string m_journalPath;
+    int m_journalFd = -1;
+
+    SpscQueue<AutosaveEntry> m_queue;
+    std::thread m_thread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+
+    // Guarded by m_wakeMutex
+    bool m_pending = false;
+    bool m_stopping = false;
+    bool m_hasLatest = false;
+    AutosaveEntry m_latest;
+
+    // Writer thread only
+    uint32_t m_generation = 0;
+    uint32_t m_sequence = 0;
+    bool m_hasSnapshot = false;
+    std::vector<uint8_t> m_keyBuffer;
+
+    std::atomic<uint64_t> m_syncCount{0};
+    std::atomic<uint64_t> m_keysWritten{0};
+};
+
+// The game-thread side of one journey's autosave. Decides when to compact
+// the journal into a new snapshot; if the writer falls behind and the
+// queue fills, a key that does not fit is replaced by a snapshot of the
+// journey after it, which cannot be dropped. Nothing on the input path
+// ever waits for the disk.
+class AutosaveJournal {
+public:
+    // Queues an initial snapshot of the journey
+    AutosaveJournal(AutosaveWriter& writer, const Journey& journey, size_t rewindBudget,
+                    int compactEvery = 256);
+
+    // After a key was applied to the journey
+    void recordKey(SDL_Keycode key, const Journey& after);
+
+    // After a change that cannot be replayed as a key (e.g. a rewind)
+    void saveSnapshot(const Journey& journey);
+
+    // The journey is over; remove the autosave
+    void discard();
+
+private:
+    void submitLatest(AutosaveEntry&& entry);
+
+    AutosaveWriter& m_writer;
+    std::shared_ptr<const std::string> m_header;
+    int m_compactEvery;
+    int m_keysSinceSnapshot = 0;
+};
+
+// Loads the autosave in directory, if any, as a session ready to continue.
+// Null if there is no autosave or it does not match the trail.
+std::unique_ptr<JourneySession> recoverAutosave(const std::string& directory,
+                                                std::shared_ptr<const TrailData> trail);
+
+#endif // AUTOSAVE_HPP
@@ -0,0 +1,283 @@
+#include "batch.hpp"
+#include "columnar.hpp"
+#include "autopilot.hpp"
+#include "rng.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Journeys claimed by a worker at a time; large enough to keep the shared
+// counter cold, small enough to balance the tail of the batch
+const int BATCH_CHUNK = 64;
+
+const double REPORT_QUANTILES[] = {0.01, 0.10, 0.25, 0.50, 0.75, 0.90, 0.99};
+
+void printBatchUsage() {
+    std::cout << "Usage: oregon_trail --batch [options]\n"
+              << "  --journeys <n>             Journeys to play (default 100000)\n"
+              << "  --profession <names>       Banker, Carpenter and/or Farmer, comma separated\n"
+              << "  --set name=value           Override a simulation parameter\n"
+              << "  --trail <file>             Trail data file (default: built-in trail)\n"
+              << "  --threads <n>              Worker threads (default: all cores)\n"
+              << "  --seed <n>                 Base random seed\n"
+              << "  --columns <file>           Also write every journey to a columnar file" << std::endl;
+}
+
+template <typename Accumulator>
+void printQuantileRow(std::ostream& out, const char* label, const Accumulator& accumulator) {
+    out << std::left << std::setw(14) << label << std::right;
+    for (double q : REPORT_QUANTILES) {
+        out << std::setw(9) << accumulator.quantile(q);
+    }
+    out << "\n";
+}
+
+} // namespace
+
+void BatchSummary::add(const JourneyOutcome& outcome) {
+    journeys++;
+    survivors.add(outcome.survivors);
+    food.add(outcome.food);
+    money.add(outcome.money);
+    foodTotal += outcome.food;
+    moneyTotal += outcome.money;
+    if (outcome.reachedOregon && outcome.survivors > 0) {
+        survived++;
+        arrivalDays.add(outcome.daysElapsed);
+    }
+    for (int cause = 0; cause < DEATH_CAUSE_COUNT; ++cause) {
+        deaths[cause] += outcome.deaths[cause];
+    }
+}
+
+void BatchSummary::merge(const BatchSummary& other) {
+    journeys += other.journeys;
+    survived += other.survived;
+    arrivalDays.merge(other.arrivalDays);
+    survivors.merge(other.survivors);
+    food.merge(other.food);
+    money.merge(other.money);
+    foodTotal += other.foodTotal;
+    moneyTotal += other.moneyTotal;
+    for (int cause = 0; cause < DEATH_CAUSE_COUNT; ++cause) {
+        deaths[cause] += other.deaths[cause];
+    }
+}
+
+double BatchSummary::getSurvivalRate() const {
+    return journeys > 0 ? static_cast<double>(survived) / journeys : 0.0;
+}
+
+double BatchSummary::getMeanSurvivors() const {
+    return survivors.getMean();
+}
+
+double BatchSummary::getMeanArrivalDay() const {
+    return arrivalDays.getMean();
+}
+
+double BatchSummary::getMeanFood() const {
+    return journeys > 0 ? foodTotal / journeys : 0.0;
+}
+
+double BatchSummary::getMeanMoney() const {
+    return journeys > 0 ? moneyTotal / journeys : 0.0;
+}
+
+unsigned resolveThreadCount(unsigned requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void runBatchRange(const BatchSpec& spec, int first, int last, BatchSummary& summary,
+                   std::vector<JourneyOutcome>* outcomes) {
+    for (int i = first; i < last; ++i) {
+        uint64_t seed = mixSeed(spec.seed, static_cast<uint64_t>(i));
+        JourneyOutcome outcome = runAutopilotJourney(spec.profession, seed, spec.params, spec.trail);
+        summary.add(outcome);
+        if (outcomes) {
+            outcomes->push_back(outcome);
+        }
+    }
+}
+
+BatchSummary runBatch(const BatchSpec& spec) {
+    int chunks = (spec.journeys + BATCH_CHUNK - 1) / BATCH_CHUNK;
+    unsigned threadCount = std::min<unsigned>(resolveThreadCount(spec.threads),
+                                              static_cast<unsigned>(std::max(1, chunks)));
+
+    std::vector<BatchSummary> summaries(threadCount);
+    std::atomic<int> nextChunk(0);
+
+    auto worker = [&](unsigned index) {
+        std::vector<JourneyOutcome> outcomes;
+        for (;;) {
+            int chunk = nextChunk.fetch_add(1);
+            if (chunk >= chunks) {
+                break;
+            }
+            int first = chunk * BATCH_CHUNK;
+            int last = std::min(spec.journeys, first + BATCH_CHUNK);
+            outcomes.clear();
+            runBatchRange(spec, first, last, summaries[index], spec.onChunk ? &outcomes : nullptr);
+            if (spec.onChunk) {
+                spec.onChunk(first, outcomes);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BatchSummary total;
+    for (const auto& summary : summaries) {
+        total.merge(summary);
+    }
+    return total;
+}
+
+void printBatchReport(std::ostream& out, const BatchSummary& summary) {
+    out << "Journeys: " << summary.journeys
+        << ", survived: " << summary.survived
+        << " (" << std::fixed << std::setprecision(1) << summary.getSurvivalRate() * 100.0 << "%)\n";
+    out << std::setprecision(0);
+
+    out << std::left << std::setw(14) << "percentile" << std::right;
+    for (double q : REPORT_QUANTILES) {
+        out << std::setw(8) << static_cast<int>(q * 100.0 + 0.5) << "%";
+    }
+    out << "\n";
+
+    printQuantileRow(out, "arrival day", summary.arrivalDays);
+    printQuantileRow(out, "survivors", summary.survivors);
+    printQuantileRow(out, "food left", summary.food);
+    printQuantileRow(out, "money left", summary.money);
+
+    out << "Deaths by cause:";
+    for (int cause = 1; cause < DEATH_CAUSE_COUNT; ++cause) {
+        out << " " << getDeathCauseName(static_cast<DeathCause>(cause)) << "=" << summary.deaths[cause];
+    }
+    out << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+int runBatchCommand(int argc, char* argv[]) {
+    BatchSpec spec;
+    spec.journeys = 100000;
+    std::vector<std::string> professions;
+    std::string columnsPath;
+
+    try {
+        for (int i = 0; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--journeys" && hasValue) {
+                spec.journeys = std::stoi(argv[++i]);
+            } else if (arg == "--profession" && hasValue) {
+                std::string list = argv[++i];
+                size_t start = 0;
+                for (;;) {
+                    size_t comma = list.find(',', start);
+                    professions.push_back(list.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+                    if (comma == std::string::npos) {
+                        break;
+                    }
+                    start = comma + 1;
+                }
+            } else if (arg == "--columns" && hasValue) {
+                columnsPath = argv[++i];
+            } else if (arg == "--set" && hasValue) {
+                std::string setting = argv[++i];
+                size_t equals = setting.find('=');
+                const SimParamInfo* info = equals == std::string::npos ? nullptr :
+                                           findSimParam(setting.substr(0, equals));
+                if (!info) {
+                    std::cerr << "Invalid --set: " << setting << std::endl;
+                    printBatchUsage();
+                    return 1;
+                }
+                info->set(spec.params, std::stod(setting.substr(equals + 1)));
+            } else if (arg == "--trail" && hasValue) {
+                spec.trail = loadTrailData(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                spec.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--seed" && hasValue) {
+                spec.seed = std::stoull(argv[++i]);
+            } else {
+                std::cerr << "Unknown batch option: " << arg << std::endl;
+                printBatchUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid batch option value: " << e.what() << std::endl;
+        printBatchUsage();
+        return 1;
+    }
+
+    if (spec.journeys < 1) {
+        std::cerr << "Batch needs at least 1 journey" << std::endl;
+        printBatchUsage();
+        return 1;
+    }
+    if (professions.empty()) {
+        professions.push_back(spec.profession);
+    }
+
+    // Per-journey rows go to a columnar file, one block at a time
+    std::unique_ptr<ColumnarWriter> columns;
+    std::mutex columnsMutex;
+    if (!columnsPath.empty()) {
+        columns.reset(new ColumnarWriter(columnsPath, outcomeColumnNames()));
+        if (!columns->isOpen()) {
+            return 1;
+        }
+    }
+
+    for (const auto& profession : professions) {
+        spec.profession = profession;
+        if (columns) {
+            int professionCode = getProfessionCode(profession);
+            std::vector<int64_t> row(outcomeColumnNames().size());
+            spec.onChunk = [&, professionCode, row](int first, const std::vector<JourneyOutcome>& outcomes) mutable {
+                std::lock_guard<std::mutex> lock(columnsMutex);
+                for (size_t i = 0; i < outcomes.size(); ++i) {
+                    uint64_t seed = mixSeed(spec.seed, static_cast<uint64_t>(first + i));
+                    fillOutcomeRow(professionCode, seed, outcomes[i], row.data());
+                    columns->appendRow(row.data());
+                }
+            };
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        BatchSummary summary = runBatch(spec);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        std::cout << profession << " batch finished in " << seconds << "s" << std::endl;
+        printBatchReport(std::cout, summary);
+    }
+
+    if (columns) {
+        if (!columns->finish()) {
+            std::cerr << "Failed writing columnar output: " << columnsPath << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << columns->getRowCount() << " journeys to " << columnsPath << std::endl;
+    }
+    return 0;
+}
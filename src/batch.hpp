@@ -0,0 +1,67 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "journey.hpp"
+#include "stats.hpp"
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Fixed-size distribution of many journey outcomes. Each worker thread
+// keeps its own summary and the summaries are merged when the batch
+// finishes, so memory does not depend on the number of journeys.
+struct BatchSummary {
+    int64_t journeys = 0;
+    int64_t survived = 0;                   // Reached Oregon with someone alive
+    HdrHistogram arrivalDays{7, 100000};    // Over journeys that survived
+    HdrHistogram survivors{7, 64};
+    TDigest food;
+    TDigest money;
+    double foodTotal = 0.0;
+    double moneyTotal = 0.0;
+    uint64_t deaths[DEATH_CAUSE_COUNT] = {}; // Party members, by cause
+
+    void add(const JourneyOutcome& outcome);
+    void merge(const BatchSummary& other);
+
+    double getSurvivalRate() const;
+    double getMeanSurvivors() const;
+    double getMeanArrivalDay() const;
+    double getMeanFood() const;
+    double getMeanMoney() const;
+};
+
+// A batch of autopilot journeys sharing one parameter set
+struct BatchSpec {
+    std::string profession = "Banker";
+    SimParams params;
+    std::shared_ptr<const TrailData> trail;
+    int journeys = 1000;
+    uint64_t seed = 1848;           // Journey i uses mixSeed(seed, i)
+    unsigned threads = 0;           // 0 = one per hardware thread
+    // Optional; called from worker threads with the outcomes of each finished
+    // chunk of journeys, starting at journey index first
+    std::function<void(int first, const std::vector<JourneyOutcome>& outcomes)> onChunk;
+};
+
+// Play every journey in the batch, spread over worker threads
+BatchSummary runBatch(const BatchSpec& spec);
+
+// Play journeys [first, last) of the batch on the calling thread, optionally
+// keeping each outcome as well
+void runBatchRange(const BatchSpec& spec, int first, int last, BatchSummary& summary,
+                   std::vector<JourneyOutcome>* outcomes = nullptr);
+
+// Number of worker threads to use for a requested count (0 = all cores)
+unsigned resolveThreadCount(unsigned requested);
+
+// Human-readable percentile report
+void printBatchReport(std::ostream& out, const BatchSummary& summary);
+
+// Entry point for "oregon_trail --batch ..."; returns the process exit code
+int runBatchCommand(int argc, char* argv[]);
+
+#endif // BATCH_HPP
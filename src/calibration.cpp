@@ -0,0 +1,219 @@
+#include "calibration.hpp"
+#include "batch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+SimParams scaledParams(const SimParams& base, double hazardScale) {
+    SimParams params = base;
+    params.randomEventChance = std::min(1.0, base.randomEventChance * hazardScale);
+    params.illnessChance = std::min(1.0, base.illnessChance * hazardScale);
+    return params;
+}
+
+double survivalRateAt(const std::shared_ptr<const TrailData>& trail, const CalibrationConfig& config,
+                      const std::string& profession, double hazardScale) {
+    BatchSpec spec;
+    spec.profession = profession;
+    spec.params = scaledParams(config.baseParams, hazardScale);
+    spec.trail = trail;
+    spec.journeys = config.journeysPerEvaluation;
+    spec.seed = config.seed;
+    spec.threads = config.threads;
+    return runBatch(spec).getSurvivalRate();
+}
+
+// Everything besides the trail that changes the answer; stored in the cache
+// file so stale entries are recomputed
+uint64_t settingsHash(const CalibrationConfig& config) {
+    std::ostringstream settings;
+    settings << std::setprecision(17)
+             << config.journeysPerEvaluation << " " << config.iterations << " "
+             << config.maxHazardScale << " " << config.seed;
+    for (const auto& info : simParamTable()) {
+        settings << " " << info.get(config.baseParams);
+    }
+    for (const auto& target : config.targets) {
+        settings << " " << target.profession << "=" << target.survivalRate;
+    }
+    std::string text = settings.str();
+    return hashBytes(text.data(), text.size());
+}
+
+std::string hexString(uint64_t value) {
+    std::ostringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << value;
+    return stream.str();
+}
+
+std::string cachePath(const CalibrationConfig& config, const TrailData& trail) {
+    return config.cacheDirectory + "/calibration-" + hexString(trail.hash) + ".txt";
+}
+
+bool loadCache(const std::string& path, const CalibrationConfig& config,
+               std::vector<CalibratedProfession>& results) {
+    std::ifstream cacheFile(path);
+    if (!cacheFile.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    std::string expectedSettings = "settings " + hexString(settingsHash(config));
+    bool settingsMatch = false;
+    results.clear();
+
+    while (std::getline(cacheFile, line)) {
+        if (line.empty() || line[0] == '#' || line.compare(0, 6, "trail ") == 0) {
+            continue;
+        }
+        if (line.compare(0, 9, "settings ") == 0) {
+            settingsMatch = (line == expectedSettings);
+            continue;
+        }
+
+        std::istringstream fields(line);
+        CalibratedProfession result;
+        if (fields >> result.profession >> result.targetRate >> result.hazardScale >> result.achievedRate) {
+            result.params = scaledParams(config.baseParams, result.hazardScale);
+            results.push_back(result);
+        }
+    }
+
+    return settingsMatch && results.size() == config.targets.size();
+}
+
+void saveCache(const std::string& path, const CalibrationConfig& config, const TrailData& trail,
+               const std::vector<CalibratedProfession>& results) {
+    std::error_code error;
+    std::filesystem::create_directories(config.cacheDirectory, error);
+
+    // Write to a temporary file first so a crash never leaves a torn cache
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream cacheFile(tempPath);
+        if (!cacheFile.is_open()) {
+            std::cerr << "Unable to write calibration cache " << path << std::endl;
+            return;
+        }
+        cacheFile << "# Difficulty calibration for " << trail.source << "\n"
+                  << "trail " << hexString(trail.hash) << "\n"
+                  << "settings " << hexString(settingsHash(config)) << "\n"
+                  << std::setprecision(17);
+        for (const auto& result : results) {
+            cacheFile << result.profession << " " << result.targetRate << " "
+                      << result.hazardScale << " " << result.achievedRate << "\n";
+        }
+    }
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "Unable to write calibration cache " << path << ": " << error.message() << std::endl;
+    }
+}
+
+} // namespace
+
+std::vector<CalibratedProfession> calibrateDifficulty(const std::shared_ptr<const TrailData>& trail,
+                                                      const CalibrationConfig& config) {
+    std::shared_ptr<const TrailData> trailData = trail ? trail : defaultTrailData();
+    std::string path = cachePath(config, *trailData);
+
+    std::vector<CalibratedProfession> results;
+    if (loadCache(path, config, results)) {
+        std::cout << "Using cached difficulty calibration from " << path << std::endl;
+        return results;
+    }
+
+    std::cout << "Calibrating difficulty for " << trailData->source << "..." << std::endl;
+    auto startTime = std::chrono::steady_clock::now();
+    results.clear();
+
+    for (const auto& target : config.targets) {
+        CalibratedProfession result;
+        result.profession = target.profession;
+        result.targetRate = target.survivalRate;
+
+        // Survival falls as hazards rise, so bisect on the scale. Every
+        // evaluation reuses the same seeds, which keeps the estimated curve
+        // monotone enough for bisection to converge.
+        double low = 0.0;
+        double high = config.maxHazardScale;
+        double lowRate = survivalRateAt(trailData, config, target.profession, low);
+        double highRate = survivalRateAt(trailData, config, target.profession, high);
+
+        if (lowRate <= target.survivalRate) {
+            // Even a hazard-free trail is too hard
+            result.hazardScale = low;
+            result.achievedRate = lowRate;
+        } else if (highRate >= target.survivalRate) {
+            // Even the harshest setting is too easy
+            result.hazardScale = high;
+            result.achievedRate = highRate;
+        } else {
+            for (int i = 0; i < config.iterations; ++i) {
+                double middle = 0.5 * (low + high);
+                double middleRate = survivalRateAt(trailData, config, target.profession, middle);
+                if (middleRate > target.survivalRate) {
+                    low = middle;
+                    lowRate = middleRate;
+                } else {
+                    high = middle;
+                    highRate = middleRate;
+                }
+            }
+            // Pick whichever end of the final bracket is closer to the target
+            if (lowRate - target.survivalRate < target.survivalRate - highRate) {
+                result.hazardScale = low;
+                result.achievedRate = lowRate;
+            } else {
+                result.hazardScale = high;
+                result.achievedRate = highRate;
+            }
+        }
+
+        result.params = scaledParams(config.baseParams, result.hazardScale);
+        std::cout << "  " << result.profession << ": target " << result.targetRate
+                  << ", achieved " << result.achievedRate
+                  << " (hazard scale " << result.hazardScale << ")" << std::endl;
+        results.push_back(result);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Calibration finished in " << seconds << "s" << std::endl;
+
+    saveCache(path, config, *trailData, results);
+    return results;
+}
+
+bool parseDifficultyTargets(const std::string& text, std::vector<DifficultyTarget>& targets) {
+    std::vector<DifficultyTarget> parsed;
+    std::istringstream stream(text);
+    std::string entry;
+
+    while (std::getline(stream, entry, ',')) {
+        size_t equals = entry.find('=');
+        if (equals == std::string::npos) {
+            return false;
+        }
+        try {
+            double rate = std::stod(entry.substr(equals + 1));
+            if (rate < 0.0 || rate > 1.0) {
+                return false;
+            }
+            parsed.push_back({entry.substr(0, equals), rate});
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    if (parsed.empty()) {
+        return false;
+    }
+    targets = parsed;
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef CALIBRATION_HPP
+#define CALIBRATION_HPP
+
+#include "sim_params.hpp"
+#include "trail_data.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Survival rate a profession should reach with the autopilot
+struct DifficultyTarget {
+    std::string profession;
+    double survivalRate;
+};
+
+struct CalibrationConfig {
+    std::vector<DifficultyTarget> targets = {
+        {"Banker", 0.80},
+        {"Carpenter", 0.60},
+        {"Farmer", 0.40}
+    };
+    SimParams baseParams;
+    int journeysPerEvaluation = 2000;
+    int iterations = 14;            // Bisection steps per profession
+    double maxHazardScale = 8.0;    // Upper end of the search bracket
+    unsigned threads = 0;           // 0 = one per hardware thread
+    uint64_t seed = 1848;
+    std::string cacheDirectory = "cache";
+};
+
+// Result for one profession. The event and illness chances of the base
+// parameters are both multiplied by hazardScale.
+struct CalibratedProfession {
+    std::string profession;
+    double targetRate = 0.0;
+    double achievedRate = 0.0;
+    double hazardScale = 1.0;
+    SimParams params;
+};
+
+// Find event and illness rates that give each target survival rate on this
+// trail. Results are cached on disk keyed by the trail data hash, so later
+// launches with the same trail and settings skip the simulation entirely.
+std::vector<CalibratedProfession> calibrateDifficulty(const std::shared_ptr<const TrailData>& trail,
+                                                      const CalibrationConfig& config);
+
+// Parse "Banker=0.8,Farmer=0.4" into targets; returns false on bad input
+bool parseDifficultyTargets(const std::string& text, std::vector<DifficultyTarget>& targets);
+
+#endif // CALIBRATION_HPP
@@ -0,0 +1,130 @@
+#ifndef COLUMNAR_HPP
+#define COLUMNAR_HPP
+
+#include "journey.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Columnar results file for very large journey datasets.
+//
+// Rows are grouped into blocks; inside a block every column is stored on
+// its own as zigzag-delta varints compressed with compressBlock(). The
+// footer records each column chunk's location and min/max, so a reader can
+// skip whole blocks a filter cannot match and decode only the columns it
+// needs.
+//
+// Layout (little-endian):
+//   "OTCOLS01" u32 columnCount { u16 nameLength, name }*
+//   column chunks...
+//   footer: u32 blockCount { u32 rows { u64 offset, u32 size, u32 rawSize,
+//           i64 min, i64 max }* per column }*
+//   u64 footerOffset "OTCOLS01"
+
+// One column chunk within a block
+struct ColumnChunkInfo {
+    uint64_t offset = 0;
+    uint32_t size = 0;      // Compressed bytes
+    uint32_t rawSize = 0;   // Varint bytes before compression
+    int64_t minValue = 0;
+    int64_t maxValue = 0;
+};
+
+struct ColumnBlockInfo {
+    uint32_t rows = 0;
+    std::vector<ColumnChunkInfo> columns;
+};
+
+// Streams rows to disk a block at a time; memory use is one block.
+// Not thread-safe; callers serialize appendRow().
+class ColumnarWriter {
+public:
+    ColumnarWriter(const std::string& path, const std::vector<std::string>& columns,
+                   size_t rowsPerBlock = 65536);
+    ~ColumnarWriter();
+
+    bool isOpen() const { return m_out.is_open(); }
+    void appendRow(const int64_t* values);
+    bool finish();
+    uint64_t getRowCount() const { return m_rowCount; }
+
+private:
+    void flushBlock();
+    void writeBytes(const void* data, size_t size);
+
+    std::ofstream m_out;
+    std::vector<std::string> m_columns;
+    size_t m_rowsPerBlock;
+    std::vector<std::vector<int64_t>> m_pending;   // [column][row]
+    std::vector<ColumnBlockInfo> m_blocks;
+    std::vector<uint8_t> m_encoded;
+    std::vector<uint8_t> m_compressed;
+    uint64_t m_offset = 0;
+    uint64_t m_rowCount = 0;
+    bool m_finished = false;
+};
+
+// Inclusive value range a column must fall in for a row to match
+struct ColumnPredicate {
+    int column = 0;
+    int64_t minValue = INT64_MIN;
+    int64_t maxValue = INT64_MAX;
+};
+
+struct ColumnScanStats {
+    size_t blocksTotal = 0;
+    size_t blocksSkipped = 0;       // Ruled out by block min/max alone
+    uint64_t rowsScanned = 0;       // Rows in blocks that were decoded
+    uint64_t rowsMatched = 0;
+    uint64_t bytesDecoded = 0;      // Compressed bytes actually decoded
+};
+
+// Memory-maps a columnar file and scans it with predicate pushdown
+class ColumnarReader {
+public:
+    ColumnarReader() = default;
+    ~ColumnarReader();
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const std::vector<std::string>& getColumns() const { return m_columns; }
+    int findColumn(const std::string& name) const;  // -1 if absent
+    const std::vector<ColumnBlockInfo>& getBlocks() const { return m_blocks; }
+    uint64_t getRowCount() const;
+
+    // Calls visit with the outputColumns' values (in that order) for every
+    // row matching all predicates. Blocks whose min/max exclude a predicate
+    // are never decoded, and output columns are decoded only for blocks with
+    // at least one matching row.
+    ColumnScanStats scan(const std::vector<ColumnPredicate>& predicates,
+                         const std::vector<int>& outputColumns,
+                         const std::function<void(const int64_t* values)>& visit) const;
+
+private:
+    bool decodeChunk(const ColumnChunkInfo& chunk, uint32_t rows, std::vector<int64_t>& values,
+                     std::vector<uint8_t>& scratch) const;
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    std::vector<std::string> m_columns;
+    std::vector<ColumnBlockInfo> m_blocks;
+};
+
+// Column layout for journey outcomes written by "--batch --columns"
+const std::vector<std::string>& outcomeColumnNames();
+void fillOutcomeRow(int professionCode, uint64_t seed, const JourneyOutcome& outcome, int64_t* row);
+
+// Professions are stored as small integer codes; -1 if unknown
+int getProfessionCode(const std::string& profession);
+const char* getProfessionName(int code);
+
+// Entry point for "oregon_trail --query ..."; returns the process exit code
+int runQueryCommand(int argc, char* argv[]);
+
+#endif // COLUMNAR_HPP
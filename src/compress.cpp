@@ -0,0 +1,142 @@
+#include "compress.hpp"
+#include <cstring>
+
+namespace {
+
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 65535;
+const int HASH_BITS = 12;
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Lengths that overflow the 4-bit token field continue in 255-valued bytes
+void writeLength(size_t length, std::vector<uint8_t>& out) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+bool readLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (in >= end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+void writeSequence(const uint8_t* literals, size_t literalCount,
+                   size_t offset, size_t matchLength, std::vector<uint8_t>& out) {
+    size_t matchCode = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+    uint8_t token = static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4);
+    if (offset > 0) {
+        token |= static_cast<uint8_t>(matchCode < 15 ? matchCode : 15);
+    }
+    out.push_back(token);
+    if (literalCount >= 15) {
+        writeLength(literalCount - 15, out);
+    }
+    out.insert(out.end(), literals, literals + literalCount);
+
+    // The final sequence carries literals only
+    if (offset == 0) {
+        return;
+    }
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15) {
+        writeLength(matchCode - 15, out);
+    }
+}
+
+} // namespace
+
+void compressBlock(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+    uint32_t table[1 << HASH_BITS];
+    std::memset(table, 0, sizeof(table));
+
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (size >= MIN_MATCH && pos + MIN_MATCH <= size) {
+        uint32_t sequence = read32(src + pos);
+        uint32_t hash = hashSequence(sequence);
+        size_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(pos);
+
+        if (candidate < pos && pos - candidate <= MAX_OFFSET && read32(src + candidate) == sequence) {
+            size_t length = MIN_MATCH;
+            while (pos + length < size && src[candidate + length] == src[pos + length]) {
+                length++;
+            }
+            writeSequence(src + anchor, pos - anchor, pos - candidate, length, out);
+            pos += length;
+            anchor = pos;
+        } else {
+            pos++;
+        }
+    }
+
+    writeSequence(src + anchor, size - anchor, 0, 0, out);
+}
+
+bool decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize) {
+    const uint8_t* in = src;
+    const uint8_t* end = src + size;
+    size_t written = 0;
+
+    while (in < end) {
+        uint8_t token = *in++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(in, end, literalCount)) {
+            return false;
+        }
+        if (literalCount > static_cast<size_t>(end - in) || literalCount > dstSize - written) {
+            return false;
+        }
+        std::memcpy(dst + written, in, literalCount);
+        in += literalCount;
+        written += literalCount;
+
+        if (in == end) {
+            break;
+        }
+
+        if (end - in < 2) {
+            return false;
+        }
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(in, end, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+
+        if (offset == 0 || offset > written || matchLength > dstSize - written) {
+            return false;
+        }
+        // Byte-by-byte so overlapping matches repeat runs correctly
+        const uint8_t* from = dst + written - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            dst[written + i] = from[i];
+        }
+        written += matchLength;
+    }
+
+    return written == dstSize;
+}
@@ -0,0 +1,18 @@
+#ifndef COMPRESS_HPP
+#define COMPRESS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Small LZ77 block codec (LZ4-style sequences of literals + back-references).
+// Favors decode speed over ratio; blocks are independent so any one can be
+// decoded without touching the rest of a file.
+
+// Appends the compressed form of [src, src + size) to out
+void compressBlock(const uint8_t* src, size_t size, std::vector<uint8_t>& out);
+
+// Decodes exactly dstSize bytes into dst. Returns false on corrupt input.
+bool decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize);
+
+#endif // COMPRESS_HPP
@@ -0,0 +1,109 @@
+#include "file_watcher.hpp"
+#include <iostream>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+
+// How long the thread waits for events before checking whether it should
+// stop
+const int WATCH_POLL_INTERVAL_MS = 100;
+
+// Written in place (IN_CLOSE_WRITE), or saved elsewhere and renamed over
+// the original (IN_MOVED_TO)
+const uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+} // namespace
+
+FileWatcher::FileWatcher(std::function<void()> onChange)
+    : m_onChange(std::move(onChange))
+{
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        std::cerr << "File watching unavailable; edited files need a restart" << std::endl;
+        return;
+    }
+    m_thread = std::thread(&FileWatcher::run, this);
+}
+
+FileWatcher::~FileWatcher() {
+    m_stopping.store(true);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool FileWatcher::watch(const std::string& path) {
+    if (m_fd < 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_watched.count(path)) {
+        return true;
+    }
+    std::string directory = directoryOf(path);
+    // Watching a directory twice returns the same descriptor
+    int wd = inotify_add_watch(m_fd, directory.empty() ? "." : directory.c_str(), WATCH_EVENTS);
+    if (wd < 0) {
+        return false;
+    }
+    m_directories[wd] = directory;
+    m_watched.insert(path);
+    std::cout << "Watching " << path << " for changes" << std::endl;
+    return true;
+}
+
+std::vector<std::string> FileWatcher::takeChanged() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> changed(m_changed.begin(), m_changed.end());
+    m_changed.clear();
+    return changed;
+}
+
+void FileWatcher::run() {
+    alignas(struct inotify_event) char buffer[4096];
+    pollfd descriptor = {m_fd, POLLIN, 0};
+
+    while (!m_stopping.load()) {
+        if (poll(&descriptor, 1, WATCH_POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+
+        bool changed = false;
+        ssize_t length;
+        while ((length = ::read(m_fd, buffer, sizeof(buffer))) > 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (char* p = buffer; p < buffer + length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                p += sizeof(inotify_event) + event->len;
+                if (event->len == 0) {
+                    continue;
+                }
+                auto directory = m_directories.find(event->wd);
+                if (directory == m_directories.end()) {
+                    continue;
+                }
+                std::string path = directory->second.empty() ? std::string(event->name)
+                                                             : directory->second + "/" + event->name;
+                if (m_watched.count(path)) {
+                    m_changed.insert(path);
+                    changed = true;
+                }
+            }
+        }
+
+        if (changed && m_onChange) {
+            m_onChange();
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef FILE_WATCHER_HPP
+#define FILE_WATCHER_HPP
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Notices edits to content files while the game runs, so authors see them
+// without a restart. A background thread waits on inotify; the files that
+// changed are collected until the main thread takes them between frames.
+//
+// Directories are watched rather than files, so a file replaced by an
+// editor that saves to a temporary and renames it over the original is
+// still noticed.
+class FileWatcher {
+public:
+    // onChange is called from the watcher thread after a watched file has
+    // changed (to wake a main loop sleeping on events)
+    explicit FileWatcher(std::function<void()> onChange = nullptr);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // False if inotify is unavailable; watch() then does nothing
+    bool isActive() const { return m_fd >= 0; }
+
+    // Start watching a file, by the path it is loaded by. Returns false if
+    // its directory cannot be watched (it does not exist on disk).
+    bool watch(const std::string& path);
+
+    // Paths changed since the last call, each once however often it was
+    // written. Main thread.
+    std::vector<std::string> takeChanged();
+
+private:
+    void run();
+
+    int m_fd = -1;
+    std::function<void()> m_onChange;
+    std::thread m_thread;
+    std::atomic<bool> m_stopping{false};
+
+    std::mutex m_mutex;                         // Guards everything below
+    std::map<int, std::string> m_directories;   // By watch descriptor
+    std::set<std::string> m_watched;
+    std::set<std::string> m_changed;
+};
+
+#endif // FILE_WATCHER_HPP
@@ -0,0 +1,76 @@
+#include "frame_arena.hpp"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+size_t alignUp(size_t offset, size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+FrameArena::FrameArena(size_t capacity)
+    : m_buffer(new char[capacity])
+    , m_capacity(capacity)
+{
+}
+
+void FrameArena::reset() {
+    if (m_wanted > m_capacity) {
+        size_t capacity = m_capacity;
+        while (capacity < m_wanted) {
+            capacity *= 2;
+        }
+        std::cerr << "Frame arena of " << m_capacity << " bytes was short by " << m_wanted - m_capacity
+                  << "; growing it to " << capacity << std::endl;
+        m_buffer.reset(new char[capacity]);
+        m_capacity = capacity;
+    }
+    m_used = 0;
+    m_wanted = 0;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    size_t start = alignUp(m_used, alignment);
+    m_wanted = alignUp(m_wanted, alignment) + bytes;
+    if (start + bytes > m_capacity) {
+        return nullptr;
+    }
+    m_used = start + bytes;
+    return m_buffer.get() + start;
+}
+
+const char* FrameArena::format(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    const char* text = formatV(fmt, args);
+    va_end(args);
+    return text;
+}
+
+const char* FrameArena::formatV(const char* fmt, va_list args) {
+    char* out = m_buffer.get() + m_used;
+    size_t room = m_capacity - m_used;
+    int length = std::vsnprintf(out, room, fmt, args);
+    if (length < 0) {
+        return "";
+    }
+    m_wanted += static_cast<size_t>(length) + 1;
+    if (static_cast<size_t>(length) >= room) {
+        return "";
+    }
+    m_used += static_cast<size_t>(length) + 1;
+    return out;
+}
+
+const char* FrameArena::copy(const char* text, size_t length) {
+    char* out = static_cast<char*>(allocate(length + 1, 1));
+    if (!out) {
+        return "";
+    }
+    std::memcpy(out, text, length);
+    out[length] = '\0';
+    return out;
+}
@@ -0,0 +1,45 @@
+#ifndef FRAME_ARENA_HPP
+#define FRAME_ARENA_HPP
+
+#include <cstdarg>
+#include <cstddef>
+#include <memory>
+
+// Scratch memory for one frame. Render code formats the text it draws here
+// instead of building std::strings, so drawing a screen makes no heap
+// allocations. Memory is handed out by bumping an offset, and all of it is
+// released together when the next frame begins. Main thread only.
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Start of a frame: everything handed out before is released. If the
+    // last frame ran out of room the arena grows here, the only time it
+    // allocates.
+    void reset();
+
+    // Null if the arena is full
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // printf-style formatting into the arena. Never null: text that does
+    // not fit comes back empty (and the arena is bigger next frame).
+    const char* format(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    const char* formatV(const char* fmt, va_list args);
+
+    // Terminated copy of length bytes of text
+    const char* copy(const char* text, size_t length);
+
+    size_t getUsed() const { return m_used; }
+    size_t getCapacity() const { return m_capacity; }
+
+private:
+    std::unique_ptr<char[]> m_buffer;
+    size_t m_capacity;
+    size_t m_used = 0;
+    size_t m_wanted = 0;    // Bytes the current frame asked for, fitting or not
+};
+
+#endif // FRAME_ARENA_HPP
@@ -0,0 +1,328 @@
+#include "frame_check.hpp"
+#include "asset_cache.hpp"
+#include "autopilot.hpp"
+#include "frame_arena.hpp"
+#include "heap_tracker.hpp"
+#include "info_state.hpp"
+#include "journey.hpp"
+#include "journey_session.hpp"
+#include "loading_state.hpp"
+#include "menu_state.hpp"
+#include "save_slots.hpp"
+#include "sdl_subsystems.hpp"
+#include "slot_state.hpp"
+#include "text_cache.hpp"
+#include "travel_state.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const int DEFAULT_FRAMES = 2000;
+
+// Small, so the first frames also go through the arena growing
+const size_t START_CAPACITY = 64;
+
+// Frames drawn between changes to a screen, as when the wagon travels on
+// its own or a key is held down
+const int FRAMES_PER_STEP = 4;
+
+// The game's window
+const int WINDOW_WIDTH = 800;
+const int WINDOW_HEIGHT = 600;
+
+// Frames with problems reported one by one; the rest are only counted
+const int MAX_REPORTED_FRAMES = 20;
+
+const SDL_Color TEXT_COLOR = {144, 238, 144, 255};
+
+// Journeys take turns among these, the poorer ones being likelier to end
+// short of Oregon
+const char* const PROFESSIONS[] = {"Banker", "Carpenter", "Farmer"};
+
+// Journeys are played until every travel screen has been shown, but no
+// more than this many
+const uint64_t MAX_JOURNEYS = 100;
+
+// One per sub-state, in order, then the end of a journey that reached Oregon
+const char* const TRAVEL_SCREEN_NAMES[] = {"setup", "traveling", "landmark", "river", "hunting",
+                                           "trading", "event", "resting", "game over", "arrival"};
+const int TRAVEL_SCREEN_COUNT = sizeof(TRAVEL_SCREEN_NAMES) / sizeof(TRAVEL_SCREEN_NAMES[0]);
+static_assert(TRAVEL_SCREEN_COUNT == static_cast<int>(TravelSubState::GameOver) + 2,
+              "Every travel sub-state has a name");
+
+int getTravelScreen(const Journey& journey) {
+    if (journey.getSubState() == TravelSubState::GameOver && journey.hasReachedOregon()) {
+        return TRAVEL_SCREEN_COUNT - 1;
+    }
+    return static_cast<int>(journey.getSubState());
+}
+
+// Builds and draws frames of the screens, the way their render() does,
+// and counts what each frame allocated and rendered
+class FrameChecker {
+public:
+    FrameChecker(TextCache& cache, std::shared_ptr<TTF_Font> font)
+        : m_frame(START_CAPACITY)
+        , m_cache(cache)
+        , m_font(std::move(font))
+    {
+    }
+
+    // One frame. changed says whether what the screen shows differs from
+    // the frame before; only then may drawing it render text (which
+    // allocates). Building the text must never allocate.
+    template <typename Build>
+    void run(const char* screen, bool changed, Build build) {
+        size_t capacity = m_frame.getCapacity();
+        uint64_t before = threadHeapAllocations();
+        m_frame.reset();
+        m_cache.beginFrame();
+        ScreenText text;
+        build(m_frame, text);
+        uint64_t built = threadHeapAllocations() - before;
+        uint64_t rendersBefore = m_cache.getRenderCount();
+        m_cache.draw(m_font, TEXT_COLOR, text, WINDOW_WIDTH);
+        uint64_t drawn = threadHeapAllocations() - before - built;
+        uint64_t renders = m_cache.getRenderCount() - rendersBefore;
+
+        // Growing is the one time the arena allocates, and the first time
+        // all of the text fits
+        ++m_frames;
+        if (m_frame.getCapacity() != capacity) {
+            ++m_growingFrames;
+            return;
+        }
+
+        bool dropped = text.getDropped() > 0;
+        bool redrawn = !changed && (drawn > 0 || renders > 0);
+        if (!dropped && built == 0 && !redrawn) {
+            return;
+        }
+        if (++m_badFrames > MAX_REPORTED_FRAMES) {
+            return;
+        }
+        if (dropped) {
+            report(screen) << "dropped " << text.getDropped() << " lines past " << ScreenText::MAX_LINES
+                           << std::endl;
+        }
+        if (built > 0) {
+            report(screen) << "made " << built << " heap allocations building its text" << std::endl;
+        }
+        if (redrawn) {
+            report(screen) << "rendered " << renders << " unchanged lines and made " << drawn
+                           << " heap allocations drawing them" << std::endl;
+        }
+    }
+
+    int getFrames() const { return m_frames; }
+    int getGrowingFrames() const { return m_growingFrames; }
+    int getBadFrames() const { return m_badFrames; }
+
+private:
+    std::ostream& report(const char* screen) const {
+        return std::cerr << "Frame " << m_frames << " (" << screen << ") ";
+    }
+
+    FrameArena m_frame;
+    TextCache& m_cache;
+    std::shared_ptr<TTF_Font> m_font;
+    int m_frames = 0;
+    int m_growingFrames = 0;
+    int m_badFrames = 0;
+};
+
+void checkLoadingScreen(FrameChecker& checker) {
+    PreloadProgress progress;
+    progress.requiredTotal = 12;
+    for (; progress.requiredFinished <= progress.requiredTotal; ++progress.requiredFinished) {
+        for (int i = 0; i < FRAMES_PER_STEP; ++i) {
+            checker.run("loading", i == 0, [&](FrameArena& frame, ScreenText& text) {
+                buildLoadingText(progress, WINDOW_HEIGHT, frame, text);
+            });
+        }
+    }
+}
+
+void checkMenu(FrameChecker& checker) {
+    std::vector<std::string> intro = {"Welcome to the Oregon Trail!", "",
+                                      "You are about to begin a great adventure, traveling the Oregon Trail",
+                                      "from Independence, Missouri to the Willamette Valley in Oregon."};
+    std::vector<std::string> options = {"Travel the trail", "Continue a saved journey", "Learn about the trail",
+                                        "See the high scores", "Choose your profession", "Exit"};
+    for (int selected = 0; selected < static_cast<int>(options.size()); ++selected) {
+        for (int i = 0; i < FRAMES_PER_STEP; ++i) {
+            checker.run("menu", i == 0, [&](FrameArena& frame, ScreenText& text) {
+                buildMenuText(intro, options, selected, frame, text);
+            });
+        }
+    }
+}
+
+void checkInfoScreen(FrameChecker& checker) {
+    std::vector<std::string> lines;
+    for (int i = 0; i < 60; ++i) {
+        lines.push_back("Line " + std::to_string(i + 1) + " of a long page about the trail");
+    }
+
+    // As far as InfoState lets the player scroll
+    for (int offset = 0; offset <= static_cast<int>(lines.size()) - 10; ++offset) {
+        for (int i = 0; i < FRAMES_PER_STEP; ++i) {
+            checker.run("info", i == 0, [&](FrameArena&, ScreenText& text) {
+                buildInfoText("About the Trail", lines, offset, WINDOW_HEIGHT, text);
+            });
+        }
+    }
+}
+
+void checkSlotList(FrameChecker& checker, const SaveSlots* slots) {
+    // Down the list a slot at a time, keeping the selection on screen
+    int visibleRows = visibleSlotRows(WINDOW_HEIGHT);
+    std::string status;
+    for (int selected = 0; selected < SAVE_SLOT_COUNT; ++selected) {
+        int scrollOffset = std::max(0, selected - visibleRows + 1);
+        if (selected == SAVE_SLOT_COUNT - 1) {
+            status = "That slot is empty.";
+        }
+        for (int i = 0; i < FRAMES_PER_STEP; ++i) {
+            checker.run("slots", i == 0, [&](FrameArena& frame, ScreenText& text) {
+                buildSlotText(slots, selected, scrollOffset, status, WINDOW_HEIGHT, frame, text);
+            });
+        }
+    }
+}
+
+// Plays autopilot journeys, one after another, for at least the given
+// number of frames and until every travel screen has been shown. Returns
+// which ones were.
+std::vector<bool> checkTravelScreens(FrameChecker& checker, int frames) {
+    std::vector<bool> seen(TRAVEL_SCREEN_COUNT, false);
+    int unseen = TRAVEL_SCREEN_COUNT;
+    uint64_t seed = 1;
+    auto newJourney = [&seed]() {
+        Journey journey(PROFESSIONS[seed % (sizeof(PROFESSIONS) / sizeof(PROFESSIONS[0]))], seed);
+        ++seed;
+        journey.setLogging(false);
+        journey.setupInitialJourney();
+        return journey;
+    };
+
+    // Playing the journey allocates, so it happens between the counted frames
+    Journey journey = newJourney();
+    for (int frame = 0; ; ++frame) {
+        bool changed = frame % FRAMES_PER_STEP == 0;
+        if (changed && frame >= frames && unseen == 0) {
+            break;
+        }
+        if (changed && frame > 0) {
+            if (!journey.isGameOver()) {
+                journey.applyKey(chooseAutopilotKey(journey));
+            } else if (seed <= MAX_JOURNEYS) {
+                journey = newJourney();
+            } else {
+                break;
+            }
+        }
+        int shown = getTravelScreen(journey);
+        if (!seen[shown]) {
+            seen[shown] = true;
+            --unseen;
+        }
+
+        TravelScreen screen;
+        screen.journey = &journey;
+        screen.travelText = journey.getSubState() == TravelSubState::Traveling ? "Traveling... press SPACE to stop"
+                                                                               : "";
+        screen.helpText = "SPACE: Travel/Stop | 1: Rest | 2: Hunt | 3: Trade | ESC: Return to Menu";
+        screen.highScoreRank = journey.hasReachedOregon() ? 1 : 0;
+        screen.width = WINDOW_WIDTH;
+        screen.height = WINDOW_HEIGHT;
+        checker.run(TRAVEL_SCREEN_NAMES[shown], changed, [&](FrameArena& arena, ScreenText& text) {
+            buildTravelText(screen, arena, text);
+        });
+    }
+    return seen;
+}
+
+} // namespace
+
+int runFrameCheckCommand(int argc, char* argv[]) {
+    int frames = DEFAULT_FRAMES;
+    if (argc > 0) {
+        try {
+            frames = std::stoi(argv[0]);
+        } catch (const std::exception&) {
+            frames = 0;
+        }
+        if (frames <= 0) {
+            std::cerr << "Usage: --check-frames [frames]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Text is drawn offscreen, with the font the game uses
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32,
+                                                         SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        std::cerr << "Unable to create an offscreen renderer: " << SDL_GetError() << std::endl;
+        SDL_FreeSurface(target);
+        return 1;
+    }
+    int result = 1;
+    {
+        AssetCache assets(renderer, nullptr);
+        std::shared_ptr<TTF_Font> font = assets.getDefaultFont(16);
+        if (!font) {
+            std::cerr << "No font to draw with, so the frame check cannot run" << std::endl;
+        } else {
+            TextCache cache(renderer);
+            FrameChecker checker(cache, font);
+            checkLoadingScreen(checker);
+            checkMenu(checker);
+            checkInfoScreen(checker);
+
+            // Slots filled from journeys in a directory of their own
+            std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                              ("oregon-frame-check-" + std::to_string(getpid()));
+            {
+                SaveSlots slots(directory.string());
+                for (int i = 0; i < SAVE_SLOT_COUNT; i += 20) {
+                    Journey journey("Banker", i + 1);
+                    journey.setLogging(false);
+                    journey.setupInitialJourney();
+                    for (int key = 0; key < i && !journey.isGameOver(); ++key) {
+                        journey.applyKey(chooseAutopilotKey(journey));
+                    }
+                    slots.save(i, JourneySession(std::move(journey)), "Frame check party");
+                }
+                checkSlotList(checker, slots.isOpen() ? &slots : nullptr);
+            }
+            std::error_code error;
+            std::filesystem::remove_all(directory, error);
+
+            std::vector<bool> seen = checkTravelScreens(checker, frames);
+            int missing = 0;
+            for (int i = 0; i < TRAVEL_SCREEN_COUNT; ++i) {
+                if (!seen[i]) {
+                    std::cerr << "No journey reached the " << TRAVEL_SCREEN_NAMES[i] << " screen" << std::endl;
+                    ++missing;
+                }
+            }
+
+            std::cout << "Frame check: " << checker.getBadFrames() << " of "
+                      << checker.getFrames() - checker.getGrowingFrames()
+                      << " frames allocated or rendered unchanged text (the arena grew in "
+                      << checker.getGrowingFrames() << ")" << std::endl;
+            result = checker.getBadFrames() > 0 || missing > 0 ? 1 : 0;
+        }
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    shutdownSubsystems();
+    return result;
+}
@@ -0,0 +1,15 @@
+#ifndef FRAME_CHECK_HPP
+#define FRAME_CHECK_HPP
+
+// --check-frames [frames]: builds the text of every screen with the
+// functions the screens themselves draw from, frame after frame, and
+// draws it offscreen through a TextCache: the loading screen, the menu,
+// an info page scrolled end to end, the save slot list, and autopilot
+// journeys for at least that many frames and until every travel screen
+// has come up. Needs no window. Returns 1 if building a frame's text made
+// a heap allocation (other than the arena growing), if a frame showing the
+// same text as the one before rendered any of it again, or if a travel
+// screen never came up; else 0.
+int runFrameCheckCommand(int argc, char* argv[]);
+
+#endif // FRAME_CHECK_HPP
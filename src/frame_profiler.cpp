@@ -0,0 +1,103 @@
+#include "frame_profiler.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+const int PHASE_COUNT = static_cast<int>(FramePhase::Count);
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {"input", "jobs", "update", "render", "present"};
+
+int textureUploads = 0;
+int drawCalls = 0;
+
+} // namespace
+
+void countTextureUpload() {
+    ++textureUploads;
+}
+
+void countDrawCall() {
+    ++drawCalls;
+}
+
+const char* framePhaseName(FramePhase phase) {
+    int index = static_cast<int>(phase);
+    return index >= 0 && index < PHASE_COUNT ? PHASE_NAMES[index] : "?";
+}
+
+void FrameProfiler::beginFrame() {
+    m_current = FrameSample();
+    m_frameStart = std::chrono::steady_clock::now();
+    m_phaseStart = m_frameStart;
+}
+
+void FrameProfiler::endPhase(FramePhase phase) {
+    auto now = std::chrono::steady_clock::now();
+    m_current.phaseMilliseconds[static_cast<int>(phase)] +=
+        std::chrono::duration<float, std::milli>(now - m_phaseStart).count();
+    m_phaseStart = now;
+}
+
+void FrameProfiler::endFrame() {
+    m_current.frameMilliseconds =
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_frameStart).count();
+    m_current.textureUploads = static_cast<float>(textureUploads);
+    m_current.drawCalls = static_cast<float>(drawCalls);
+    textureUploads = 0;
+    drawCalls = 0;
+
+    m_samples[m_next] = m_current;
+    m_next = (m_next + 1) % WINDOW_FRAMES;
+    m_count = std::min(m_count + 1, WINDOW_FRAMES);
+}
+
+const FrameSample& FrameProfiler::getLast() const {
+    return m_samples[(m_next + WINDOW_FRAMES - 1) % WINDOW_FRAMES];
+}
+
+FrameSample FrameProfiler::getAverage() const {
+    FrameSample average;
+    if (m_count == 0) {
+        return average;
+    }
+    for (int i = 0; i < m_count; ++i) {
+        const FrameSample& sample = m_samples[i];
+        average.frameMilliseconds += sample.frameMilliseconds;
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            average.phaseMilliseconds[phase] += sample.phaseMilliseconds[phase];
+        }
+        average.textureUploads += sample.textureUploads;
+        average.drawCalls += sample.drawCalls;
+    }
+    average.frameMilliseconds /= m_count;
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        average.phaseMilliseconds[phase] /= m_count;
+    }
+    average.textureUploads /= m_count;
+    average.drawCalls /= m_count;
+    return average;
+}
+
+FrameSample FrameProfiler::getMaximum() const {
+    FrameSample maximum;
+    for (int i = 0; i < m_count; ++i) {
+        const FrameSample& sample = m_samples[i];
+        maximum.frameMilliseconds = std::max(maximum.frameMilliseconds, sample.frameMilliseconds);
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            maximum.phaseMilliseconds[phase] = std::max(maximum.phaseMilliseconds[phase],
+                                                        sample.phaseMilliseconds[phase]);
+        }
+        maximum.textureUploads = std::max(maximum.textureUploads, sample.textureUploads);
+        maximum.drawCalls = std::max(maximum.drawCalls, sample.drawCalls);
+    }
+    return maximum;
+}
+
+void FrameProfiler::getHistogram(int (&buckets)[HISTOGRAM_BUCKETS]) const {
+    std::fill(std::begin(buckets), std::end(buckets), 0);
+    for (int i = 0; i < m_count; ++i) {
+        int bucket = static_cast<int>(m_samples[i].frameMilliseconds) / BUCKET_MILLISECONDS;
+        ++buckets[std::min(std::max(bucket, 0), HISTOGRAM_BUCKETS - 1)];
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef FRAME_PROFILER_HPP
+#define FRAME_PROFILER_HPP
+
+#include <chrono>
+
+// Texture uploads and draw calls, counted by the code making them (SDL
+// has no hook for it) and collected once a frame by the frame profiler.
+// Main thread only. The game's own overlays do not count theirs.
+void countTextureUpload();
+void countDrawCall();
+
+// Where a frame's time went, in the order the game loop runs them
+enum class FramePhase {
+    Input,      // Events, handled by the state
+    Jobs,       // Background job results, reloads and texture uploads
+    Update,     // Fixed updates of the state
+    Render,     // Drawing the state
+    Present,    // SDL_RenderPresent, including any wait for vsync
+    Count
+};
+
+const char* framePhaseName(FramePhase phase);
+
+struct FrameSample {
+    float frameMilliseconds = 0.0f;     // Start to end, with the frame cap's wait
+    float phaseMilliseconds[static_cast<int>(FramePhase::Count)] = {};
+    float textureUploads = 0.0f;
+    float drawCalls = 0.0f;
+};
+
+// Times every frame phase by phase and keeps the last few seconds of them
+// for the frame overlay. Always on: a clock read per phase and a copy
+// into a fixed ring, so it never allocates.
+class FrameProfiler {
+public:
+    static constexpr int WINDOW_FRAMES = 120;
+    static constexpr int HISTOGRAM_BUCKETS = 16;
+    static constexpr int BUCKET_MILLISECONDS = 2;   // The last bucket takes the rest
+
+    void beginFrame();
+    // The time since the frame began or the previous phase ended
+    void endPhase(FramePhase phase);
+    // Records the frame along with the uploads and draws counted in it.
+    // Called after the frame cap's wait but not an idle wait, so a screen
+    // waiting for input does not show as one long frame.
+    void endFrame();
+
+    int getSampleCount() const { return m_count; }
+    const FrameSample& getLast() const;
+    FrameSample getAverage() const;
+    FrameSample getMaximum() const;
+    // Frames in the window by frame time
+    void getHistogram(int (&buckets)[HISTOGRAM_BUCKETS]) const;
+
+private:
+    std::chrono::steady_clock::time_point m_frameStart;
+    std::chrono::steady_clock::time_point m_phaseStart;
+    FrameSample m_current;
+    FrameSample m_samples[WINDOW_FRAMES];
+    int m_next = 0;
+    int m_count = 0;
+};
+
+#endif // FRAME_PROFILER_HPP
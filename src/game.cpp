@@ -1,14 +1,97 @@
 #include "game.hpp"
+#include "asset_cache.hpp"
+#include "file_watcher.hpp"
+#include "frame_arena.hpp"
+#include "frame_profiler.hpp"
+#include "autosave.hpp"
 #include "game_state.hpp"
+#include "high_scores.hpp"
+#include "job_system.hpp"
+#include "save_slots.hpp"
+#include "sdl_subsystems.hpp"
+#include "startup_profile.hpp"
+#include "text_cache.hpp"
+#include "tombstones.hpp"
 #include "player.hpp"
+#include "resource_pack.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_mixer.h>
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
 #include <memory>
 
+namespace {
+
+// Longest sleep while idle; nothing needs redrawing sooner
+const int IDLE_WAIT_MS = 250;
+
+// A frame slower than this (a stall, a debugger break) is not caught up
+// on, so one slow frame cannot snowball into many updates the next
+const float MAX_FRAME_TIME = 0.25f;
+
+// Decoded image pixels handed to the GPU per frame while preloading, so a
+// burst of finished images cannot stall one frame
+const size_t UPLOAD_BYTES_PER_FRAME = 4 * 1024 * 1024;
+
+const char* const TRAIL_DATA_PATH = "resources/data/trail.txt";
+
+// Room for every string drawn in a frame; the busiest screen uses a few
+// kilobytes. Grows if a frame ever needs more.
+const size_t FRAME_ARENA_BYTES = 64 * 1024;
+
+// Frames reported one by one by the allocation check; the rest are counted
+const int MAX_REPORTED_FRAMES = 20;
+
+const SDL_Color OVERLAY_TEXT_COLOR = {144, 238, 144, 255};
+const int OVERLAY_LINE_HEIGHT = 18;
+
+// The frame time histogram, under the frame overlay's text
+const int HISTOGRAM_BAR_WIDTH = 16;
+const int HISTOGRAM_HEIGHT = 60;
+
+// "812", "12.4K", "3.1M"
+const char* compactBytes(FrameArena& frame, int64_t bytes) {
+    if (bytes < 1024 && bytes > -1024) {
+        return frame.format("%lld", static_cast<long long>(bytes));
+    }
+    if (bytes < 1024 * 1024 && bytes > -1024 * 1024) {
+        return frame.format("%.1fK", bytes / 1024.0);
+    }
+    return frame.format("%.1fM", bytes / (1024.0 * 1024.0));
+}
+
+int overlayTextWidth(TTF_Font* font, const char* text) {
+    int width = 0;
+    return TTF_SizeText(font, text, &width, nullptr) == 0 ? width : 0;
+}
+
+void drawOverlayBox(SDL_Renderer* renderer, const SDL_Rect& box) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderFillRect(renderer, &box);
+    SDL_SetRenderDrawColor(renderer, OVERLAY_TEXT_COLOR.r, OVERLAY_TEXT_COLOR.g, OVERLAY_TEXT_COLOR.b, 255);
+    SDL_RenderDrawRect(renderer, &box);
+}
+
+void drawOverlayText(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y) {
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text, OVERLAY_TEXT_COLOR);
+    if (!surface) {
+        return;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (texture) {
+        SDL_Rect quad = {x, y, surface->w, surface->h};
+        SDL_RenderCopy(renderer, texture, nullptr, &quad);
+        SDL_DestroyTexture(texture);
+    }
+    SDL_FreeSurface(surface);
+}
+
+} // namespace
+
 Game::Game(const std::string& title, int width, int height)
     : m_windowTitle(title)
     , m_windowWidth(width)
@@ -16,6 +99,8 @@ Game::Game(const std::string& title, int width, int height)
     , m_window(nullptr)
     , m_renderer(nullptr)
     , m_isRunning(false)
+    , m_frameArena(std::make_unique<FrameArena>(FRAME_ARENA_BYTES))
+    , m_profiler(std::make_unique<FrameProfiler>())
     , m_player(nullptr)
 {
 }
@@ -46,22 +131,102 @@ Game::~Game() {
 }
 
 bool Game::initialize() {
-    if (!initSDL()) {
+    // Video only; SDL_ttf, SDL_image and audio start when first needed
+    {
+        StartupTimer timer("SDL video");
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+            std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
+            return false;
+        }
+    }
+    
+    // One worker per core; the main thread is left to input and drawing
+    {
+        StartupTimer timer("job system");
+        m_wakeEvent = SDL_RegisterEvents(1);
+        m_jobs = std::make_unique<JobSystem>(0, [this] { wakeMainThread(); });
+    }
+    
+    // Mapping it costs next to nothing; reading from it comes later
+    if (!m_packPath.empty()) {
+        StartupTimer timer("resource pack");
+        auto pack = std::make_shared<ResourcePack>();
+        if (pack->open(m_packPath)) {
+            m_pack = std::move(pack);
+        } else {
+            std::cout << "No resource pack at " << m_packPath << ", reading loose files" << std::endl;
+        }
+    }
+    
+    // Independent of the window, so done while it opens. The font library
+    // is certain to be wanted for the first text on screen.
+    JobGroup startup;
+    m_jobs->run(startup, [] { requireFontLoader(); });
+    m_jobs->run(startup, [this] {
+        StartupTimer timer("trail data");
+        PackBlob blob;
+        if (m_pack && m_pack->read(TRAIL_DATA_PATH, blob)) {
+            m_trail = loadTrailData(reinterpret_cast<const char*>(blob.data), blob.size,
+                                    m_pack->getPath() + ":" + TRAIL_DATA_PATH);
+        } else {
+            m_trail = loadTrailData(TRAIL_DATA_PATH);
+        }
+    });
+    
+    bool windowOpen = initSDL();
+    m_jobs->wait(startup);
+    if (!windowOpen) {
         return false;
     }
     
+    m_assets = std::make_unique<AssetCache>(m_renderer, m_pack);
+    m_textCache = std::make_unique<TextCache>(m_renderer);
+    if (m_hotReload) {
+        m_watcher = std::make_unique<FileWatcher>([this] { wakeMainThread(); });
+        m_assets->setFileWatcher(m_watcher.get());
+        m_watcher->watch(TRAIL_DATA_PATH);
+    }
     m_player = std::make_unique<Player>("Player");
     m_isRunning = true;
     return true;
 }
 
+const SimParams& Game::getSimParams(const std::string& profession) const {
+    auto it = m_professionParams.find(profession);
+    return it != m_professionParams.end() ? it->second : m_defaultParams;
+}
+
+void Game::setSimParams(const std::string& profession, const SimParams& params) {
+    m_professionParams[profession] = params;
+}
+
+void Game::setUpdateRate(int updatesPerSecond) {
+    m_updateStep = 1.0f / std::max(1, updatesPerSecond);
+}
+
+void Game::startAutosave(const std::string& directory) {
+    m_autosave = std::make_unique<AutosaveWriter>(directory);
+    std::cout << "Autosaving journeys to " << directory << std::endl;
+}
+
+void Game::openHighScores(const std::string& directory) {
+    StartupTimer timer("high scores");
+    m_highScores = std::make_unique<HighScoreTable>(directory);
+}
+
+void Game::openSaveSlots(const std::string& directory) {
+    StartupTimer timer("save slots");
+    m_saveSlots = std::make_unique<SaveSlots>(directory);
+}
+
+void Game::openTombstones(const std::string& directory) {
+    StartupTimer timer("graves");
+    m_tombstones = std::make_unique<TombstoneRegistry>(directory);
+}
+
 bool Game::initSDL() {
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
-        std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
-        return false;
-    }
-    
     // Create window
+    double start = startupMilliseconds();
     m_window = SDL_CreateWindow(
         m_windowTitle.c_str(),
         SDL_WINDOWPOS_CENTERED,
@@ -75,8 +240,10 @@ bool Game::initSDL() {
         std::cerr << "Window creation failed: " << SDL_GetError() << std::endl;
         return false;
     }
+    recordStartupPhase("window", start);
     
     // Create renderer
+    start = startupMilliseconds();
     m_renderer = SDL_CreateRenderer(
         m_window,
         -1,
@@ -87,25 +254,7 @@ bool Game::initSDL() {
         std::cerr << "Renderer creation failed: " << SDL_GetError() << std::endl;
         return false;
     }
-    
-    // Initialize SDL_image
-    int imgFlags = IMG_INIT_PNG;
-    if (!(IMG_Init(imgFlags) & imgFlags)) {
-        std::cerr << "SDL_image initialization failed: " << IMG_GetError() << std::endl;
-        return false;
-    }
-    
-    // Initialize SDL_ttf
-    if (TTF_Init() != 0) {
-        std::cerr << "SDL_ttf initialization failed: " << TTF_GetError() << std::endl;
-        return false;
-    }
-    
-    // Initialize SDL_mixer
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
-        std::cerr << "SDL_mixer initialization failed: " << Mix_GetError() << std::endl;
-        return false;
-    }
+    recordStartupPhase("renderer", start);
     
     return true;
 }
@@ -115,36 +264,155 @@ void Game::run() {
         throw std::runtime_error("Game not initialized");
     }
     
-    Uint32 lastTime = SDL_GetTicks();
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 lastTime = SDL_GetPerformanceCounter();
+    float accumulator = 0.0f;
     
     // Game loop
     while (m_isRunning) {
-        // Calculate delta time
-        Uint32 currentTime = SDL_GetTicks();
-        float deltaTime = (currentTime - lastTime) / 1000.0f;
-        lastTime = currentTime;
+        bool animating = hasStates() && currentState()->isAnimating();
+        if (m_idleWhenStatic && !animating && !m_assets->hasPendingUploads()) {
+            waitForEvent();
+            
+            // Nothing was moving, so the time asleep needs no updates; but
+            // one update, so the state sees what woke it
+            lastTime = SDL_GetPerformanceCounter();
+            accumulator = m_updateStep;
+        }
         
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        float frameTime = static_cast<float>(frameStart - lastTime) / frequency;
+        lastTime = frameStart;
+        accumulator += std::min(frameTime, MAX_FRAME_TIME);
+        
+        m_profiler->beginFrame();
+        m_frameArena->reset();
+        m_textCache->beginFrame();
         processInput();
-        update(deltaTime);
+        m_profiler->endPhase(FramePhase::Input);
+        
+        // Results of background jobs, delivered before states update
+        m_jobs->runCompletions();
+        applyFileChanges();
+        m_assets->uploadPending(UPLOAD_BYTES_PER_FRAME);
+        m_profiler->endPhase(FramePhase::Jobs);
+        
+        // Fixed steps, so states behave the same at any frame rate
+        uint64_t allocationsBefore = threadHeapAllocations();
+        while (accumulator >= m_updateStep && m_isRunning) {
+            update(m_updateStep);
+            accumulator -= m_updateStep;
+        }
+        m_interpolation = accumulator / m_updateStep;
+        m_profiler->endPhase(FramePhase::Update);
+        
         render();
+        if (m_checkFrameAllocations) {
+            checkFrameAllocations(threadHeapAllocations() - allocationsBefore);
+        }
+        if (isHeapTracking()) {
+            HeapSnapshot now = getHeapSnapshot();
+            m_heapFrame = heapDifference(now, m_heapLast);
+            m_heapLast = now;
+        }
+        limitFrameRate(frameStart);
+        m_profiler->endFrame();
+    }
+}
+
+void Game::checkFrameAllocations(uint64_t allocations) {
+    // Input, entering a state, or a state's first frame can all build
+    // things; only frames where the same state draws again without input
+    // have to be free of allocations
+    bool entered = m_stateEntries != m_lastFrameEntries;
+    bool steady = m_frameEvents == 0 && !entered && !m_lastFrameEntered && hasStates() &&
+                  !currentState()->isLoadingScreen();
+    m_lastFrameEntries = m_stateEntries;
+    m_lastFrameEntered = entered;
+    m_frameEvents = 0;
+    ++m_frameNumber;
+    if (!steady) {
+        return;
+    }
+    
+    ++m_steadyFrames;
+    if (allocations > 0) {
+        if (++m_allocatingFrames <= MAX_REPORTED_FRAMES) {
+            std::cerr << "Frame " << m_frameNumber << " in " << currentState()->getName() << " made "
+                      << allocations << " heap allocations" << std::endl;
+        }
+    }
+}
+
+void Game::applyFileChanges() {
+    if (!m_watcher) {
+        return;
+    }
+    HeapScope scope(HeapSubsystem::Assets);
+    // Between frames, so nothing is halfway through drawing the old data
+    for (const std::string& path : m_watcher->takeChanged()) {
+        if (path == TRAIL_DATA_PATH) {
+            // Journeys under way keep the trail they started on (their
+            // replays and autosaves are tied to it); new ones get this
+            m_trail = loadTrailData(path);
+        } else {
+            m_assets->reload(path);
+        }
+    }
+}
+
+void Game::waitForEvent() {
+    // Leaves the event queued for processInput()
+    SDL_WaitEventTimeout(nullptr, IDLE_WAIT_MS);
+}
+
+void Game::wakeMainThread() {
+    // Called from job threads; SDL_PushEvent is safe from any thread
+    if (m_wakeEvent != static_cast<Uint32>(-1)) {
+        SDL_Event event;
+        SDL_zero(event);
+        event.type = m_wakeEvent;
+        SDL_PushEvent(&event);
+    }
+}
+
+void Game::limitFrameRate(Uint64 frameStart) {
+    if (m_frameCap <= 0) {
+        return;
+    }
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 frameTicks = frequency / static_cast<Uint64>(m_frameCap);
+    Uint64 elapsed = SDL_GetPerformanceCounter() - frameStart;
+    if (elapsed < frameTicks) {
+        SDL_Delay(static_cast<Uint32>((frameTicks - elapsed) * 1000 / frequency));
     }
 }
 
 void Game::processInput() {
+    HeapScope scope(HeapSubsystem::States);
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         if (event.type == SDL_QUIT) {
             m_isRunning = false;
         }
+        if (event.type == m_wakeEvent) {
+            continue;   // Only there to end an idle wait
+        }
+        if (handleOverlayKey(event)) {
+            continue;
+        }
         
         // Let the current state handle any other input
         if (hasStates()) {
+            ++m_frameEvents;
             currentState()->handleEvent(event);
         }
     }
 }
 
 void Game::update(float deltaTime) {
+    HeapScope scope(HeapSubsystem::States);
+    
     // Update the current state
     if (hasStates()) {
         currentState()->update(deltaTime);
@@ -157,6 +425,8 @@ void Game::update(float deltaTime) {
 }
 
 void Game::render() {
+    HeapScope scope(HeapSubsystem::Render);
+    
     // Clear screen
     SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
     SDL_RenderClear(m_renderer);
@@ -165,28 +435,239 @@ void Game::render() {
     if (hasStates()) {
         currentState()->render();
     }
+    if (m_showHeapOverlay) {
+        renderHeapOverlay();
+    }
+    if (m_showFrameOverlay) {
+        renderFrameOverlay();
+    }
+    m_profiler->endPhase(FramePhase::Render);
     
     // Present render
     SDL_RenderPresent(m_renderer);
+    m_profiler->endPhase(FramePhase::Present);
+    
+    if (!m_startupRecorded) {
+        recordFirstFrames();
+    }
+}
+
+bool Game::handleOverlayKey(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) {
+        return false;
+    }
+    if (event.key.keysym.sym == SDLK_F2) {
+        m_showFrameOverlay = !m_showFrameOverlay;
+        return true;
+    }
+    if (!isHeapTracking()) {
+        return false;
+    }
+    if (event.key.keysym.sym == SDLK_F3) {
+        m_showHeapOverlay = !m_showHeapOverlay;
+        return true;
+    }
+    if (event.key.keysym.sym == SDLK_F4) {
+        if (dumpHeapStats(m_heapStatsPath, getHeapSnapshot(), &m_heapFrame)) {
+            std::cout << "Wrote heap stats to " << m_heapStatsPath << std::endl;
+        } else {
+            std::cerr << "Unable to write heap stats to " << m_heapStatsPath << std::endl;
+        }
+        return true;
+    }
+    return false;
+}
+
+void Game::renderHeapOverlay() {
+    std::shared_ptr<TTF_Font> font = m_assets->getDefaultFont(16, false);
+    if (!font) {
+        return;
+    }
+    
+    // Calls and bytes are the last frame's; live and peak are now. Every
+    // row is as wide as the header.
+    FrameArena& frame = *m_frameArena;
+    const char* header = frame.format("%-7s%6s%8s%8s%8s", "", "calls", "bytes", "live", "peak");
+    const int rows = static_cast<int>(HeapSubsystem::Count) + 3;
+    SDL_Rect box = {10, 10, overlayTextWidth(font.get(), header) + 16, rows * OVERLAY_LINE_HEIGHT + 10};
+    drawOverlayBox(m_renderer, box);
+    
+    int x = box.x + 8;
+    int y = box.y + 5;
+    drawOverlayText(m_renderer, font.get(), "HEAP PER FRAME (F4 SAVES)", x, y);
+    y += OVERLAY_LINE_HEIGHT;
+    drawOverlayText(m_renderer, font.get(), header, x, y);
+    y += OVERLAY_LINE_HEIGHT;
+    
+    uint64_t calls = 0;
+    int64_t bytes = 0;
+    int64_t live = 0;
+    for (int i = 0; i < static_cast<int>(HeapSubsystem::Count); ++i) {
+        const HeapCounters& made = m_heapFrame.subsystems[i];
+        const HeapCounters& now = m_heapLast.subsystems[i];
+        drawOverlayText(m_renderer, font.get(),
+                        frame.format("%-7s%6llu%8s%8s%8s", heapSubsystemName(static_cast<HeapSubsystem>(i)),
+                                     static_cast<unsigned long long>(made.calls),
+                                     compactBytes(frame, static_cast<int64_t>(made.bytes)),
+                                     compactBytes(frame, now.liveBytes), compactBytes(frame, now.peakLiveBytes)),
+                        x, y);
+        y += OVERLAY_LINE_HEIGHT;
+        calls += made.calls;
+        bytes += static_cast<int64_t>(made.bytes);
+        live += now.liveBytes;
+    }
+    drawOverlayText(m_renderer, font.get(),
+                    frame.format("%-7s%6llu%8s%8s%8s", "all", static_cast<unsigned long long>(calls),
+                                 compactBytes(frame, bytes), compactBytes(frame, live),
+                                 compactBytes(frame, m_heapLast.peakLiveBytes)),
+                    x, y);
+}
+
+void Game::renderFrameOverlay() {
+    std::shared_ptr<TTF_Font> font = m_assets->getDefaultFont(16, false);
+    if (!font) {
+        return;
+    }
+    
+    FrameArena& frame = *m_frameArena;
+    const FrameSample& last = m_profiler->getLast();
+    FrameSample average = m_profiler->getAverage();
+    FrameSample maximum = m_profiler->getMaximum();
+    
+    // Title, header, the phases, then frame time, uploads and draws; the
+    // histogram and its scale go under them
+    const char* header = frame.format("%-8s%7s%7s%7s", "ms", "last", "avg", "max");
+    const int rows = static_cast<int>(FramePhase::Count) + 5;
+    const int histogramWidth = FrameProfiler::HISTOGRAM_BUCKETS * HISTOGRAM_BAR_WIDTH;
+    SDL_Rect box;
+    box.w = std::max(overlayTextWidth(font.get(), header), histogramWidth) + 16;
+    box.h = (rows + 1) * OVERLAY_LINE_HEIGHT + HISTOGRAM_HEIGHT + 20;
+    box.x = 10;
+    box.y = m_windowHeight - box.h - 10;
+    drawOverlayBox(m_renderer, box);
+    
+    int x = box.x + 8;
+    int y = box.y + 5;
+    drawOverlayText(m_renderer, font.get(),
+                    frame.format("FRAMES: %s", hasStates() ? currentState()->getName().c_str() : "none"), x, y);
+    y += OVERLAY_LINE_HEIGHT;
+    drawOverlayText(m_renderer, font.get(), header, x, y);
+    y += OVERLAY_LINE_HEIGHT;
+    for (int i = 0; i < static_cast<int>(FramePhase::Count); ++i) {
+        drawOverlayText(m_renderer, font.get(),
+                        frame.format("%-8s%7.2f%7.2f%7.2f", framePhaseName(static_cast<FramePhase>(i)),
+                                     last.phaseMilliseconds[i], average.phaseMilliseconds[i],
+                                     maximum.phaseMilliseconds[i]),
+                        x, y);
+        y += OVERLAY_LINE_HEIGHT;
+    }
+    drawOverlayText(m_renderer, font.get(),
+                    frame.format("%-8s%7.2f%7.2f%7.2f", "frame", last.frameMilliseconds, average.frameMilliseconds,
+                                 maximum.frameMilliseconds),
+                    x, y);
+    y += OVERLAY_LINE_HEIGHT;
+    drawOverlayText(m_renderer, font.get(),
+                    frame.format("%-8s%7.0f%7.1f%7.0f", "uploads", last.textureUploads, average.textureUploads,
+                                 maximum.textureUploads),
+                    x, y);
+    y += OVERLAY_LINE_HEIGHT;
+    drawOverlayText(m_renderer, font.get(),
+                    frame.format("%-8s%7.0f%7.1f%7.0f", "draws", last.drawCalls, average.drawCalls,
+                                 maximum.drawCalls),
+                    x, y);
+    y += OVERLAY_LINE_HEIGHT + 5;
+    
+    // Frames of the last two seconds by frame time; bars past the frame
+    // budget are drawn in red
+    int buckets[FrameProfiler::HISTOGRAM_BUCKETS];
+    m_profiler->getHistogram(buckets);
+    int tallest = std::max(1, *std::max_element(std::begin(buckets), std::end(buckets)));
+    float budget = 1000.0f / (m_frameCap > 0 ? m_frameCap : 60);
+    int bottom = y + HISTOGRAM_HEIGHT;
+    for (int i = 0; i < FrameProfiler::HISTOGRAM_BUCKETS; ++i) {
+        if (buckets[i] == 0) {
+            continue;
+        }
+        int height = std::max(1, buckets[i] * HISTOGRAM_HEIGHT / tallest);
+        SDL_Rect bar = {x + i * HISTOGRAM_BAR_WIDTH, bottom - height, HISTOGRAM_BAR_WIDTH - 2, height};
+        if (i * FrameProfiler::BUCKET_MILLISECONDS >= budget) {
+            SDL_SetRenderDrawColor(m_renderer, 230, 80, 80, 255);
+        } else {
+            SDL_SetRenderDrawColor(m_renderer, OVERLAY_TEXT_COLOR.r, OVERLAY_TEXT_COLOR.g, OVERLAY_TEXT_COLOR.b, 255);
+        }
+        SDL_RenderFillRect(m_renderer, &bar);
+    }
+    int budgetX = x + static_cast<int>(budget / FrameProfiler::BUCKET_MILLISECONDS * HISTOGRAM_BAR_WIDTH);
+    SDL_SetRenderDrawColor(m_renderer, 255, 255, 255, 255);
+    SDL_RenderDrawLine(m_renderer, budgetX, y, budgetX, bottom);
+    
+    const char* scale = frame.format("%d+ ms", (FrameProfiler::HISTOGRAM_BUCKETS - 1) *
+                                               FrameProfiler::BUCKET_MILLISECONDS);
+    drawOverlayText(m_renderer, font.get(), "0", x, bottom + 2);
+    drawOverlayText(m_renderer, font.get(), scale, x + histogramWidth - overlayTextWidth(font.get(), scale),
+                    bottom + 2);
+}
+
+void Game::reportHeapAtShutdown() {
+    if (!isHeapTracking()) {
+        return;
+    }
+    HeapSnapshot now = getHeapSnapshot();
+    std::cout << "Heap by subsystem at shutdown (peak is the high-water mark):" << std::endl;
+    printHeapStats(std::cout, now, nullptr);
+    
+    // Every state, asset, job and the simulation are gone by now, so what
+    // they still hold was never freed. "other" also has what main() and
+    // this Game still own, so it is not reported.
+    bool leaked = false;
+    for (int i = 0; i < static_cast<int>(HeapSubsystem::Count); ++i) {
+        const HeapCounters& counter = now.subsystems[i];
+        if (static_cast<HeapSubsystem>(i) != HeapSubsystem::Other && counter.liveBlocks > 0) {
+            std::cerr << "Leak: " << heapSubsystemName(static_cast<HeapSubsystem>(i)) << " still holds "
+                      << counter.liveBytes << " bytes in " << counter.liveBlocks << " blocks" << std::endl;
+            leaked = true;
+        }
+    }
+    if (!leaked) {
+        std::cout << "Nothing allocated by render, sim, assets or states is left" << std::endl;
+    }
+    
+    if (!m_heapStatsPath.empty() && dumpHeapStats(m_heapStatsPath, now, nullptr)) {
+        std::cout << "Wrote heap stats to " << m_heapStatsPath << std::endl;
+    }
+}
+
+void Game::recordFirstFrames() {
+    if (!m_firstFrameRecorded) {
+        recordStartupMilestone("first frame");
+        m_firstFrameRecorded = true;
+    }
+    if (hasStates() && !currentState()->isLoadingScreen()) {
+        recordStartupMilestone("first interactive frame");
+        m_startupRecorded = true;
+        if (m_profileStartup) {
+            printStartupProfile(std::cout);
+        }
+    }
 }
 
 void Game::pushState(std::unique_ptr<GameState> state) {
     if (state) {
         if (!m_states.empty()) {
-            m_states.top()->exit();
+            exitTopState();
         }
         m_states.push(std::move(state));
-        m_states.top()->enter();
+        enterTopState();
     }
 }
 
 void Game::popState() {
     if (!m_states.empty()) {
-        m_states.top()->exit();
-        m_states.pop();
+        exitTopState();
+        retireTopState();
         
         if (!m_states.empty()) {
-            m_states.top()->enter();
+            enterTopState();
         } else {
             // No more states, exit the game
             m_isRunning = false;
@@ -197,14 +678,83 @@ void Game::popState() {
 void Game::changeState(std::unique_ptr<GameState> state) {
     if (state) {
         if (!m_states.empty()) {
-            m_states.top()->exit();
-            m_states.pop();
+            exitTopState();
+            retireTopState();
         }
         m_states.push(std::move(state));
-        m_states.top()->enter();
+        enterTopState();
+    }
+}
+
+void Game::changeState(const std::string& name) {
+    changeState(acquireState(name));
+}
+
+void Game::registerState(const std::string& name, std::function<std::unique_ptr<GameState>()> factory) {
+    m_registry[name].factory = std::move(factory);
+}
+
+std::unique_ptr<GameState> Game::acquireState(const std::string& name) {
+    auto it = m_registry.find(name);
+    if (it == m_registry.end()) {
+        std::cerr << "No state registered as " << name << std::endl;
+        return nullptr;
+    }
+    RegisteredState& registered = it->second;
+    if (registered.parked) {
+        return std::move(registered.parked);
+    }
+    if (registered.instance) {
+        std::cerr << "State " << name << " is already in use" << std::endl;
+        return nullptr;
+    }
+    std::unique_ptr<GameState> state = registered.factory();
+    registered.instance = state.get();
+    return state;
+}
+
+void Game::addStateHooks(const std::string& name, StateHooks hooks) {
+    m_stateHooks.emplace(name, std::move(hooks));
+}
+
+void Game::enterTopState() {
+    GameState* state = m_states.top().get();
+    ++m_stateEntries;
+    state->enter();
+    for (const auto& entry : m_stateHooks) {
+        if (entry.second.onEnter && (entry.first.empty() || isRegisteredAs(state, entry.first))) {
+            entry.second.onEnter(*state);
+        }
+    }
+}
+
+void Game::exitTopState() {
+    GameState* state = m_states.top().get();
+    for (const auto& entry : m_stateHooks) {
+        if (entry.second.onExit && (entry.first.empty() || isRegisteredAs(state, entry.first))) {
+            entry.second.onExit(*state);
+        }
+    }
+    state->exit();
+}
+
+void Game::retireTopState() {
+    std::unique_ptr<GameState> state = std::move(m_states.top());
+    m_states.pop();
+    for (auto& entry : m_registry) {
+        if (entry.second.instance == state.get()) {
+            // Kept for next time; anything else is destroyed here
+            entry.second.parked = std::move(state);
+            return;
+        }
     }
 }
 
+bool Game::isRegisteredAs(const GameState* state, const std::string& name) const {
+    auto it = m_registry.find(name);
+    return it != m_registry.end() && it->second.instance == state;
+}
+
 GameState* Game::currentState() {
     return m_states.empty() ? nullptr : m_states.top().get();
 }
@@ -221,17 +771,39 @@ void Game::shutdown() {
         try {
             if (m_states.top()) {
                 std::cout << "Exiting state during shutdown" << std::endl;
-                m_states.top()->exit();
+                exitTopState();
             }
             m_states.pop();
         } catch (const std::exception& e) {
             std::cerr << "Error during state cleanup: " << e.what() << std::endl;
         }
     }
+    // Registered states the player had left, with the rest
+    m_registry.clear();
+    
+    if (m_checkFrameAllocations) {
+        std::cout << "Frame allocation check: " << m_allocatingFrames << " of " << m_steadyFrames
+                  << " steady frames made heap allocations" << std::endl;
+    }
     
     // Clean up player
     m_player.reset();
     
+    // Let running jobs finish; their completions are no longer delivered
+    m_jobs.reset();
+    m_watcher.reset();
+    
+    // Every state is gone, so nothing holds an asset any more
+    m_textCache.reset();
+    if (m_assets) {
+        m_assets->printReport(std::cout);
+        m_assets.reset();
+    }
+    m_pack.reset();
+
+    // Finish writing the autosave before the process goes away
+    m_autosave.reset();
+    
     // Clean up SDL resources
     if (m_renderer) {
         SDL_DestroyRenderer(m_renderer);
@@ -243,10 +815,12 @@ void Game::shutdown() {
     }
     
     // Quit SDL subsystems
-    Mix_Quit();
-    TTF_Quit();
-    IMG_Quit();
+    shutdownSubsystems();
     SDL_Quit();
     
+    // No journey is left to use it
+    m_trail.reset();
+    reportHeapAtShutdown();
+    
     std::cout << "Game shutdown complete" << std::endl;
 }
@@ -1,18 +1,41 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include <functional>
 #include <string>
 #include <memory>
 #include <vector>
 #include <stack>
+#include <map>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_mixer.h>
+#include "heap_tracker.hpp"
 #include "player.hpp"
+#include "sim_params.hpp"
+#include "trail_data.hpp"
 
 // Forward declarations
+class AssetCache;
+class FileWatcher;
+class FrameArena;
+class FrameProfiler;
 class GameState;
+class JobSystem;
+class ResourcePack;
+class AutosaveWriter;
+class HighScoreTable;
+class SaveSlots;
+class TextCache;
+class TombstoneRegistry;
+
+// Run as a state is entered and left, after its own enter() and before its
+// own exit()
+struct StateHooks {
+    std::function<void(GameState&)> onEnter;
+    std::function<void(GameState&)> onExit;
+};
 
 class Game {
 public:
@@ -34,12 +57,121 @@ public:
     GameState* currentState();
     bool hasStates() const;
     
+    // Long-lived states, by name. A registered state is built the first
+    // time it is asked for and kept when the player leaves it, so going
+    // back re-enters the same instance instead of building and loading it
+    // again. Register before run().
+    void registerState(const std::string& name, std::function<std::unique_ptr<GameState>()> factory);
+    
+    // The registered state, to pass to pushState() or changeState() (or to
+    // hand to a loading screen). Null if name is not registered or the
+    // state is already in use.
+    std::unique_ptr<GameState> acquireState(const std::string& name);
+    void changeState(const std::string& name);
+    
+    // Hooks for the named state, or for every state if name is empty
+    void addStateHooks(const std::string& name, StateHooks hooks);
+    
     // Accessor methods
     SDL_Renderer* getRenderer() const { return m_renderer; }
     SDL_Window* getWindow() const { return m_window; }
     int getWindowWidth() const { return m_windowWidth; }
     int getWindowHeight() const { return m_windowHeight; }
     
+    // Pack of fonts, text and data to read instead of loose files. Set
+    // before initialize(); empty (or a missing file) reads loose files.
+    void setResourcePackPath(const std::string& path) { m_packPath = path; }
+    
+    // Reload text and trail data edited on disk while the game runs. Set
+    // before initialize().
+    void setHotReload(bool enabled) { m_hotReload = enabled; }
+    
+    // Fonts, images and text shared by every state
+    AssetCache* getAssets() const { return m_assets.get(); }
+    
+    // Bytes of assets kept in memory before landmark art and audio behind
+    // the wagon are released
+    size_t getAssetBudget() const { return m_assetBudget; }
+    void setAssetBudget(size_t bytes) { m_assetBudget = bytes; }
+    
+    // Scratch memory for text drawn this frame; released when the next
+    // frame begins
+    FrameArena& getFrameArena() const { return *m_frameArena; }
+    
+    // Textures of the text drawn in recent frames, so text that stays the
+    // same is rendered once
+    TextCache* getTextCache() const { return m_textCache.get(); }
+    
+    // Background workers; results come back between frames
+    JobSystem* getJobs() const { return m_jobs.get(); }
+    
+    // Simulation data shared by every journey
+    std::shared_ptr<const TrailData> getTrail() const { return m_trail; }
+    const SimParams& getSimParams(const std::string& profession) const;
+    void setSimParams(const std::string& profession, const SimParams& params);
+
+    // Where live journeys are recorded for replay analysis (empty = off)
+    const std::string& getRecordingDirectory() const { return m_recordingDirectory; }
+    void setRecordingDirectory(const std::string& directory) { m_recordingDirectory = directory; }
+
+    // Bytes of per-journey rewind history (classroom mode; 0 = no rewind)
+    size_t getRewindBudget() const { return m_rewindBudget; }
+    void setRewindBudget(size_t bytes) { m_rewindBudget = bytes; }
+
+    // Background autosave of the journey in progress (null = off)
+    AutosaveWriter* getAutosave() const { return m_autosave.get(); }
+    void startAutosave(const std::string& directory);
+
+    // Scores of journeys that reached Oregon (null = not kept)
+    HighScoreTable* getHighScores() const { return m_highScores.get(); }
+    void openHighScores(const std::string& directory);
+
+    // Named save slots for journeys in progress (null = none)
+    SaveSlots* getSaveSlots() const { return m_saveSlots.get(); }
+    void openSaveSlots(const std::string& directory);
+
+    // Graves left by earlier journeys (null = none)
+    TombstoneRegistry* getTombstones() const { return m_tombstones.get(); }
+    void openTombstones(const std::string& directory);
+    
+    // Frame pacing. States are updated at a fixed rate however fast frames
+    // are drawn; frames are capped at m_frameCap per second (0 = only
+    // vsync); and when the current state is not animating the loop sleeps
+    // until the next event.
+    void setUpdateRate(int updatesPerSecond);
+    void setFrameCap(int framesPerSecond) { m_frameCap = framesPerSecond; }
+    void setIdleWhenStatic(bool enabled) { m_idleWhenStatic = enabled; }
+
+    // Days per second while the wagon travels on its own, and whether SPACE
+    // toggles that (rather than holding SPACE down)
+    float getTravelRate() const { return m_travelRate; }
+    void setTravelRate(float daysPerSecond) { m_travelRate = daysPerSecond; }
+    bool isTravelToggle() const { return m_travelToggle; }
+    void setTravelToggle(bool enabled) { m_travelToggle = enabled; }
+
+    // Print how long each phase of startup took, once the first frame the
+    // player can act on is on screen
+    void setProfileStartup(bool enabled) { m_profileStartup = enabled; }
+
+    // Count heap allocations in steady frames (no input, same state as the
+    // frame before) and report every frame that made any. Such a frame
+    // should make none; a build that does fails the check.
+    void setCheckFrameAllocations(bool enabled) { m_checkFrameAllocations = enabled; }
+    int getAllocatingFrameCount() const { return m_allocatingFrames; }
+    
+    // Heap use by subsystem, once heap tracking is on (--heap-stats). F3
+    // shows it over the game and F4 writes it to this file; high-water
+    // marks and what is still allocated are reported at shutdown.
+    void setHeapStatsPath(const std::string& path) { m_heapStatsPath = path; }
+    
+    // Frame times, split by phase, with a histogram of the last two seconds
+    // and the state's texture uploads and draw calls. F2 toggles it.
+    void setShowFrameOverlay(bool shown) { m_showFrameOverlay = shown; }
+
+    // How far this frame is from the last fixed update to the next (0-1),
+    // for states that draw motion between updates
+    float getInterpolation() const { return m_interpolation; }
+    
     // Game control
     void quit();
 
@@ -48,6 +180,20 @@ private:
     void processInput();
     void update(float deltaTime);
     void render();
+    void waitForEvent();
+    void wakeMainThread();
+    void limitFrameRate(Uint64 frameStart);
+    void recordFirstFrames();
+    void applyFileChanges();
+    void checkFrameAllocations(uint64_t allocations);
+    bool handleOverlayKey(const SDL_Event& event);
+    void renderHeapOverlay();
+    void renderFrameOverlay();
+    void reportHeapAtShutdown();
+    void enterTopState();
+    void exitTopState();
+    void retireTopState();
+    bool isRegisteredAs(const GameState* state, const std::string& name) const;
     
     // Window properties
     std::string m_windowTitle;
@@ -60,10 +206,71 @@ private:
     
     // Game state
     bool m_isRunning;
+    std::unique_ptr<JobSystem> m_jobs;
+    std::string m_packPath;
+    bool m_hotReload = true;
+    std::unique_ptr<FileWatcher> m_watcher;
+    std::shared_ptr<ResourcePack> m_pack;
+    std::unique_ptr<AssetCache> m_assets;
+    size_t m_assetBudget = 64 * 1024 * 1024;
+    Uint32 m_wakeEvent = 0;                 // Pushed to end an idle wait early
+    std::unique_ptr<FrameArena> m_frameArena;
+    std::unique_ptr<TextCache> m_textCache;
+    std::unique_ptr<FrameProfiler> m_profiler;
     std::stack<std::unique_ptr<GameState>> m_states;
     
+    // Registered states; an instance is parked here while not on the stack
+    struct RegisteredState {
+        std::function<std::unique_ptr<GameState>()> factory;
+        GameState* instance = nullptr;      // Once built, parked or not
+        std::unique_ptr<GameState> parked;
+    };
+    std::map<std::string, RegisteredState> m_registry;
+    std::multimap<std::string, StateHooks> m_stateHooks;   // "" = every state
+    
+    // Frame pacing
+    float m_updateStep = 1.0f / 60.0f;      // Seconds per fixed update
+    int m_frameCap = 60;
+    bool m_idleWhenStatic = true;
+    bool m_showFrameOverlay = false;
+    float m_interpolation = 0.0f;
+    float m_travelRate = 5.0f;
+    bool m_travelToggle = false;
+    
+    // Startup profiling
+    bool m_profileStartup = false;
+    bool m_firstFrameRecorded = false;
+    bool m_startupRecorded = false;
+    
+    // Frame allocation check
+    bool m_checkFrameAllocations = false;
+    int m_frameEvents = 0;                  // Events states handled this frame
+    uint64_t m_stateEntries = 0;            // States entered so far
+    uint64_t m_lastFrameEntries = 0;        // ...by the end of the last frame
+    bool m_lastFrameEntered = true;         // Last frame entered a state
+    uint64_t m_frameNumber = 0;
+    int m_steadyFrames = 0;
+    int m_allocatingFrames = 0;
+    
+    // Heap stats
+    std::string m_heapStatsPath = "heap_stats.txt";
+    bool m_showHeapOverlay = false;
+    HeapSnapshot m_heapLast;                // At the end of the last frame
+    HeapSnapshot m_heapFrame;               // Made during the last frame
+    
     // Game objects
     std::unique_ptr<Player> m_player;
+    
+    // Simulation data
+    std::shared_ptr<const TrailData> m_trail;
+    SimParams m_defaultParams;
+    std::map<std::string, SimParams> m_professionParams; // Calibrated overrides
+    std::string m_recordingDirectory = "recordings";
+    size_t m_rewindBudget = 0;
+    std::unique_ptr<AutosaveWriter> m_autosave;
+    std::unique_ptr<HighScoreTable> m_highScores;
+    std::unique_ptr<SaveSlots> m_saveSlots;
+    std::unique_ptr<TombstoneRegistry> m_tombstones;
 };
 
 #endif // GAME_HPP
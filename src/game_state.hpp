@@ -20,11 +20,28 @@ public:
     virtual void update(float deltaTime) = 0;
     virtual void render() = 0;
     
+    // True while the screen can change without any input (a simulation
+    // catching up, an animation playing). Otherwise the game loop sleeps
+    // until the next event.
+    virtual bool isAnimating() const { return false; }
+    
+    // True for a screen shown only while the game gets ready; startup is
+    // timed to the first frame of a state that is not one
+    virtual bool isLoadingScreen() const { return false; }
+    
     // Common utility methods
     virtual std::string getName() const = 0;
+    
+    // Expires when the state is destroyed. Background jobs post their
+    // results against it, so a result that arrives after the player has
+    // moved on is dropped rather than delivered to a dead state.
+    std::weak_ptr<void> getLifetime() const { return m_lifetime; }
 
 protected:
     Game* m_game; // Reference to the game object
+
+private:
+    std::shared_ptr<void> m_lifetime = std::make_shared<char>(0);
 };
 
 #endif // GAME_STATE_HPP
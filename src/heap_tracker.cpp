@@ -0,0 +1,264 @@
+#include "heap_tracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+
+namespace {
+
+const int SUBSYSTEM_COUNT = static_cast<int>(HeapSubsystem::Count);
+
+// In front of every block. Blocks made while tracking was off are marked
+// so freeing them is not counted either.
+struct BlockHeader {
+    uint64_t size;
+    uint32_t subsystem;
+    uint32_t offset;        // From the start of the allocation to the block
+};
+static_assert(sizeof(BlockHeader) == 16, "header must keep malloc's 16-byte alignment");
+
+const uint32_t UNTRACKED = 0xffffffff;
+
+struct Counters {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<int64_t> liveBlocks{0};
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakLiveBytes{0};
+};
+
+// Constant-initialized, so usable by allocations made before main()
+Counters counters[SUBSYSTEM_COUNT];
+std::atomic<int64_t> totalLiveBytes{0};
+std::atomic<int64_t> totalPeakLiveBytes{0};
+std::atomic<bool> tracking{false};
+
+thread_local uint64_t allocations = 0;
+thread_local HeapSubsystem currentSubsystem = HeapSubsystem::Other;
+
+#ifdef HEAP_TRACKING
+
+void raisePeak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+void* track(void* start, uint32_t offset, std::size_t size) {
+    char* block = static_cast<char*>(start) + offset;
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block) - 1;
+    header->size = size;
+    header->offset = offset;
+    header->subsystem = UNTRACKED;
+
+    if (tracking.load(std::memory_order_relaxed)) {
+        int index = static_cast<int>(currentSubsystem);
+        header->subsystem = static_cast<uint32_t>(index);
+        Counters& counter = counters[index];
+        int64_t bytes = static_cast<int64_t>(size);
+        counter.calls.fetch_add(1, std::memory_order_relaxed);
+        counter.bytes.fetch_add(size, std::memory_order_relaxed);
+        counter.liveBlocks.fetch_add(1, std::memory_order_relaxed);
+        raisePeak(counter.peakLiveBytes, counter.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+        raisePeak(totalPeakLiveBytes, totalLiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    }
+    return block;
+}
+
+// The start of the allocation the block is in
+void* untrack(void* block) {
+    BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+    if (header->subsystem != UNTRACKED) {
+        Counters& counter = counters[header->subsystem];
+        int64_t bytes = static_cast<int64_t>(header->size);
+        counter.liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+        counter.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        totalLiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    return static_cast<char*>(block) - header->offset;
+}
+
+void* allocate(std::size_t size) {
+    ++allocations;
+    void* start = std::malloc(size + sizeof(BlockHeader));
+    if (!start) {
+        throw std::bad_alloc();
+    }
+    return track(start, sizeof(BlockHeader), size);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    ++allocations;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    // The header goes in a prefix of a whole alignment, so the block stays
+    // aligned; aligned_alloc wants a multiple of the alignment
+    std::size_t prefix = std::max(align, sizeof(BlockHeader));
+    void* start = std::aligned_alloc(align, (size + prefix + align - 1) / align * align);
+    if (!start) {
+        throw std::bad_alloc();
+    }
+    return track(start, static_cast<uint32_t>(prefix), size);
+}
+
+void release(void* block) {
+    if (block) {
+        std::free(untrack(block));
+    }
+}
+
+#else
+
+// Counting only: no header, and the block is malloc's own
+void* allocate(std::size_t size) {
+    ++allocations;
+    void* block = std::malloc(std::max<std::size_t>(size, 1));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    ++allocations;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    void* block = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void release(void* block) {
+    std::free(block);
+}
+
+#endif // HEAP_TRACKING
+
+const char* const SUBSYSTEM_NAMES[SUBSYSTEM_COUNT] = {"other", "render", "sim", "assets", "states"};
+
+} // namespace
+
+uint64_t threadHeapAllocations() {
+    return allocations;
+}
+
+const char* heapSubsystemName(HeapSubsystem subsystem) {
+    int index = static_cast<int>(subsystem);
+    return index >= 0 && index < SUBSYSTEM_COUNT ? SUBSYSTEM_NAMES[index] : "?";
+}
+
+HeapScope::HeapScope(HeapSubsystem subsystem)
+    : m_previous(currentSubsystem)
+{
+    currentSubsystem = subsystem;
+}
+
+HeapScope::~HeapScope() {
+    currentSubsystem = m_previous;
+}
+
+bool enableHeapTracking() {
+#ifdef HEAP_TRACKING
+    tracking.store(true);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool isHeapTracking() {
+    return tracking.load();
+}
+
+HeapSnapshot getHeapSnapshot() {
+    HeapSnapshot snapshot;
+    for (int i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        HeapCounters& out = snapshot.subsystems[i];
+        out.calls = counters[i].calls.load(std::memory_order_relaxed);
+        out.bytes = counters[i].bytes.load(std::memory_order_relaxed);
+        out.liveBlocks = counters[i].liveBlocks.load(std::memory_order_relaxed);
+        out.liveBytes = counters[i].liveBytes.load(std::memory_order_relaxed);
+        out.peakLiveBytes = counters[i].peakLiveBytes.load(std::memory_order_relaxed);
+    }
+    snapshot.peakLiveBytes = totalPeakLiveBytes.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+HeapSnapshot heapDifference(const HeapSnapshot& later, const HeapSnapshot& earlier) {
+    HeapSnapshot difference = later;
+    for (int i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        difference.subsystems[i].calls -= earlier.subsystems[i].calls;
+        difference.subsystems[i].bytes -= earlier.subsystems[i].bytes;
+    }
+    return difference;
+}
+
+void printHeapStats(std::ostream& out, const HeapSnapshot& current, const HeapSnapshot* frame) {
+    out << std::left << std::setw(8) << "heap" << std::right
+        << std::setw(12) << "calls" << std::setw(14) << "bytes";
+    if (frame) {
+        out << std::setw(13) << "calls/frame" << std::setw(13) << "bytes/frame";
+    }
+    out << std::setw(12) << "live" << std::setw(9) << "blocks" << std::setw(12) << "peak" << "\n";
+
+    HeapCounters total;
+    for (int i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        const HeapCounters& counter = current.subsystems[i];
+        out << std::left << std::setw(8) << SUBSYSTEM_NAMES[i] << std::right
+            << std::setw(12) << counter.calls << std::setw(14) << counter.bytes;
+        if (frame) {
+            out << std::setw(13) << frame->subsystems[i].calls << std::setw(13) << frame->subsystems[i].bytes;
+        }
+        out << std::setw(12) << counter.liveBytes << std::setw(9) << counter.liveBlocks
+            << std::setw(12) << counter.peakLiveBytes << "\n";
+        total.calls += counter.calls;
+        total.bytes += counter.bytes;
+        total.liveBytes += counter.liveBytes;
+        total.liveBlocks += counter.liveBlocks;
+    }
+    // The total's peak is when everything together was highest, not the
+    // sum of each subsystem's own peak
+    out << std::left << std::setw(8) << "all" << std::right
+        << std::setw(12) << total.calls << std::setw(14) << total.bytes;
+    if (frame) {
+        out << std::setw(26) << "";
+    }
+    out << std::setw(12) << total.liveBytes << std::setw(9) << total.liveBlocks
+        << std::setw(12) << current.peakLiveBytes << std::endl;
+}
+
+bool dumpHeapStats(const std::string& path, const HeapSnapshot& current, const HeapSnapshot* frame) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    printHeapStats(out, current, frame);
+    return static_cast<bool>(out);
+}
+
+// The array and nothrow forms of new call these
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept {
+    release(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    release(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    release(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    release(memory);
+}
@@ -0,0 +1,86 @@
+#ifndef HEAP_TRACKER_HPP
+#define HEAP_TRACKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// The game replaces the global operator new to count heap allocations.
+//
+// Every allocation is counted per thread (one thread-local increment), which
+// the frame allocation check reads. Nothing else is added to an allocation
+// unless the game is built with HEAP_TRACKING (make HEAP_TRACKING=1).
+//
+// In such a build, counting by subsystem can be turned on (enableHeapTracking(),
+// --heap-stats): each allocation is then charged to the subsystem of the
+// innermost HeapScope on its thread, and bytes, calls, live memory and its
+// high-water mark are kept per subsystem. Every block, tracked or not, carries
+// a 16-byte header so a free can be charged back to the subsystem that made
+// it, which costs memory and a little time on every allocation.
+
+// Allocations made through operator new on the calling thread so far
+uint64_t threadHeapAllocations();
+
+enum class HeapSubsystem {
+    Other,      // Anything outside a scope: startup, stores, job plumbing
+    Render,     // Drawing frames
+    Sim,        // The simulation thread
+    Assets,     // Decoding and caching fonts, images, sounds and text
+    States,     // Input, state updates and transitions
+    Count
+};
+
+const char* heapSubsystemName(HeapSubsystem subsystem);
+
+// Charges allocations on this thread to a subsystem until destroyed.
+// Scopes nest; the innermost wins.
+class HeapScope {
+public:
+    explicit HeapScope(HeapSubsystem subsystem);
+    ~HeapScope();
+
+    HeapScope(const HeapScope&) = delete;
+    HeapScope& operator=(const HeapScope&) = delete;
+
+private:
+    HeapSubsystem m_previous;
+};
+
+// From here on, count allocations by subsystem. Cannot be turned off;
+// blocks allocated before are not counted, and neither is freeing them.
+// Returns false, doing nothing, if built without HEAP_TRACKING.
+bool enableHeapTracking();
+bool isHeapTracking();
+
+struct HeapCounters {
+    uint64_t calls = 0;         // Allocations so far
+    uint64_t bytes = 0;         // Bytes allocated so far
+    int64_t liveBlocks = 0;     // Allocated and not yet freed
+    int64_t liveBytes = 0;
+    int64_t peakLiveBytes = 0;  // High-water mark of liveBytes
+};
+
+struct HeapSnapshot {
+    HeapCounters subsystems[static_cast<int>(HeapSubsystem::Count)];
+    int64_t peakLiveBytes = 0;  // High-water mark of all subsystems together
+
+    const HeapCounters& operator[](HeapSubsystem subsystem) const {
+        return subsystems[static_cast<int>(subsystem)];
+    }
+};
+
+HeapSnapshot getHeapSnapshot();
+
+// Table of every subsystem: calls and bytes in the last frame (frame may
+// be null), live bytes and blocks, and high-water marks
+void printHeapStats(std::ostream& out, const HeapSnapshot& current, const HeapSnapshot* frame);
+
+// The same table written to a file. Returns false if it cannot be written.
+bool dumpHeapStats(const std::string& path, const HeapSnapshot& current, const HeapSnapshot* frame);
+
+// Calls and bytes made between two snapshots (live counts are taken from
+// later)
+HeapSnapshot heapDifference(const HeapSnapshot& later, const HeapSnapshot& earlier);
+
+#endif // HEAP_TRACKER_HPP
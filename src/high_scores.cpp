@@ -0,0 +1,324 @@
+#include "high_scores.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Log record layout (little-endian):
+//    0 u32 magic          4 i32 score          8 i64 timestamp
+//   16 u64 seed          24 i32 days          28 i32 survivors
+//   32 char[24] profession (NUL padded)       56 u32 reserved
+//   60 u32 checksum of bytes 0-59
+const size_t RECORD_SIZE = 64;
+const size_t PROFESSION_SIZE = 24;
+const uint32_t RECORD_MAGIC = 0x5348544f; // "OTHS"
+
+// Index layout: "OTTOP001", u64 log bytes covered, u32 count, u32 capacity,
+// u32 reserved, u32 checksum of everything else; then count records
+const size_t INDEX_HEADER_SIZE = 32;
+const char INDEX_MAGIC[8] = {'O', 'T', 'T', 'O', 'P', '0', '0', '1'};
+
+// Log bytes read per pread() when catching up
+const size_t CATCH_UP_CHUNK = 64 * 1024;
+
+uint32_t checksum(const uint8_t* data, size_t size, uint32_t hash = 2166136261u) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void putValue(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t getValue(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+void encodeRecord(const HighScoreEntry& entry, uint8_t* record) {
+    std::memset(record, 0, RECORD_SIZE);
+    putValue(record, RECORD_MAGIC, 4);
+    putValue(record + 4, static_cast<uint32_t>(entry.score), 4);
+    putValue(record + 8, static_cast<uint64_t>(entry.timestamp), 8);
+    putValue(record + 16, entry.seed, 8);
+    putValue(record + 24, static_cast<uint32_t>(entry.daysElapsed), 4);
+    putValue(record + 28, static_cast<uint32_t>(entry.survivors), 4);
+    std::memcpy(record + 32, entry.profession.data(), std::min(entry.profession.size(), PROFESSION_SIZE - 1));
+    putValue(record + 60, checksum(record, RECORD_SIZE - 4), 4);
+}
+
+bool decodeRecord(const uint8_t* record, HighScoreEntry& entry) {
+    if (getValue(record, 4) != RECORD_MAGIC ||
+        getValue(record + 60, 4) != checksum(record, RECORD_SIZE - 4)) {
+        return false;
+    }
+    entry.score = static_cast<int32_t>(getValue(record + 4, 4));
+    entry.timestamp = static_cast<int64_t>(getValue(record + 8, 8));
+    entry.seed = getValue(record + 16, 8);
+    entry.daysElapsed = static_cast<int32_t>(getValue(record + 24, 4));
+    entry.survivors = static_cast<int32_t>(getValue(record + 28, 4));
+    const char* profession = reinterpret_cast<const char*>(record + 32);
+    entry.profession.assign(profession, strnlen(profession, PROFESSION_SIZE));
+    return true;
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Exclusive lock on the log for the lifetime of the object
+class LogLock {
+public:
+    explicit LogLock(const std::string& path) {
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (m_fd >= 0 && ::flock(m_fd, LOCK_EX) != 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+    ~LogLock() {
+        if (m_fd >= 0) {
+            ::flock(m_fd, LOCK_UN);
+            ::close(m_fd);
+        }
+    }
+    LogLock(const LogLock&) = delete;
+    LogLock& operator=(const LogLock&) = delete;
+
+    int getFd() const { return m_fd; }
+
+private:
+    int m_fd = -1;
+};
+
+} // namespace
+
+HighScoreEntry makeHighScoreEntry(const Journey& journey) {
+    HighScoreEntry entry;
+    entry.score = journey.getScore().total;
+    entry.timestamp = static_cast<int64_t>(std::time(nullptr));
+    entry.seed = journey.getSeed();
+    entry.profession = journey.getProfession();
+    entry.daysElapsed = journey.getDaysElapsed();
+    entry.survivors = journey.getAliveCount();
+    return entry;
+}
+
+HighScoreTable::HighScoreTable(const std::string& directory, size_t capacity)
+    : m_directory(directory)
+    , m_logPath(directory + "/scores.log")
+    , m_indexPath(directory + "/top.idx")
+    , m_capacity(std::max<size_t>(capacity, 1))
+{
+}
+
+int HighScoreTable::submit(const HighScoreEntry& entry) {
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    LogLock lock(m_logPath);
+    if (lock.getFd() < 0) {
+        std::cerr << "Unable to open high score log " << m_logPath << ": " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    std::vector<HighScoreEntry> top;
+    uint64_t covered = 0;
+    if (!readIndex(top, covered)) {
+        top.clear();
+        covered = 0;
+    }
+    if (!catchUp(lock.getFd(), top, covered)) {
+        return -1;
+    }
+
+    uint8_t record[RECORD_SIZE];
+    encodeRecord(entry, record);
+    if (!writeAll(lock.getFd(), record, RECORD_SIZE) || ::fdatasync(lock.getFd()) != 0) {
+        std::cerr << "Unable to append to high score log: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    covered += RECORD_SIZE;
+
+    int rank = insert(top, entry);
+    if (!writeIndex(top, covered)) {
+        // The log has it; the next reader rebuilds the index
+        std::cerr << "Unable to update high score index " << m_indexPath << std::endl;
+    }
+    return rank;
+}
+
+std::vector<HighScoreEntry> HighScoreTable::getTop(size_t count) {
+    std::vector<HighScoreEntry> top;
+    uint64_t covered = 0;
+    bool indexed = readIndex(top, covered);
+
+    struct stat logInfo;
+    if (::stat(m_logPath.c_str(), &logInfo) != 0) {
+        return std::vector<HighScoreEntry>(); // Nothing recorded yet
+    }
+    uint64_t logRecords = static_cast<uint64_t>(logInfo.st_size) / RECORD_SIZE * RECORD_SIZE;
+
+    if (!indexed || covered != logRecords) {
+        // Stale or missing index: fold in the rest of the log and save it
+        LogLock lock(m_logPath);
+        if (lock.getFd() < 0) {
+            return std::vector<HighScoreEntry>();
+        }
+        if (!readIndex(top, covered)) {
+            std::cout << "Rebuilding high score index from " << m_logPath << std::endl;
+            top.clear();
+            covered = 0;
+        }
+        if (catchUp(lock.getFd(), top, covered)) {
+            writeIndex(top, covered);
+        }
+    }
+
+    if (top.size() > count) {
+        top.resize(count);
+    }
+    return top;
+}
+
+bool HighScoreTable::readIndex(std::vector<HighScoreEntry>& top, uint64_t& covered) const {
+    FILE* file = std::fopen(m_indexPath.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> data(INDEX_HEADER_SIZE + m_capacity * RECORD_SIZE + 1);
+    size_t size = std::fread(data.data(), 1, data.size(), file);
+    std::fclose(file);
+
+    if (size < INDEX_HEADER_SIZE || std::memcmp(data.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        return false;
+    }
+    size_t count = getValue(data.data() + 16, 4);
+    size_t capacity = getValue(data.data() + 20, 4);
+    if (capacity != m_capacity || count > capacity || size != INDEX_HEADER_SIZE + count * RECORD_SIZE) {
+        return false;
+    }
+    uint32_t expected = checksum(data.data(), 28);
+    expected = checksum(data.data() + INDEX_HEADER_SIZE, count * RECORD_SIZE, expected);
+    if (getValue(data.data() + 28, 4) != expected) {
+        return false;
+    }
+
+    top.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (!decodeRecord(data.data() + INDEX_HEADER_SIZE + i * RECORD_SIZE, top[i])) {
+            return false;
+        }
+    }
+    covered = getValue(data.data() + 8, 8);
+    return true;
+}
+
+bool HighScoreTable::writeIndex(const std::vector<HighScoreEntry>& top, uint64_t covered) const {
+    std::vector<uint8_t> data(INDEX_HEADER_SIZE + top.size() * RECORD_SIZE, 0);
+    std::memcpy(data.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    putValue(data.data() + 8, covered, 8);
+    putValue(data.data() + 16, top.size(), 4);
+    putValue(data.data() + 20, m_capacity, 4);
+    for (size_t i = 0; i < top.size(); ++i) {
+        encodeRecord(top[i], data.data() + INDEX_HEADER_SIZE + i * RECORD_SIZE);
+    }
+    uint32_t sum = checksum(data.data(), 28);
+    sum = checksum(data.data() + INDEX_HEADER_SIZE, top.size() * RECORD_SIZE, sum);
+    putValue(data.data() + 28, sum, 4);
+
+    // Readers never see a half-written index
+    std::string temporaryPath = m_indexPath + ".tmp." + std::to_string(::getpid());
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool written = writeAll(fd, data.data(), data.size());
+    ::close(fd);
+    if (!written || std::rename(temporaryPath.c_str(), m_indexPath.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool HighScoreTable::catchUp(int logFd, std::vector<HighScoreEntry>& top, uint64_t& covered) const {
+    struct stat logInfo;
+    if (::fstat(logFd, &logInfo) != 0) {
+        return false;
+    }
+    uint64_t size = static_cast<uint64_t>(logInfo.st_size);
+
+    // A writer died mid-record; we hold the lock, so nobody is still writing it
+    if (size % RECORD_SIZE != 0) {
+        size -= size % RECORD_SIZE;
+        if (::ftruncate(logFd, static_cast<off_t>(size)) != 0) {
+            return false;
+        }
+    }
+    if (covered > size) {
+        // The log was replaced; start over
+        top.clear();
+        covered = 0;
+    }
+
+    std::vector<uint8_t> chunk(CATCH_UP_CHUNK);
+    while (covered < size) {
+        size_t want = static_cast<size_t>(std::min<uint64_t>(chunk.size(), size - covered));
+        ssize_t got = ::pread(logFd, chunk.data(), want, static_cast<off_t>(covered));
+        if (got <= 0) {
+            return false;
+        }
+        size_t records = static_cast<size_t>(got) / RECORD_SIZE;
+        for (size_t i = 0; i < records; ++i) {
+            HighScoreEntry entry;
+            if (decodeRecord(chunk.data() + i * RECORD_SIZE, entry)) {
+                insert(top, entry);
+            }
+        }
+        covered += records * RECORD_SIZE;
+    }
+    return true;
+}
+
+int HighScoreTable::insert(std::vector<HighScoreEntry>& top, const HighScoreEntry& entry) const {
+    // After every equal score, so earlier entries keep their place
+    auto position = std::upper_bound(top.begin(), top.end(), entry,
+        [](const HighScoreEntry& a, const HighScoreEntry& b) { return a.score > b.score; });
+    size_t rank = static_cast<size_t>(position - top.begin());
+    if (rank >= m_capacity) {
+        return 0;
+    }
+    top.insert(position, entry);
+    if (top.size() > m_capacity) {
+        top.pop_back();
+    }
+    return static_cast<int>(rank + 1);
+}
@@ -0,0 +1,66 @@
+#ifndef HIGH_SCORES_HPP
+#define HIGH_SCORES_HPP
+
+#include "journey.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One finished journey on the high-score table
+struct HighScoreEntry {
+    int score = 0;
+    int64_t timestamp = 0;          // Seconds since the epoch
+    uint64_t seed = 0;
+    std::string profession;
+    int daysElapsed = 0;
+    int survivors = 0;
+};
+
+HighScoreEntry makeHighScoreEntry(const Journey& journey);
+
+const size_t DEFAULT_HIGH_SCORE_CAPACITY = 100;
+
+// Every score ever recorded, plus the best ones kept ready to show.
+//
+//   scores.log   append-only, fixed 64-byte checksummed records
+//   top.idx      the best `capacity` records, sorted, and how many bytes of
+//                the log they cover. Replaced atomically (tmp + rename).
+//
+// Writers take an exclusive flock() on the log, so any number of game
+// processes on one machine can submit at once. The index is read without a
+// lock, so opening the table costs the same however long the log gets; if
+// a writer died between appending and updating the index, the next reader
+// or writer folds the missing tail in. A missing or damaged index is
+// rebuilt from the log.
+class HighScoreTable {
+public:
+    explicit HighScoreTable(const std::string& directory,
+                            size_t capacity = DEFAULT_HIGH_SCORE_CAPACITY);
+
+    // Records a score. Returns its rank on the table (1 = best), 0 if it
+    // did not make the table, or -1 if it could not be saved.
+    int submit(const HighScoreEntry& entry);
+
+    // The best scores, highest first
+    std::vector<HighScoreEntry> getTop(size_t count);
+
+    const std::string& getDirectory() const { return m_directory; }
+
+private:
+    bool readIndex(std::vector<HighScoreEntry>& top, uint64_t& covered) const;
+    bool writeIndex(const std::vector<HighScoreEntry>& top, uint64_t covered) const;
+
+    // With the log locked: fold log records past `covered` into top
+    bool catchUp(int logFd, std::vector<HighScoreEntry>& top, uint64_t& covered) const;
+
+    // Inserts in rank order and trims to capacity; the entry's rank or 0
+    int insert(std::vector<HighScoreEntry>& top, const HighScoreEntry& entry) const;
+
+    std::string m_directory;
+    std::string m_logPath;
+    std::string m_indexPath;
+    size_t m_capacity;
+};
+
+#endif // HIGH_SCORES_HPP
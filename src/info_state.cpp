@@ -1,15 +1,43 @@
 #include "info_state.hpp"
 #include "game.hpp"
+#include "asset_cache.hpp"
 #include "menu_state.hpp"
+#include "frame_profiler.hpp"
+#include "text_cache.hpp"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 
+void buildInfoText(const std::string& title, const std::vector<std::string>& lines, int scrollOffset,
+                   int windowHeight, ScreenText& text) {
+    text.addCentered(title.c_str(), 50);
+    
+    // Content with scrolling
+    int y = 100;
+    int visibleLines = (windowHeight - 150) / 20; // Approximate lines that can fit
+    
+    for (int i = scrollOffset; 
+         i < scrollOffset + visibleLines && i < static_cast<int>(lines.size()); 
+         ++i) {
+        text.add(lines[i].c_str(), 50, y);
+        y += 20;
+    }
+    
+    text.addCentered("Press ESC to return to menu, Up/Down to scroll", windowHeight - 30);
+    
+    // Scroll indicators if needed
+    if (scrollOffset > 0) {
+        text.addCentered("▲", 85);
+    }
+    if (scrollOffset + visibleLines < static_cast<int>(lines.size())) {
+        text.addCentered("▼", windowHeight - 65);
+    }
+}
+
 InfoState::InfoState(Game* game, const std::string& title, const std::string& content)
     : GameState(game)
     , m_title(title)
     , m_rawContent(content)
-    , m_font(nullptr)
     , m_scrollOffset(0)
 {
     // Set Apple II style green text color
@@ -22,45 +50,14 @@ InfoState::InfoState(Game* game, const std::string& title, const std::string& co
 }
 
 InfoState::~InfoState() {
-    if (m_font) {
-        TTF_CloseFont(m_font);
-        m_font = nullptr;
-    }
 }
 
 void InfoState::enter() {
     std::cout << "Entering InfoState: " << m_title << std::endl;
     
-    // Load font if not already loaded
+    // Shared with every other state; only the first one to ask loads it
     if (!m_font) {
-        std::cout << "Attempting to load font for InfoState" << std::endl;
-        m_font = TTF_OpenFont("assets/fonts/apple2.ttf", 16);
-        if (!m_font) {
-            std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
-            
-            // Try fallback fonts
-            const char* fallbackFonts[] = {
-                "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
-                "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
-                "/usr/share/fonts/truetype/liberation/LiberationMono-Regular.ttf",
-                nullptr
-            };
-            
-            for (int i = 0; fallbackFonts[i] != nullptr; i++) {
-                std::cout << "Trying fallback font: " << fallbackFonts[i] << std::endl;
-                m_font = TTF_OpenFont(fallbackFonts[i], 16);
-                if (m_font) {
-                    std::cout << "Successfully loaded fallback font: " << fallbackFonts[i] << std::endl;
-                    break;
-                }
-            }
-            
-            if (!m_font) {
-                std::cerr << "Failed to load any fallback font: " << TTF_GetError() << std::endl;
-            }
-        } else {
-            std::cout << "Successfully loaded font for InfoState" << std::endl;
-        }
+        m_font = m_game->getAssets()->getDefaultFont(16);
     }
     
     // Reset scroll position
@@ -74,8 +71,7 @@ void InfoState::exit() {
 // Helper method to return to the menu state
 void InfoState::returnToMenu() {
     std::cout << "Returning to menu" << std::endl;
-    auto menuState = std::make_unique<MenuState>(m_game);
-    m_game->changeState(std::move(menuState));
+    m_game->changeState(MENU_STATE_NAME);
 }
 
 void InfoState::handleEvent(const SDL_Event& event) {
@@ -144,99 +140,17 @@ void InfoState::render() {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
     
-    // Render title
-    renderTextCentered(m_title, 50);
-    
-    // Render horizontal line under title
+    // Horizontal lines under the title and above the instructions
     SDL_SetRenderDrawColor(renderer, 144, 238, 144, 255); // Light green
+    countDrawCall();
     SDL_RenderDrawLine(renderer, 50, 80, m_game->getWindowWidth() - 50, 80);
-    
-    // Render content with scrolling
-    int y = 100;
-    int visibleLines = (m_game->getWindowHeight() - 150) / 20; // Approximate lines that can fit
-    
-    for (int i = m_scrollOffset; 
-         i < m_scrollOffset + visibleLines && i < static_cast<int>(m_contentLines.size()); 
-         ++i) {
-        renderText(m_contentLines[i], 50, y);
-        y += 20;
-    }
-    
-    // Render instruction text at bottom
-    SDL_SetRenderDrawColor(renderer, 144, 238, 144, 255); // Light green
+    countDrawCall();
     SDL_RenderDrawLine(renderer, 50, m_game->getWindowHeight() - 50, 
                       m_game->getWindowWidth() - 50, m_game->getWindowHeight() - 50);
-    renderTextCentered("Press ESC to return to menu, Up/Down to scroll", 
-                      m_game->getWindowHeight() - 30);
-    
-    // Render scroll indicators if needed
-    if (m_scrollOffset > 0) {
-        renderTextCentered("▲", 85);
-    }
-    if (m_scrollOffset + visibleLines < static_cast<int>(m_contentLines.size())) {
-        renderTextCentered("▼", m_game->getWindowHeight() - 65);
-    }
-}
-
-void InfoState::renderText(const std::string& text, int x, int y) {
-    if (text.empty()) {
-        return;
-    }
-    
-    if (!m_font) {
-        std::cerr << "Cannot render text: font not loaded" << std::endl;
-        return;
-    }
-    
-    SDL_Surface* textSurface = TTF_RenderText_Solid(m_font, text.c_str(), m_textColor);
-    if (!textSurface) {
-        std::cerr << "Unable to render text surface: " << TTF_GetError() << std::endl;
-        return;
-    }
-    
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(m_game->getRenderer(), textSurface);
-    if (!textTexture) {
-        std::cerr << "Unable to create texture from rendered text: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(textSurface);
-        return;
-    }
-    
-    SDL_Rect renderQuad = { x, y, textSurface->w, textSurface->h };
-    SDL_RenderCopy(m_game->getRenderer(), textTexture, nullptr, &renderQuad);
-    
-    SDL_FreeSurface(textSurface);
-    SDL_DestroyTexture(textTexture);
-}
-
-void InfoState::renderTextCentered(const std::string& text, int y) {
-    if (text.empty()) {
-        return;
-    }
-    
-    if (!m_font) {
-        std::cerr << "Cannot render centered text: font not loaded" << std::endl;
-        return;
-    }
-    
-    SDL_Surface* textSurface = TTF_RenderText_Solid(m_font, text.c_str(), m_textColor);
-    if (!textSurface) {
-        std::cerr << "Unable to render text surface: " << TTF_GetError() << std::endl;
-        return;
-    }
-    
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(m_game->getRenderer(), textSurface);
-    if (!textTexture) {
-        std::cerr << "Unable to create texture from rendered text: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(textSurface);
-        return;
-    }
-    
-    int x = (m_game->getWindowWidth() - textSurface->w) / 2;
-    SDL_Rect renderQuad = { x, y, textSurface->w, textSurface->h };
-    SDL_RenderCopy(m_game->getRenderer(), textTexture, nullptr, &renderQuad);
     
-    SDL_FreeSurface(textSurface);
-    SDL_DestroyTexture(textTexture);
+    ScreenText text;
+    buildInfoText(m_title, m_contentLines, m_scrollOffset, m_game->getWindowHeight(), text);
+    m_game->getTextCache()->draw(m_font, m_textColor, text, m_game->getWindowWidth());
 }
 
 void InfoState::processContent() {
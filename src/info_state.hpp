@@ -2,13 +2,20 @@
 #define INFO_STATE_HPP
 
 #include "game_state.hpp"
+#include "screen_text.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <memory>
 #include <string>
 #include <vector>
 
 class Game;
 
+// The text of an info screen for one frame, its content scrolled down by
+// scrollOffset lines
+void buildInfoText(const std::string& title, const std::vector<std::string>& lines, int scrollOffset,
+                   int windowHeight, ScreenText& text);
+
 class InfoState : public GameState {
 public:
     InfoState(Game* game, const std::string& title, const std::string& content);
@@ -23,12 +30,6 @@ public:
     virtual std::string getName() const override { return "InfoState"; }
     
 private:
-    // Render text at specified position
-    void renderText(const std::string& text, int x, int y);
-    
-    // Render text centered horizontally at specified y position
-    void renderTextCentered(const std::string& text, int y);
-    
     // Split content into lines for display
     void processContent();
     
@@ -39,7 +40,7 @@ private:
     std::string m_title;
     std::string m_rawContent;
     std::vector<std::string> m_contentLines;
-    TTF_Font* m_font;
+    std::shared_ptr<TTF_Font> m_font;
     SDL_Color m_textColor;
     int m_scrollOffset;
 };
@@ -0,0 +1,123 @@
+#include "job_system.hpp"
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// How long a joining thread with nothing to help with sleeps before
+// looking for queued jobs again
+const auto JOIN_POLL_INTERVAL = std::chrono::milliseconds(1);
+
+} // namespace
+
+JobGroup::JobGroup()
+    : m_state(std::make_shared<State>())
+{
+}
+
+JobSystem::JobSystem(unsigned threads, std::function<void()> wakeMainThread)
+    : m_pool(threads)
+    , m_wakeMainThread(std::move(wakeMainThread))
+{
+    std::cout << "Job system started with " << m_pool.getWorkerCount() << " workers" << std::endl;
+}
+
+JobSystem::~JobSystem() {
+    m_pool.wait();
+}
+
+void JobSystem::run(std::function<void()> job) {
+    m_pool.submit(std::move(job));
+}
+
+void JobSystem::run(JobGroup group, std::function<void()> job) {
+    std::shared_ptr<JobGroup::State> state = group.m_state;
+    state->pending++;
+    m_pool.submit([this, state, job = std::move(job)] {
+        job();
+        finishJob(state);
+    });
+}
+
+void JobSystem::finishJob(const std::shared_ptr<JobGroup::State>& group) {
+    if (--group->pending != 0) {
+        return;
+    }
+    std::vector<std::function<void()>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        continuations.swap(group->continuations);
+        group->finished.notify_all();
+    }
+    for (auto& continuation : continuations) {
+        m_pool.submit(std::move(continuation));
+    }
+}
+
+void JobSystem::wait(const JobGroup& group) {
+    JobGroup::State& state = *group.m_state;
+    while (state.pending.load() > 0) {
+        if (m_pool.runPendingTask()) {
+            continue;
+        }
+        // Everything left is running on other threads
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.finished.wait_for(lock, JOIN_POLL_INTERVAL, [&state] { return state.pending.load() == 0; });
+    }
+}
+
+void JobSystem::then(JobGroup group, std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(group.m_state->mutex);
+        if (group.m_state->pending.load() > 0) {
+            group.m_state->continuations.push_back(std::move(job));
+            return;
+        }
+    }
+    m_pool.submit(std::move(job));
+}
+
+void JobSystem::post(std::function<void()> completion) {
+    {
+        std::lock_guard<std::mutex> lock(m_completionMutex);
+        m_completions.push_back(Completion{std::weak_ptr<void>(), false, std::move(completion)});
+    }
+    if (m_wakeMainThread) {
+        m_wakeMainThread();
+    }
+}
+
+void JobSystem::post(std::weak_ptr<void> receiver, std::function<void()> completion) {
+    {
+        std::lock_guard<std::mutex> lock(m_completionMutex);
+        m_completions.push_back(Completion{std::move(receiver), true, std::move(completion)});
+    }
+    if (m_wakeMainThread) {
+        m_wakeMainThread();
+    }
+}
+
+size_t JobSystem::runCompletions() {
+    {
+        std::lock_guard<std::mutex> lock(m_completionMutex);
+        if (m_completions.empty()) {
+            return 0;
+        }
+        m_running.swap(m_completions);
+    }
+
+    // Posted by jobs while these run, they wait for the next frame
+    size_t count = 0;
+    for (Completion& completion : m_running) {
+        if (completion.hasReceiver) {
+            std::shared_ptr<void> receiver = completion.receiver.lock();
+            if (!receiver) {
+                continue;
+            }
+        }
+        completion.function();
+        ++count;
+    }
+    m_running.clear();
+    return count;
+}
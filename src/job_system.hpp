@@ -0,0 +1,98 @@
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include "work_pool.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// A set of jobs that can be waited on together, or followed by
+// continuations once all of them (and any jobs they add to the group)
+// have finished. Copies refer to the same group, so jobs can add more
+// jobs to the group they belong to.
+class JobGroup {
+public:
+    JobGroup();
+
+    // Jobs in the group that have not finished yet
+    int getPending() const { return m_state->pending.load(); }
+    bool isDone() const { return getPending() == 0; }
+
+private:
+    friend class JobSystem;
+
+    struct State {
+        std::atomic<int> pending{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::vector<std::function<void()>> continuations;
+    };
+
+    std::shared_ptr<State> m_state;
+};
+
+// The engine's background workers: a WorkStealingPool sized to the
+// machine, plus fork/join groups, continuations, and a queue of results
+// to hand back to the main thread between frames.
+//
+// Jobs run on worker threads and must not touch SDL or any GameState.
+// Whatever they produce for the game goes back through post(), and runs
+// on the main thread at the start of the next frame.
+class JobSystem {
+public:
+    // wakeMainThread is called (from any thread) when something is posted,
+    // so a main loop sleeping on events can wake up to deliver it
+    explicit JobSystem(unsigned threads = 0, std::function<void()> wakeMainThread = nullptr);
+    ~JobSystem();   // Finishes every queued job first
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned getWorkerCount() const { return m_pool.getWorkerCount(); }
+
+    // Fire and forget
+    void run(std::function<void()> job);
+
+    // Fork: add a job to a group
+    void run(JobGroup group, std::function<void()> job);
+
+    // Join: block until every job in the group has finished. The waiting
+    // thread runs queued jobs meanwhile, so jobs may wait on groups of
+    // their own without tying up the pool.
+    void wait(const JobGroup& group);
+
+    // Run job once every job in the group has finished (right away if it
+    // already has). Add continuations before the group can run dry, or
+    // they may fire between two batches of its jobs.
+    void then(JobGroup group, std::function<void()> job);
+
+    // Main thread delivery. A completion posted with a receiver is dropped
+    // if the receiver is gone by the time it would run.
+    void post(std::function<void()> completion);
+    void post(std::weak_ptr<void> receiver, std::function<void()> completion);
+
+    // Called by the main thread between frames; returns how many ran
+    size_t runCompletions();
+
+private:
+    struct Completion {
+        std::weak_ptr<void> receiver;
+        bool hasReceiver = false;
+        std::function<void()> function;
+    };
+
+    void finishJob(const std::shared_ptr<JobGroup::State>& group);
+
+    WorkStealingPool m_pool;
+    std::function<void()> m_wakeMainThread;
+
+    std::mutex m_completionMutex;
+    std::vector<Completion> m_completions;
+    std::vector<Completion> m_running;       // Main thread only
+};
+
+#endif // JOB_SYSTEM_HPP
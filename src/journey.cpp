@@ -0,0 +1,1073 @@
+#include "journey.hpp"
+#include "heap_tracker.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+namespace {
+
+const char* const DEFAULT_PARTY_NAMES[] = {
+    "Player", "Companion 1", "Companion 2", "Companion 3", "Companion 4"
+};
+
+// Every text a JourneyCore field can point at; saved states store the index
+const char* const AILMENT_TEXTS[] = {"", "sick", "recovering", "dysentery"};
+const char* const EVENT_TEXTS[] = {"", "Random Event"};
+
+const uint8_t SAVED_STATE_VERSION = 1;
+
+template <size_t N>
+uint8_t findText(const char* const (&texts)[N], const char* text) {
+    for (size_t i = 0; i < N; ++i) {
+        if (std::strcmp(texts[i], text) == 0) {
+            return static_cast<uint8_t>(i);
+        }
+    }
+    return 0;
+}
+
+// Little-endian field writer/reader for saved states
+class StateWriter {
+public:
+    explicit StateWriter(std::string& out) : m_out(out) {}
+    void put(uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            m_out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+    void putInt(int value) { put(static_cast<uint32_t>(value), 4); }
+
+private:
+    std::string& m_out;
+};
+
+class StateReader {
+public:
+    StateReader(const char* data, size_t size) : m_data(data), m_size(size) {}
+    uint64_t get(int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            if (m_position >= m_size) {
+                m_ok = false;
+                return 0;
+            }
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(m_data[m_position++])) << (8 * i);
+        }
+        return value;
+    }
+    int getInt() { return static_cast<int>(static_cast<uint32_t>(get(4))); }
+    std::string getText(size_t length) {
+        if (length > m_size - std::min(m_position, m_size)) {
+            m_ok = false;
+            return std::string();
+        }
+        std::string text(m_data + m_position, length);
+        m_position += length;
+        return text;
+    }
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_position == m_size; }
+
+private:
+    const char* m_data;
+    size_t m_size;
+    size_t m_position = 0;
+    bool m_ok = true;
+};
+
+} // namespace
+
+static_assert(std::is_trivially_copyable<JourneyCore>::value,
+              "JourneyCore is copied wholesale when a journey forks");
+
+// Constructor
+Journey::Journey(const std::string& profession, uint64_t seed, const SimParams& params,
+                 std::shared_ptr<const TrailData> trail)
+    : m_trail(trail ? std::move(trail) : defaultTrailData())
+{
+    auto setup = std::make_shared<JourneySetup>();
+    setup->profession = profession;
+    setup->seed = seed;
+    setup->params = params;
+    setup->partyNames.assign(std::begin(DEFAULT_PARTY_NAMES), std::end(DEFAULT_PARTY_NAMES));
+    m_setup = std::move(setup);
+
+    static const std::shared_ptr<const std::string> emptyMessage = [] {
+        HeapScope scope(HeapSubsystem::Other);      // Kept for the whole run
+        return std::make_shared<const std::string>();
+    }();
+    m_eventMessage = emptyMessage;
+    m_core.rng.seed(seed);
+
+    // Setup starting resources based on profession
+    if (profession == "Banker") {
+        m_core.resources = Resources(1600);
+    } else if (profession == "Carpenter") {
+        m_core.resources = Resources(800);
+    } else if (profession == "Farmer") {
+        m_core.resources = Resources(400);
+    } else {
+        // Default
+        m_core.resources = Resources(1000);
+    }
+}
+
+void Journey::setupInitialJourney() {
+    // Default party setup with placeholder names
+    m_core.party.clear();
+    for (const auto& name : m_setup->partyNames) {
+        m_core.party.add(PartyMember(name.c_str()));
+    }
+
+    // Setup initial resources
+    setupStartingResources();
+
+    m_core.subState = TravelSubState::Setup;
+}
+
+void Journey::restore(const JourneySnapshot& snapshot) {
+    // Logging is a property of who is driving the journey, not of its state
+    bool logging = m_core.logging;
+    m_core = snapshot.core;
+    m_core.logging = logging;
+    if (snapshot.eventMessage) {
+        m_eventMessage = snapshot.eventMessage;
+    }
+}
+
+std::string Journey::saveState() const {
+    std::string data;
+    StateWriter out(data);
+    out.put(SAVED_STATE_VERSION, 1);
+
+    out.put(m_core.party.size(), 1);
+    for (const auto& member : m_core.party) {
+        size_t nameIndex = 0;
+        while (nameIndex < m_setup->partyNames.size() &&
+               m_setup->partyNames[nameIndex].c_str() != member.name) {
+            nameIndex++;
+        }
+        out.put(nameIndex, 1);
+        out.putInt(member.health);
+        out.put(member.isAlive, 1);
+        out.put(findText(AILMENT_TEXTS, member.ailment), 1);
+        out.put(static_cast<uint8_t>(member.causeOfDeath), 1);
+    }
+
+    const Resources& resources = m_core.resources;
+    out.putInt(resources.money);
+    out.putInt(resources.food);
+    out.putInt(resources.ammunition);
+    out.putInt(resources.clothing);
+    out.putInt(resources.wagonParts);
+    out.putInt(resources.medicines);
+
+    out.putInt(m_core.currentDay);
+    out.putInt(m_core.month);
+    out.putInt(m_core.year);
+    out.putInt(m_core.daysElapsed);
+    out.putInt(m_core.milesTraveled);
+    out.putInt(m_core.nextLandmarkIndex);
+    out.put(static_cast<uint8_t>(m_core.currentWeather), 1);
+    out.put(static_cast<uint8_t>(m_core.subState), 1);
+    out.put(m_core.rng.getState(), 8);
+    out.put(m_core.rng.getIncrement(), 8);
+    out.put(findText(EVENT_TEXTS, m_core.currentEvent), 1);
+    out.put(m_core.needsUpdate, 1);
+    out.put(m_core.gameOver, 1);
+    out.put(m_core.reachedOregon, 1);
+    out.put(m_core.wantsMenu, 1);
+
+    out.put(m_eventMessage->size(), 4);
+    data += *m_eventMessage;
+    return data;
+}
+
+bool Journey::loadState(const char* data, size_t size) {
+    StateReader in(data, size);
+    if (in.get(1) != SAVED_STATE_VERSION) {
+        return false;
+    }
+
+    JourneyCore core = m_core;
+    core.party.clear();
+    size_t partySize = in.get(1);
+    if (partySize > MAX_PARTY_SIZE) {
+        return false;
+    }
+    for (size_t i = 0; i < partySize; ++i) {
+        size_t nameIndex = in.get(1);
+        if (nameIndex >= m_setup->partyNames.size()) {
+            return false;
+        }
+        PartyMember member(m_setup->partyNames[nameIndex].c_str());
+        member.health = in.getInt();
+        member.isAlive = in.get(1) != 0;
+        size_t ailment = in.get(1);
+        member.ailment = AILMENT_TEXTS[ailment < std::size(AILMENT_TEXTS) ? ailment : 0];
+        uint8_t cause = static_cast<uint8_t>(in.get(1));
+        if (cause >= DEATH_CAUSE_COUNT) {
+            return false;
+        }
+        member.causeOfDeath = static_cast<DeathCause>(cause);
+        core.party.add(member);
+    }
+
+    Resources& resources = core.resources;
+    resources.money = in.getInt();
+    resources.food = in.getInt();
+    resources.ammunition = in.getInt();
+    resources.clothing = in.getInt();
+    resources.wagonParts = in.getInt();
+    resources.medicines = in.getInt();
+
+    core.currentDay = in.getInt();
+    core.month = in.getInt();
+    core.year = in.getInt();
+    core.daysElapsed = in.getInt();
+    core.milesTraveled = in.getInt();
+    core.nextLandmarkIndex = in.getInt();
+    core.currentWeather = static_cast<Weather>(in.get(1));
+    core.subState = static_cast<TravelSubState>(in.get(1));
+    uint64_t rngState = in.get(8);
+    core.rng.setState(rngState, in.get(8));
+    size_t event = in.get(1);
+    core.currentEvent = EVENT_TEXTS[event < std::size(EVENT_TEXTS) ? event : 0];
+    core.needsUpdate = in.get(1) != 0;
+    core.gameOver = in.get(1) != 0;
+    core.reachedOregon = in.get(1) != 0;
+    core.wantsMenu = in.get(1) != 0;
+
+    std::string message = in.getText(in.get(4));
+    if (!in.ok() || !in.atEnd() ||
+        core.currentWeather > Weather::Snowy || core.subState > TravelSubState::GameOver ||
+        core.nextLandmarkIndex < 0 || core.nextLandmarkIndex > static_cast<int>(m_trail->landmarks.size())) {
+        return false;
+    }
+
+    m_core = core;
+    setEventMessage(std::move(message));
+    return true;
+}
+
+void Journey::setupStartingResources() {
+    // Start with some supplies
+    if (m_setup->profession == "Banker") {
+        m_core.resources.money = 1600;
+        m_core.resources.food = 200;
+        m_core.resources.ammunition = 100;
+        m_core.resources.clothing = 3;
+        m_core.resources.wagonParts = 3;
+        m_core.resources.medicines = 2;
+    } else if (m_setup->profession == "Carpenter") {
+        m_core.resources.money = 800;
+        m_core.resources.food = 180;
+        m_core.resources.ammunition = 80;
+        m_core.resources.clothing = 2;
+        m_core.resources.wagonParts = 2;
+        m_core.resources.medicines = 1;
+    } else if (m_setup->profession == "Farmer") {
+        m_core.resources.money = 400;
+        m_core.resources.food = 160;
+        m_core.resources.ammunition = 60;
+        m_core.resources.clothing = 1;
+        m_core.resources.wagonParts = 1;
+        m_core.resources.medicines = 1;
+    } else {
+        // Default
+        m_core.resources.money = 1000;
+        m_core.resources.food = 180;
+        m_core.resources.ammunition = 80;
+        m_core.resources.clothing = 2;
+        m_core.resources.wagonParts = 2;
+        m_core.resources.medicines = 1;
+    }
+}
+
+void Journey::handleKey(SDL_Keycode key) {
+    // Handle differently based on sub-state
+    switch (m_core.subState) {
+        case TravelSubState::Setup:
+            handleSetupInput(key);
+            break;
+
+        case TravelSubState::Traveling:
+            handleTravelInput(key);
+            break;
+
+        case TravelSubState::Location:
+            if (key == SDLK_SPACE) {
+                m_core.subState = TravelSubState::Traveling;
+            } else if (key == SDLK_ESCAPE) {
+                m_core.wantsMenu = true;
+            }
+            break;
+
+        case TravelSubState::River:
+            handleRiverInput(key);
+            break;
+
+        case TravelSubState::Event:
+            if (key == SDLK_SPACE || key == SDLK_RETURN) {
+                // Continue after the event
+                m_core.subState = TravelSubState::Traveling;
+            } else if (key == SDLK_ESCAPE) {
+                m_core.wantsMenu = true;
+            }
+            break;
+
+        case TravelSubState::Hunting:
+            handleHuntingInput(key);
+            break;
+
+        case TravelSubState::Trading:
+            handleTradingInput(key);
+            break;
+
+        case TravelSubState::Resting:
+            handleRestingInput(key);
+            break;
+
+        case TravelSubState::GameOver:
+            if (key == SDLK_SPACE || key == SDLK_RETURN || key == SDLK_ESCAPE) {
+                // Return to main menu
+                m_core.wantsMenu = true;
+            }
+            break;
+    }
+}
+
+void Journey::handleRiverInput(SDL_Keycode key) {
+    if (key == SDLK_1) {
+        // Ford the river
+        if (m_core.logging) {
+            std::cout << "Fording the river" << std::endl;
+        }
+        // Simple chance of success based on river depth
+        int currentLandmarkIndex = std::max(0, m_core.nextLandmarkIndex - 1);
+        if (currentLandmarkIndex < static_cast<int>(m_trail->landmarks.size()) &&
+            m_trail->landmarks[currentLandmarkIndex].isRiver) {
+
+            int depth = m_trail->landmarks[currentLandmarkIndex].riverDepth;
+            int roll = m_core.rng.range(1, 10);
+
+            if (roll > depth) {
+                setEventMessage("You successfully forded the river!");
+            } else {
+                setEventMessage("Disaster! Your wagon tipped while crossing!");
+                // Lose some supplies
+                int foodLoss = std::min(m_core.resources.food / 4, 50);
+                m_core.resources.food -= foodLoss;
+
+                // Possible injury to party member
+                int memberIndex = m_core.rng.range(0, static_cast<int>(m_core.party.size()) - 1);
+                m_core.party[memberIndex].health -= 20;
+                if (m_core.party[memberIndex].health <= 0) {
+                    killMember(m_core.party[memberIndex], DeathCause::Drowning);
+                    appendEventMessage(std::string(" ") + m_core.party[memberIndex].name + " has drowned.");
+                } else {
+                    appendEventMessage(std::string(" ") + m_core.party[memberIndex].name + " was injured.");
+                }
+            }
+        }
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_2) {
+        // Caulk the wagon
+        if (m_core.logging) {
+            std::cout << "Caulking the wagon" << std::endl;
+        }
+        // Higher chance of success but uses resources
+        if (m_core.resources.wagonParts >= 1) {
+            m_core.resources.wagonParts--;
+            int roll = m_core.rng.range(1, 10);
+
+            if (roll > 2) {
+                setEventMessage("You successfully caulked and floated the wagon across!");
+            } else {
+                setEventMessage("The river was too deep! Your wagon and supplies were damaged.");
+                // Lose more supplies
+                int foodLoss = std::min(m_core.resources.food / 3, 75);
+                m_core.resources.food -= foodLoss;
+                m_core.resources.clothing = std::max(0, m_core.resources.clothing - 1);
+            }
+        } else {
+            setEventMessage("You don't have enough wagon parts to caulk the wagon.");
+        }
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_3) {
+        // Hire a guide
+        if (m_core.logging) {
+            std::cout << "Hiring a guide" << std::endl;
+        }
+        if (m_core.resources.money >= 40) {
+            m_core.resources.money -= 40;
+            setEventMessage("You hired a guide to help you cross the river safely.");
+        } else {
+            setEventMessage("You don't have enough money to hire a guide.");
+        }
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_4) {
+        // Wait for conditions to improve
+        if (m_core.logging) {
+            std::cout << "Waiting for conditions to improve" << std::endl;
+        }
+        int daysToWait = m_core.rng.range(1, 5);
+        for (int i = 0; i < daysToWait; i++) {
+            advanceDay();
+        }
+        setEventMessage("You waited " + std::to_string(daysToWait) +
+                        " days for river conditions to improve. The river seems a bit calmer now.");
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_ESCAPE) {
+        m_core.wantsMenu = true;
+    }
+}
+
+void Journey::handleHuntingInput(SDL_Keycode key) {
+    // Simple hunting mechanics
+    if (key == SDLK_SPACE) {
+        if (m_core.resources.ammunition > 0) {
+            m_core.resources.ammunition--;
+            int roll = m_core.rng.range(1, 10);
+            if (roll > 3) { // 70% chance of success
+                int foodGained = roll * 10; // 40-100 pounds of food
+                m_core.resources.food += foodGained;
+                setEventMessage("Successful hunt! You gained " +
+                                std::to_string(foodGained) + " pounds of food.");
+            } else {
+                setEventMessage("The hunt was unsuccessful. You wasted ammunition.");
+            }
+        } else {
+            setEventMessage("You're out of ammunition. You cannot hunt.");
+        }
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_ESCAPE) {
+        // Return to travel
+        m_core.subState = TravelSubState::Traveling;
+    }
+}
+
+void Journey::handleTradingInput(SDL_Keycode key) {
+    // Simple trading interface
+    if (key == SDLK_1 && m_core.resources.money >= 20) {
+        // Buy food
+        m_core.resources.money -= 20;
+        m_core.resources.food += 50;
+        setEventMessage("You purchased 50 pounds of food for $20.");
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_2 && m_core.resources.money >= 10) {
+        // Buy ammunition
+        m_core.resources.money -= 10;
+        m_core.resources.ammunition += 20;
+        setEventMessage("You purchased 20 bullets for $10.");
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_3 && m_core.resources.money >= 15) {
+        // Buy clothing
+        m_core.resources.money -= 15;
+        m_core.resources.clothing += 1;
+        setEventMessage("You purchased 1 set of clothing for $15.");
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_4 && m_core.resources.money >= 35) {
+        // Buy wagon parts
+        m_core.resources.money -= 35;
+        m_core.resources.wagonParts += 1;
+        setEventMessage("You purchased 1 wagon part for $35.");
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_5 && m_core.resources.money >= 25) {
+        // Buy medicine
+        m_core.resources.money -= 25;
+        m_core.resources.medicines += 1;
+        setEventMessage("You purchased 1 medicine kit for $25.");
+        m_core.subState = TravelSubState::Event;
+    } else if (key == SDLK_ESCAPE) {
+        // Exit trading
+        m_core.subState = TravelSubState::Traveling;
+    }
+}
+
+void Journey::handleRestingInput(SDL_Keycode key) {
+    if (key == SDLK_1) {
+        // Rest for 1 day
+        restForDays(1);
+        m_core.subState = TravelSubState::Traveling;
+    } else if (key == SDLK_2) {
+        // Rest for 3 days
+        restForDays(3);
+        m_core.subState = TravelSubState::Traveling;
+    } else if (key == SDLK_3) {
+        // Rest for a week
+        restForDays(7);
+        m_core.subState = TravelSubState::Traveling;
+    } else if (key == SDLK_ESCAPE) {
+        // Don't rest
+        m_core.subState = TravelSubState::Traveling;
+    }
+}
+
+void Journey::applyKey(SDL_Keycode key) {
+    handleKey(key);
+    update();
+}
+
+void Journey::update() {
+    // Only update game state when needed (after player input)
+    if (!m_core.needsUpdate)
+        return;
+
+    m_core.needsUpdate = false;
+
+    // Check if game is over
+    if (m_core.gameOver)
+        return;
+
+    if (m_core.subState != TravelSubState::Traveling)
+        return;
+
+    // Check for landmarks and rivers
+    checkForLandmark();
+
+    // Generate random events
+    if (m_core.subState == TravelSubState::Traveling) {
+        // Small chance of random event each day
+        if (m_core.rng.chance(m_setup->params.randomEventChance)) {
+            triggerRandomEvent();
+        }
+    }
+}
+
+void Journey::advanceDay() {
+    // Increment day counter
+    m_core.currentDay++;
+    m_core.daysElapsed++;
+
+    // Update month/year if necessary
+    if (m_core.currentDay > 30) { // Simplified month length
+        m_core.currentDay = 1;
+        m_core.month++;
+        if (m_core.month > 12) {
+            m_core.month = 1;
+            m_core.year++;
+        }
+    }
+
+    // Update weather based on month
+    updateWeather();
+
+    // Consume daily resources
+    consumeResources();
+
+    // Update health of party members
+    updateHealth();
+
+    // Travel distance for the day
+    int milesForDay = calculateDailyMiles();
+    m_core.milesTraveled += milesForDay;
+
+    if (m_core.logging) {
+        std::cout << "Day " << m_core.currentDay << " of month " << m_core.month << ": traveled "
+                  << milesForDay << " miles. Total: " << m_core.milesTraveled << std::endl;
+    }
+
+    // Check if reached Oregon
+    if (m_core.milesTraveled >= m_trail->getTotalDistance()) {
+        m_core.reachedOregon = true;
+        m_core.gameOver = true;
+        setEventMessage("Congratulations! You have reached Oregon City!");
+        m_core.subState = TravelSubState::GameOver;
+    }
+
+    // Check if all party members are dead
+    if (getAliveCount() == 0) {
+        m_core.gameOver = true;
+        setEventMessage("Game Over. All members of your party have died.");
+        m_core.subState = TravelSubState::GameOver;
+    }
+
+    // Check if out of food
+    if (m_core.resources.food <= 0) {
+        // Reduce health of party members
+        for (auto& member : m_core.party) {
+            if (member.isAlive) {
+                member.health -= m_setup->params.starvationDayDamage;
+                if (member.health <= 0) {
+                    killMember(member, DeathCause::Starvation);
+                }
+            }
+        }
+    }
+
+    // Mark that we need to resolve landmarks and events
+    m_core.needsUpdate = true;
+}
+
+void Journey::consumeResources() {
+    // Each person consumes a fixed amount of food per day
+    int foodConsumed = getAliveCount() * m_setup->params.foodPerPersonPerDay;
+    m_core.resources.food = std::max(0, m_core.resources.food - foodConsumed);
+
+    // Clothing deteriorates based on weather
+    if (m_core.currentWeather == Weather::Rainy || m_core.currentWeather == Weather::Stormy) {
+        // More wear on clothing in bad weather
+        if (m_core.rng.chance(m_setup->params.clothingWearChance)) {
+            if (m_core.resources.clothing > 0) {
+                m_core.resources.clothing--;
+                if (m_core.logging) {
+                    std::cout << "Some clothing has worn out due to bad weather." << std::endl;
+                }
+            }
+        }
+    }
+
+    // Wagon parts can break on rough terrain
+    if (m_core.currentWeather == Weather::Stormy) {
+        if (m_core.rng.chance(m_setup->params.wagonDamageChance)) {
+            if (m_core.resources.wagonParts > 0) {
+                m_core.resources.wagonParts--;
+                if (m_core.logging) {
+                    std::cout << "A wagon part broke during the storm." << std::endl;
+                }
+            } else if (m_core.logging) {
+                // If no spare parts, reduce travel pace
+                std::cout << "Your wagon is damaged and slowing you down." << std::endl;
+            }
+        }
+    }
+}
+
+void Journey::updateWeather() {
+    Weather baseSeason = getWeatherForMonth(m_core.month);
+
+    // Slight randomization of weather
+    double roll = m_core.rng.unit();
+
+    if (roll < m_setup->params.seasonalWeatherChance) {
+        // Seasonal weather
+        m_core.currentWeather = baseSeason;
+    } else if (roll < m_setup->params.seasonalWeatherChance + m_setup->params.betterWeatherChance) {
+        // Better weather than expected
+        switch (baseSeason) {
+            case Weather::Snowy:
+                m_core.currentWeather = Weather::Cloudy;
+                break;
+            case Weather::Rainy:
+                m_core.currentWeather = Weather::Cloudy;
+                break;
+            case Weather::Stormy:
+                m_core.currentWeather = Weather::Rainy;
+                break;
+            case Weather::Cloudy:
+                m_core.currentWeather = Weather::Fair;
+                break;
+            default:
+                m_core.currentWeather = Weather::Fair;
+                break;
+        }
+    } else {
+        // Worse weather than expected
+        switch (baseSeason) {
+            case Weather::Fair:
+                m_core.currentWeather = Weather::Cloudy;
+                break;
+            case Weather::Cloudy:
+                m_core.currentWeather = Weather::Rainy;
+                break;
+            case Weather::Rainy:
+                m_core.currentWeather = Weather::Stormy;
+                break;
+            default:
+                m_core.currentWeather = Weather::Stormy;
+                break;
+        }
+    }
+}
+
+Weather Journey::getWeatherForMonth(int month) {
+    // Simplified seasonal weather patterns
+    switch (month) {
+        case 12:
+        case 1:
+        case 2:
+            return Weather::Snowy; // Winter
+        case 3:
+        case 4:
+        case 5:
+            return Weather::Rainy; // Spring
+        case 6:
+        case 7:
+        case 8:
+            return Weather::Fair; // Summer
+        case 9:
+        case 10:
+        case 11:
+            return Weather::Cloudy; // Fall
+        default:
+            return Weather::Fair;
+    }
+}
+
+void Journey::updateHealth() {
+    for (auto& member : m_core.party) {
+        if (!member.isAlive)
+            continue;
+
+        // Base health change
+        int healthChange = 0;
+
+        // Health boost if resting
+        if (m_core.subState == TravelSubState::Resting) {
+            healthChange += m_setup->params.restRecovery;
+        }
+
+        // Health penalty if no food
+        if (m_core.resources.food <= 0) {
+            healthChange -= m_setup->params.starvationDamage;
+        }
+
+        // Health penalty for bad weather without clothing
+        if ((m_core.currentWeather == Weather::Rainy || m_core.currentWeather == Weather::Snowy) &&
+            m_core.resources.clothing <= 0) {
+            healthChange -= m_setup->params.exposureDamage;
+        }
+
+        // Random chance of illness
+        bool fellIll = m_core.rng.chance(m_setup->params.illnessChance);
+        if (fellIll) {
+            member.health -= m_setup->params.illnessDamage;
+            member.ailment = "sick";
+
+            // Medicine can help
+            if (m_core.resources.medicines > 0) {
+                m_core.resources.medicines--;
+                member.health += m_setup->params.medicineRecovery; // Medicine alleviates some health loss
+                member.ailment = "recovering";
+            }
+        }
+
+        // Apply health change
+        member.health += healthChange;
+
+        // Cap health at 0-100
+        member.health = std::max(0, std::min(100, member.health));
+
+        // Check if died
+        if (member.health <= 0) {
+            if (fellIll) {
+                killMember(member, DeathCause::Illness);
+            } else if (m_core.resources.food <= 0) {
+                killMember(member, DeathCause::Starvation);
+            } else {
+                killMember(member, DeathCause::Exposure);
+            }
+            setEventMessage(std::string(member.name) + " has died.");
+            m_core.subState = TravelSubState::Event;
+        }
+    }
+}
+
+int Journey::calculateDailyMiles() {
+    // Base travel rate plus weather modifier
+    int baseMiles = m_setup->params.baseDailyMiles +
+                    m_setup->params.weatherMileModifier[static_cast<int>(m_core.currentWeather)];
+
+    // Wagon damage modifier
+    if (m_core.resources.wagonParts <= 0) {
+        baseMiles = std::max(1, baseMiles - m_setup->params.brokenWagonMilePenalty); // Damaged wagon slows travel
+    }
+
+    // Ensure minimum travel rate
+    return std::max(1, baseMiles);
+}
+
+void Journey::setEventMessage(std::string message) {
+   m_eventMessage = std::make_shared<const std::string>(std::move(message));
+}
+
+void Journey::appendEventMessage(const std::string& text) {
+    setEventMessage(*m_eventMessage + text);
+}
+
+void Journey::killMember(PartyMember& member, DeathCause cause) {
+    member.isAlive = false;
+    member.causeOfDeath = cause;
+}
+
+void Journey::checkForLandmark() {
+    if (m_core.nextLandmarkIndex >= static_cast<int>(m_trail->landmarks.size()))
+        return;
+
+    if (m_core.milesTraveled >= m_trail->landmarks[m_core.nextLandmarkIndex].distance) {
+        // Reached a landmark
+        const Location& landmark = m_trail->landmarks[m_core.nextLandmarkIndex];
+        setEventMessage("You have reached " + landmark.name + "!\n" + landmark.description);
+
+        // Special handling for river crossings
+        if (landmark.isRiver) {
+            m_core.subState = TravelSubState::River;
+        } else {
+            m_core.subState = TravelSubState::Location;
+        }
+
+        m_core.nextLandmarkIndex++;
+    }
+}
+
+void Journey::triggerRandomEvent() {
+    static const char* const events[] = {
+        "One of your oxen is sick. It needs to rest for a day.",
+        "A wheel on your wagon is damaged. You lose a wagon part.",
+        "Heavy rains have washed out part of the trail ahead.",
+        "You found wild berries and gathered some extra food!",
+        "A friendly Native American group shows you a shortcut.",
+        "Your wagon axle breaks! You must repair it to continue.",
+        "Bandits attack your party! You lose some supplies.",
+        "A friendly settler shares some food with your party.",
+        "A snowstorm forces you to take shelter for a day.",
+        "One of your party members has come down with dysentery."
+    };
+    const int eventCount = static_cast<int>(sizeof(events) / sizeof(events[0]));
+
+    int eventIndex = m_core.rng.range(0, eventCount - 1);
+    m_core.currentEvent = "Random Event";
+    setEventMessage(events[eventIndex]);
+
+    // Handle event effects
+    switch (eventIndex) {
+        case 0: // Sick oxen
+            // Lose a day
+            advanceDay();
+            break;
+
+        case 1: // Wagon wheel damaged
+            if (m_core.resources.wagonParts > 0) {
+                m_core.resources.wagonParts--;
+            } else {
+                // No spare parts slows you down
+                appendEventMessage(" Without spare parts, this will slow your journey.");
+            }
+            break;
+
+        case 2: // Heavy rains
+            // Will affect travel speed through weather
+            m_core.currentWeather = Weather::Rainy;
+            break;
+
+        case 3: // Found wild berries
+            m_core.resources.food += 20;
+            break;
+
+        case 4: // Shortcut
+            m_core.milesTraveled += 20;
+            break;
+
+        case 5: // Broken axle
+            if (m_core.resources.wagonParts > 0) {
+                m_core.resources.wagonParts--;
+                appendEventMessage(" You used a spare part to fix it.");
+            } else {
+                // More serious breakdown
+                appendEventMessage(" Without spare parts, your wagon is severely damaged. This will greatly slow your journey.");
+            }
+            break;
+
+        case 6: // Bandits attack
+            // Lose some resources
+            m_core.resources.food = std::max(0, m_core.resources.food - 30);
+            m_core.resources.ammunition = std::max(0, m_core.resources.ammunition - 20);
+            m_core.resources.money = std::max(0, m_core.resources.money - 25);
+            break;
+
+        case 7: // Friendly settler shares food
+            m_core.resources.food += 30;
+            break;
+
+        case 8: // Snowstorm
+            // Force rest for a few days
+            m_core.currentWeather = Weather::Snowy;
+            restForDays(2);
+            break;
+
+        case 9: // Dysentery
+            {
+                // Random party member gets sick
+                std::vector<size_t> aliveIndices;
+                for (size_t i = 0; i < m_core.party.size(); i++) {
+                    if (m_core.party[i].isAlive) {
+                        aliveIndices.push_back(i);
+                    }
+                }
+
+                if (!aliveIndices.empty()) {
+                    int pick = m_core.rng.range(0, static_cast<int>(aliveIndices.size()) - 1);
+                    size_t victimIndex = aliveIndices[pick];
+                    m_core.party[victimIndex].health -= 25;
+                    m_core.party[victimIndex].ailment = "dysentery";
+                    appendEventMessage(std::string(" ") + m_core.party[victimIndex].name + " has caught it.");
+
+                    // Medicine can help
+                    if (m_core.resources.medicines > 0) {
+                        m_core.resources.medicines--;
+                        m_core.party[victimIndex].health += 15;
+                        appendEventMessage(" You used medicine to treat them.");
+                    }
+
+                    // Check if died
+                    if (m_core.party[victimIndex].health <= 0) {
+                        killMember(m_core.party[victimIndex], DeathCause::Dysentery);
+                        appendEventMessage(std::string(" Unfortunately, ") + m_core.party[victimIndex].name + " has died.");
+                    }
+                }
+            }
+            break;
+    }
+
+    // Switch to event state to display the result
+    m_core.subState = TravelSubState::Event;
+}
+
+void Journey::handleSetupInput(SDL_Keycode key) {
+    if (key == SDLK_SPACE || key == SDLK_RETURN) {
+        // Complete setup and start journey
+        m_core.subState = TravelSubState::Traveling;
+    } else if (key == SDLK_ESCAPE) {
+        m_core.wantsMenu = true;
+    }
+}
+
+void Journey::handleTravelInput(SDL_Keycode key) {
+    switch (key) {
+        case SDLK_SPACE:
+            // Continue on the trail (advance one day)
+            advanceDay();
+            break;
+
+        case SDLK_1:
+            // Rest
+            m_core.subState = TravelSubState::Resting;
+            break;
+
+        case SDLK_2:
+            // Hunt
+            m_core.subState = TravelSubState::Hunting;
+            break;
+
+        case SDLK_3:
+            // Trade
+            m_core.subState = TravelSubState::Trading;
+            break;
+
+        case SDLK_4:
+            // Check supplies
+            setEventMessage("Current Supplies:\n"
+                            "Money: $" + std::to_string(m_core.resources.money) + "\n"
+                            "Food: " + std::to_string(m_core.resources.food) + " pounds\n"
+                            "Ammunition: " + std::to_string(m_core.resources.ammunition) + " bullets\n"
+                            "Clothing: " + std::to_string(m_core.resources.clothing) + " sets\n"
+                            "Wagon Parts: " + std::to_string(m_core.resources.wagonParts) + "\n"
+                            "Medicines: " + std::to_string(m_core.resources.medicines));
+            m_core.subState = TravelSubState::Event;
+            break;
+
+        case SDLK_ESCAPE:
+            m_core.wantsMenu = true;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void Journey::restForDays(int days) {
+    for (int i = 0; i < days; i++) {
+        // Rest mode improves health but still consumes resources
+        advanceDay();
+    }
+
+    setEventMessage("You rested for " + std::to_string(days) + " days. Your party's health has improved.");
+    m_core.subState = TravelSubState::Event;
+}
+
+const Location& Journey::getCurrentLandmark() const {
+    int currentLandmarkIndex = std::max(0, m_core.nextLandmarkIndex - 1);
+    return m_trail->landmarks[currentLandmarkIndex];
+}
+
+int Journey::getAliveCount() const {
+    int aliveMembers = 0;
+    for (const auto& member : m_core.party) {
+        if (member.isAlive) {
+            aliveMembers++;
+        }
+    }
+    return aliveMembers;
+}
+
+JourneyOutcome Journey::getOutcome() const {
+    JourneyOutcome outcome;
+    outcome.reachedOregon = m_core.reachedOregon;
+    outcome.daysElapsed = m_core.daysElapsed;
+    outcome.month = m_core.month;
+    outcome.day = m_core.currentDay;
+    outcome.year = m_core.year;
+    outcome.survivors = getAliveCount();
+    outcome.milesTraveled = m_core.milesTraveled;
+    outcome.food = m_core.resources.food;
+    outcome.money = m_core.resources.money;
+    for (const auto& member : m_core.party) {
+        if (!member.isAlive) {
+            outcome.deaths[static_cast<int>(member.causeOfDeath)]++;
+        }
+    }
+    return outcome;
+}
+
+JourneyScore Journey::getScore() const {
+    JourneyScore score;
+    if (!m_core.reachedOregon) {
+        return score;
+    }
+
+    for (const auto& member : m_core.party) {
+        if (member.isAlive) {
+            score.partyScore += member.health;
+        }
+    }
+
+    const Resources& resources = m_core.resources;
+    score.resourceScore = resources.food / 5 + resources.money / 5 +
+                          resources.ammunition / 10 +
+                          resources.clothing * 10 +
+                          resources.wagonParts * 15 +
+                          resources.medicines * 20;
+
+    // Two points for every day under a year on the trail
+    score.timeBonus = std::max(0, 365 - m_core.daysElapsed) * 2;
+
+    if (m_setup->profession == "Farmer") {
+        score.multiplier = 3;   // Harder start, better score
+    } else if (m_setup->profession == "Carpenter") {
+        score.multiplier = 2;   // Medium difficulty
+    }
+
+    score.total = (score.partyScore + score.resourceScore + score.timeBonus) * score.multiplier;
+    return score;
+}
+
+const char* getDeathCauseName(DeathCause cause) {
+    switch (cause) {
+        case DeathCause::None:
+            return "none";
+        case DeathCause::Illness:
+            return "illness";
+        case DeathCause::Starvation:
+            return "starvation";
+        case DeathCause::Exposure:
+            return "exposure";
+        case DeathCause::Drowning:
+            return "drowning";
+        case DeathCause::Dysentery:
+            return "dysentery";
+    }
+    return "unknown";
+}
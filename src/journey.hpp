@@ -0,0 +1,283 @@
+#ifndef JOURNEY_HPP
+#define JOURNEY_HPP
+
+#include "rng.hpp"
+#include "sim_params.hpp"
+#include "trail_data.hpp"
+#include <SDL2/SDL_keycode.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// What a party member died of
+enum class DeathCause {
+    None,
+    Illness,
+    Starvation,
+    Exposure,
+    Drowning,
+    Dysentery
+};
+
+const int DEATH_CAUSE_COUNT = 6;
+
+const char* getDeathCauseName(DeathCause cause);
+
+// Represents a party member on the journey. Text fields point at strings
+// owned elsewhere (the journey's shared setup, or literals), so members
+// copy as plain data.
+struct PartyMember {
+    const char* name = "";
+    int health = 100;       // 0-100 where 100 is perfect health
+    bool isAlive = true;
+    const char* ailment = "";
+    DeathCause causeOfDeath = DeathCause::None;
+
+    PartyMember() = default;
+    explicit PartyMember(const char* name) : name(name) {}
+};
+
+// The wagon holds at most this many people
+const int MAX_PARTY_SIZE = 5;
+
+// Fixed-capacity party stored inline, so copying a journey never touches
+// the heap for it
+class Party {
+public:
+    size_t size() const { return static_cast<size_t>(m_size); }
+    bool empty() const { return m_size == 0; }
+    void clear() { m_size = 0; }
+    void add(const PartyMember& member) {
+        if (m_size < MAX_PARTY_SIZE) {
+            m_members[m_size++] = member;
+        }
+    }
+
+    PartyMember& operator[](size_t index) { return m_members[index]; }
+    const PartyMember& operator[](size_t index) const { return m_members[index]; }
+    PartyMember* begin() { return m_members; }
+    PartyMember* end() { return m_members + m_size; }
+    const PartyMember* begin() const { return m_members; }
+    const PartyMember* end() const { return m_members + m_size; }
+
+private:
+    PartyMember m_members[MAX_PARTY_SIZE];
+    int m_size = 0;
+};
+
+// Represents the player's resources
+struct Resources {
+    int money = 0;          // Cash on hand
+    int food = 0;           // Pounds of food
+    int ammunition = 0;     // Bullets for hunting
+    int clothing = 0;       // Sets of clothing
+    int wagonParts = 0;     // Spare parts for the wagon
+    int medicines = 0;      // Medical supplies
+
+    Resources(int startingMoney = 1600) : money(startingMoney) {}
+};
+
+// Weather conditions
+enum class Weather {
+    Fair,
+    Cloudy,
+    Rainy,
+    Stormy,
+    Snowy
+};
+
+// States within a journey
+enum class TravelSubState {
+    Setup,          // Initial setup (naming party, etc)
+    Traveling,      // Normal traveling
+    Location,       // At a landmark or fort
+    River,          // At a river crossing
+    Hunting,        // In hunting mini-game
+    Trading,        // Trading with others
+    Event,          // Random event occurring
+    Resting,        // Resting to recover health
+    GameOver        // End of game (death or reached Oregon)
+};
+
+// Final result of a journey, used by batch tools
+struct JourneyOutcome {
+    bool reachedOregon = false;
+    int daysElapsed = 0;
+    int month = 0;                        // Calendar date the journey ended
+    int day = 0;
+    int year = 0;
+    int survivors = 0;
+    int milesTraveled = 0;
+    int food = 0;
+    int money = 0;
+    int deaths[DEATH_CAUSE_COUNT] = {};   // Indexed by DeathCause
+};
+
+// Final score of a journey that reached Oregon
+struct JourneyScore {
+    int partyScore = 0;         // Health of every survivor
+    int resourceScore = 0;      // Food, cash and supplies left over
+    int timeBonus = 0;          // For arriving in under a year
+    int multiplier = 1;         // Harder professions score more
+    int total = 0;              // (party + resources + time) * multiplier
+};
+
+// Everything fixed when a journey is created. Shared read-only between a
+// journey and all of its forks.
+struct JourneySetup {
+    std::string profession;
+    uint64_t seed = 0;
+    SimParams params;
+    std::vector<std::string> partyNames;
+};
+
+// Everything that changes from day to day. Plain data, so forking a
+// journey copies it in one go.
+struct JourneyCore {
+    Party party;
+    Resources resources;
+
+    int currentDay = 1;            // Game starts on day 1
+    int month = 3;                 // Start in March
+    int year = 1848;
+    int daysElapsed = 0;
+    int milesTraveled = 0;
+    int nextLandmarkIndex = 0;
+    Weather currentWeather = Weather::Fair;
+    TravelSubState subState = TravelSubState::Setup;
+
+    // For random events
+    TrailRng rng;
+
+    // For event handling; always a string literal
+    const char* currentEvent = "";
+
+    // Flags
+    bool needsUpdate = true;
+    bool gameOver = false;
+    bool reachedOregon = false;
+    bool wantsMenu = false;
+    bool logging = true;
+};
+
+// Everything about a journey that can change after it is created. Cheap to
+// take: the core is copied and the event text is shared.
+struct JourneySnapshot {
+    JourneyCore core;
+    std::shared_ptr<const std::string> eventMessage;
+};
+
+// The trail simulation without any rendering. TravelState drives it from
+// keyboard input; batch tools drive it headlessly with the same keys.
+//
+// State is split into shared immutable parts (setup, trail, the current
+// event message) and a small JourneyCore copied by value, so a copy is a
+// what-if branch that costs three reference counts and a few hundred bytes.
+class Journey {
+public:
+    Journey(const std::string& profession = "Banker", uint64_t seed = 0,
+            const SimParams& params = SimParams(),
+            std::shared_ptr<const TrailData> trail = defaultTrailData());
+
+    // Reset party and supplies to the start of the trail
+    void setupInitialJourney();
+
+    // Apply one key press in the current sub-state
+    void handleKey(SDL_Keycode key);
+
+    // Resolve landmarks and random events after a day has passed
+    void update();
+
+    // One input step: the key plus the update it triggers. Live play, the
+    // autopilot and replays all advance through this, so a seed and a key
+    // stream reproduce a session exactly.
+    void applyKey(SDL_Keycode key);
+
+    // Independent branch that continues from this exact state (including
+    // the random number stream)
+    Journey fork() const { return *this; }
+
+    // Capture or roll back to an earlier state of this same journey
+    JourneySnapshot snapshot() const { return JourneySnapshot{m_core, m_eventMessage}; }
+    void restore(const JourneySnapshot& snapshot);
+
+    // Pointer-free encoding of the same state, for autosaves that another
+    // process reads back. loadState() expects a journey created with the
+    // same setup and leaves it untouched if the data is malformed.
+    std::string saveState() const;
+    bool loadState(const char* data, size_t size);
+    bool loadState(const std::string& data) { return loadState(data.data(), data.size()); }
+
+    // Accessors
+    const std::string& getProfession() const { return m_setup->profession; }
+    uint64_t getSeed() const { return m_setup->seed; }
+    const Party& getParty() const { return m_core.party; }
+    const Resources& getResources() const { return m_core.resources; }
+    const std::vector<Location>& getLandmarks() const { return m_trail->landmarks; }
+    const TrailData& getTrail() const { return *m_trail; }
+    const SimParams& getParams() const { return m_setup->params; }
+    const JourneyCore& getCore() const { return m_core; }
+    int getCurrentDay() const { return m_core.currentDay; }
+    int getMonth() const { return m_core.month; }
+    int getYear() const { return m_core.year; }
+    int getDaysElapsed() const { return m_core.daysElapsed; }
+    int getMilesTraveled() const { return m_core.milesTraveled; }
+    int getNextLandmarkIndex() const { return m_core.nextLandmarkIndex; }
+    const Location& getCurrentLandmark() const;
+    Weather getWeather() const { return m_core.currentWeather; }
+    TravelSubState getSubState() const { return m_core.subState; }
+    const char* getCurrentEvent() const { return m_core.currentEvent; }
+    const std::string& getEventMessage() const { return *m_eventMessage; }
+    bool isGameOver() const { return m_core.gameOver; }
+    bool hasReachedOregon() const { return m_core.reachedOregon; }
+    int getAliveCount() const;
+    JourneyOutcome getOutcome() const;
+    JourneyScore getScore() const;      // All zero unless Oregon was reached
+
+    // Console logging of daily progress (off for batch runs)
+    void setLogging(bool enabled) { m_core.logging = enabled; }
+    bool isLogging() const { return m_core.logging; }
+
+    // Set when the player asked to leave the journey (ESC)
+    bool wantsMenu() const { return m_core.wantsMenu; }
+    void clearMenuRequest() { m_core.wantsMenu = false; }
+
+private:
+    // Game mechanics
+    void advanceDay();
+    void consumeResources();
+    void updateWeather();
+    Weather getWeatherForMonth(int month);
+    void updateHealth();
+    int calculateDailyMiles();
+    void killMember(PartyMember& member, DeathCause cause);
+    void checkForLandmark();
+    void triggerRandomEvent();
+    void restForDays(int days);
+    void setupStartingResources();
+
+    // Input handling per sub-state
+    void handleTravelInput(SDL_Keycode key);
+    void handleSetupInput(SDL_Keycode key);
+    void handleRiverInput(SDL_Keycode key);
+    void handleHuntingInput(SDL_Keycode key);
+    void handleTradingInput(SDL_Keycode key);
+    void handleRestingInput(SDL_Keycode key);
+
+    // Event messages are replaced, never edited in place, so forks can
+    // keep sharing the old text
+    void setEventMessage(std::string message);
+    void appendEventMessage(const std::string& text);
+
+    // Shared, immutable
+    std::shared_ptr<const JourneySetup> m_setup;
+    std::shared_ptr<const TrailData> m_trail;
+    std::shared_ptr<const std::string> m_eventMessage;
+
+    // Copied per branch
+    JourneyCore m_core;
+};
+
+#endif // JOURNEY_HPP
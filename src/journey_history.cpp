@@ -0,0 +1,291 @@
+#include "journey_history.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+// Step layout in the ring:
+//   u16 bodyLength, u8 flags, u32 daysElapsed (before the step)
+//   body: { u8 offset, u8 length, <length> old bytes }*
+//   u16 bodyLength (so the newest step can be found from the head)
+const size_t STEP_HEADER_SIZE = 2 + 1 + 4;
+const size_t STEP_TRAILER_SIZE = 2;
+const size_t STEP_OVERHEAD = STEP_HEADER_SIZE + STEP_TRAILER_SIZE;
+
+const uint8_t STEP_CHANGED_MESSAGE = 1;
+
+// Runs closer together than this are merged; a new run costs two bytes
+const size_t RUN_MERGE_GAP = 2;
+const size_t MAX_RUN_LENGTH = 255;
+
+static_assert(std::is_trivially_copyable<TrailRng>::value &&
+              std::has_unique_object_representations<TrailRng>::value,
+              "The RNG is copied into core images as raw bytes");
+
+// Deltas compare an image of JourneyCore with its fields packed end to
+// end, not the struct itself, so padding (whose bytes are unspecified) is
+// never compared and the struct can be laid out any way. The image is
+// never larger than the struct.
+const size_t MAX_IMAGE_SIZE = sizeof(JourneyCore);
+static_assert(MAX_IMAGE_SIZE <= 256, "Delta offsets are stored in one byte");
+
+class ImageWriter {
+public:
+    explicit ImageWriter(uint8_t* out) : m_out(out) {}
+    template <typename T>
+    void operator()(const T& field) {
+        std::memcpy(m_out + m_size, &field, sizeof(field));
+        m_size += sizeof(field);
+    }
+    size_t getSize() const { return m_size; }
+
+private:
+    uint8_t* m_out;
+    size_t m_size = 0;
+};
+
+class ImageReader {
+public:
+    explicit ImageReader(const uint8_t* in) : m_in(in) {}
+    template <typename T>
+    void operator()(T& field) {
+        std::memcpy(&field, m_in + m_size, sizeof(field));
+        m_size += sizeof(field);
+    }
+
+private:
+    const uint8_t* m_in;
+    size_t m_size = 0;
+};
+
+// Every field of the core, in image order. A field left out here is not
+// undone. Every member slot is included, used or not, so a rewind puts
+// the party back exactly; its size follows separately.
+template <typename Core, typename Visit>
+void visitCore(Core& core, Visit& visit) {
+    for (int i = 0; i < MAX_PARTY_SIZE; ++i) {
+        auto& member = core.party[i];
+        visit(member.name);
+        visit(member.ailment);
+        visit(member.health);
+        visit(member.causeOfDeath);
+        visit(member.isAlive);
+    }
+    visit(core.resources.money);
+    visit(core.resources.food);
+    visit(core.resources.ammunition);
+    visit(core.resources.clothing);
+    visit(core.resources.wagonParts);
+    visit(core.resources.medicines);
+    visit(core.currentDay);
+    visit(core.month);
+    visit(core.year);
+    visit(core.daysElapsed);
+    visit(core.milesTraveled);
+    visit(core.nextLandmarkIndex);
+    visit(core.currentWeather);
+    visit(core.subState);
+    visit(core.rng);
+    visit(core.currentEvent);
+    visit(core.needsUpdate);
+    visit(core.gameOver);
+    visit(core.reachedOregon);
+    visit(core.wantsMenu);
+    visit(core.logging);
+}
+
+// Returns the image size
+size_t writeImage(const JourneyCore& core, uint8_t* out) {
+    ImageWriter writer(out);
+    visitCore(core, writer);
+    writer(static_cast<int>(core.party.size()));
+    return writer.getSize();
+}
+
+void readImage(const uint8_t* in, JourneyCore& core) {
+    ImageReader reader(in);
+    visitCore(core, reader);
+    int size = 0;
+    reader(size);
+    // The slots are already in place; re-adding each one sets the size
+    core.party.clear();
+    for (int i = 0; i < size; ++i) {
+        PartyMember member = core.party[i];
+        core.party.add(member);
+    }
+}
+
+size_t messageCost(const std::shared_ptr<const std::string>& message) {
+    return sizeof(message) + (message ? message->size() : 0);
+}
+
+} // namespace
+
+JourneyHistory::JourneyHistory(size_t byteBudget)
+    : m_budget(byteBudget)
+    , m_ring(std::max<size_t>(byteBudget, 1))
+{
+}
+
+uint32_t JourneyHistory::readValue(size_t position, int bytes) const {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint32_t>(readByte(position + i)) << (8 * i);
+    }
+    return value;
+}
+
+void JourneyHistory::writeValue(size_t position, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        writeByte(position + i, static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+size_t JourneyHistory::tailPosition() const {
+    return (m_head + m_ring.size() - m_used) % m_ring.size();
+}
+
+void JourneyHistory::evictOldest() {
+    size_t tail = tailPosition();
+    size_t bodyLength = readValue(tail, 2);
+    uint8_t flags = readByte(tail + 2);
+    if (flags & STEP_CHANGED_MESSAGE) {
+        m_messageBytes -= messageCost(m_messages.front());
+        m_messages.pop_front();
+    }
+    m_used -= STEP_OVERHEAD + bodyLength;
+    m_count--;
+}
+
+void JourneyHistory::clear() {
+    m_head = 0;
+    m_used = 0;
+    m_count = 0;
+    m_messages.clear();
+    m_messageBytes = 0;
+}
+
+void JourneyHistory::record(const JourneySnapshot& before, const Journey& after) {
+    uint8_t oldBytes[MAX_IMAGE_SIZE];
+    uint8_t newBytes[MAX_IMAGE_SIZE];
+    const size_t coreSize = writeImage(before.core, oldBytes);
+    writeImage(after.getCore(), newBytes);
+
+    // Find the changed byte runs; the body is at most the whole image plus
+    // two bytes per run, so it fits on the stack
+    uint8_t body[MAX_IMAGE_SIZE * 3];
+    size_t bodyLength = 0;
+    size_t position = 0;
+    while (position < coreSize) {
+        if (oldBytes[position] == newBytes[position]) {
+            position++;
+            continue;
+        }
+        size_t start = position;
+        size_t end = position + 1;
+        size_t probe = end;
+        while (probe < coreSize && probe - start < MAX_RUN_LENGTH) {
+            if (oldBytes[probe] != newBytes[probe]) {
+                end = probe + 1;
+            } else if (probe - end >= RUN_MERGE_GAP) {
+                break;
+            }
+            probe++;
+        }
+        body[bodyLength++] = static_cast<uint8_t>(start);
+        body[bodyLength++] = static_cast<uint8_t>(end - start);
+        std::memcpy(body + bodyLength, oldBytes + start, end - start);
+        bodyLength += end - start;
+        position = end;
+    }
+
+    const std::string* afterMessage = &after.getEventMessage();
+    bool messageChanged = before.eventMessage && before.eventMessage.get() != afterMessage;
+    if (bodyLength == 0 && !messageChanged) {
+        return; // Nothing to undo
+    }
+
+    size_t stepSize = STEP_OVERHEAD + bodyLength;
+    size_t extraMessageBytes = messageChanged ? messageCost(before.eventMessage) : 0;
+    if (stepSize + extraMessageBytes > m_budget) {
+        // Cannot be undone within the budget, so nothing before it can be either
+        clear();
+        return;
+    }
+    while (m_count > 0 && m_used + m_messageBytes + stepSize + extraMessageBytes > m_budget) {
+        evictOldest();
+    }
+
+    writeValue(m_head, static_cast<uint32_t>(bodyLength), 2);
+    writeByte(m_head + 2, messageChanged ? STEP_CHANGED_MESSAGE : 0);
+    writeValue(m_head + 3, static_cast<uint32_t>(before.core.daysElapsed), 4);
+    for (size_t i = 0; i < bodyLength; ++i) {
+        writeByte(m_head + STEP_HEADER_SIZE + i, body[i]);
+    }
+    writeValue(m_head + STEP_HEADER_SIZE + bodyLength, static_cast<uint32_t>(bodyLength), 2);
+
+    m_head = (m_head + stepSize) % m_ring.size();
+    m_used += stepSize;
+    m_count++;
+
+    if (messageChanged) {
+        m_messages.push_back(before.eventMessage);
+        m_messageBytes += extraMessageBytes;
+    }
+}
+
+bool JourneyHistory::stepBack(Journey& journey) {
+    if (m_count == 0) {
+        return false;
+    }
+
+    size_t ringSize = m_ring.size();
+    size_t bodyLength = readValue((m_head + ringSize - STEP_TRAILER_SIZE) % ringSize, 2);
+    size_t stepSize = STEP_OVERHEAD + bodyLength;
+    size_t start = (m_head + ringSize - stepSize) % ringSize;
+    uint8_t flags = readByte(start + 2);
+
+    JourneySnapshot snapshot = journey.snapshot();
+    uint8_t coreBytes[MAX_IMAGE_SIZE];
+    writeImage(snapshot.core, coreBytes);
+    size_t position = start + STEP_HEADER_SIZE;
+    size_t bodyEnd = position + bodyLength;
+    while (position < bodyEnd) {
+        size_t offset = readByte(position);
+        size_t length = readByte(position + 1);
+        position += 2;
+        for (size_t i = 0; i < length; ++i) {
+            coreBytes[offset + i] = readByte(position + i);
+        }
+        position += length;
+    }
+    readImage(coreBytes, snapshot.core);
+
+    if (flags & STEP_CHANGED_MESSAGE) {
+        snapshot.eventMessage = m_messages.back();
+        m_messageBytes -= messageCost(m_messages.back());
+        m_messages.pop_back();
+    }
+    journey.restore(snapshot);
+
+    m_head = start;
+    m_used -= stepSize;
+    m_count--;
+    return true;
+}
+
+int JourneyHistory::rewindDays(Journey& journey, int days) {
+    int startDay = journey.getDaysElapsed();
+    int targetDay = startDay - days;
+    while (journey.getDaysElapsed() > targetDay && stepBack(journey)) {
+    }
+    return startDay - journey.getDaysElapsed();
+}
+
+int JourneyHistory::getOldestDay() const {
+    if (m_count == 0) {
+        return -1;
+    }
+    return static_cast<int>(readValue(tailPosition() + 3, 4));
+}
@@ -0,0 +1,57 @@
+#ifndef JOURNEY_HISTORY_HPP
+#define JOURNEY_HISTORY_HPP
+
+#include "journey.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Bounded undo history for one journey. Each input step stores only the
+// bytes of JourneyCore it changed (resources, health, miles, weather, RNG
+// state, ...) in a byte ring buffer; when the budget is exhausted the
+// oldest steps are dropped. Rewinding N days replays N small deltas
+// backwards instead of keeping a full copy of every day.
+class JourneyHistory {
+public:
+    explicit JourneyHistory(size_t byteBudget);
+
+    // Remember how to get from after back to before (one input step)
+    void record(const JourneySnapshot& before, const Journey& after);
+
+    // Undo the most recent step; false if there is nothing left to undo
+    bool stepBack(Journey& journey);
+
+    // Undo steps until the journey is at least days earlier, or the
+    // history runs out. Returns the number of days actually rewound.
+    int rewindDays(Journey& journey, int days);
+
+    void clear();
+
+    size_t getStepCount() const { return m_count; }
+    size_t getBytesUsed() const { return m_used + m_messageBytes; }
+    size_t getByteBudget() const { return m_budget; }
+    int getOldestDay() const;   // Earliest daysElapsed that can be restored
+
+private:
+    size_t tailPosition() const;
+    void evictOldest();
+    uint8_t readByte(size_t position) const { return m_ring[position % m_ring.size()]; }
+    void writeByte(size_t position, uint8_t value) { m_ring[position % m_ring.size()] = value; }
+    uint32_t readValue(size_t position, int bytes) const;
+    void writeValue(size_t position, uint32_t value, int bytes);
+
+    size_t m_budget;
+    std::vector<uint8_t> m_ring;
+    size_t m_head = 0;              // Where the next step is written
+    size_t m_used = 0;
+    size_t m_count = 0;
+
+    // Event text replaced by a step, for steps flagged as changing it
+    std::deque<std::shared_ptr<const std::string>> m_messages;
+    size_t m_messageBytes = 0;
+};
+
+#endif // JOURNEY_HISTORY_HPP
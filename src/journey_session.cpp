@@ -0,0 +1,140 @@
+#include "journey_session.hpp"
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+
+namespace {
+
+// Most graves reported for one step
+const size_t MAX_PASSED_GRAVES = 3;
+
+} // namespace
+
+JourneySession::JourneySession(Journey journey, size_t rewindBudget)
+    : m_journey(std::move(journey))
+{
+    if (rewindBudget > 0) {
+        m_history = std::make_unique<JourneyHistory>(rewindBudget);
+    }
+}
+
+JourneySession::~JourneySession() {
+    // The history goes with the session, so nothing can be rewound now
+    releaseGraves(true);
+}
+
+void JourneySession::startRecording(const std::string& directory, bool resumed) {
+    m_recorder = std::make_unique<SessionRecorder>(directory, m_journey, getRewindBudget(), resumed);
+}
+
+void JourneySession::startAutosave(AutosaveWriter& writer) {
+    m_autosave = std::make_unique<AutosaveJournal>(writer, m_journey, getRewindBudget());
+}
+
+void JourneySession::applyKey(SDL_Keycode key) {
+    if (m_recorder) {
+        m_recorder->recordKey(key);
+    }
+
+    if (key == REWIND_KEY && m_history) {
+        // The history is not saved, so a rewind cannot be replayed later
+        if (rewindDays(1) > 0 && m_autosave) {
+            m_autosave->saveSnapshot(m_journey);
+        }
+        return;
+    }
+
+    int milesBefore = m_journey.getMilesTraveled();
+    int dayBefore = m_journey.getDaysElapsed();
+    bool aliveBefore[MAX_PARTY_SIZE] = {};
+    for (size_t i = 0; i < m_journey.getParty().size(); ++i) {
+        aliveBefore[i] = m_journey.getParty()[i].isAlive;
+    }
+
+    if (!m_history) {
+        m_journey.applyKey(key);
+    } else {
+        JourneySnapshot before = m_journey.snapshot();
+        m_journey.applyKey(key);
+        m_history->record(before, m_journey);
+    }
+
+    if (m_tombstones) {
+        updateGraves(milesBefore, dayBefore, aliveBefore);
+        releaseGraves(m_journey.isGameOver() || m_journey.wantsMenu());
+    }
+
+    if (m_autosave) {
+        if (m_journey.isGameOver() || m_journey.wantsMenu()) {
+            // Finished or abandoned; nothing to come back to
+            m_autosave->discard();
+            m_autosave.reset();
+        } else {
+            m_autosave->recordKey(key, m_journey);
+        }
+    }
+}
+
+void JourneySession::updateGraves(int milesBefore, int dayBefore, const bool* aliveBefore) {
+    // Deaths happen before the day's travel, so at the mile the step began
+    const Party& party = m_journey.getParty();
+    for (size_t i = 0; i < party.size(); ++i) {
+        if (aliveBefore[i] && !party[i].isAlive) {
+            Grave grave;
+            grave.mile = milesBefore;
+            grave.timestamp = static_cast<int64_t>(std::time(nullptr));
+            grave.cause = party[i].causeOfDeath;
+            grave.name = party[i].name;
+            grave.epitaph = makeEpitaph(grave.name, grave.cause);
+            if (m_history) {
+                m_heldGraves.push_back(HeldGrave{grave, i, dayBefore});
+            } else {
+                m_tombstones->addGrave(grave);
+            }
+        }
+    }
+
+    m_passedGraves.clear();
+    int milesAfter = m_journey.getMilesTraveled();
+    if (milesAfter > milesBefore) {
+        m_passedGraves = m_tombstones->findGraves(milesBefore + 1, milesAfter, MAX_PASSED_GRAVES);
+    }
+}
+
+void JourneySession::releaseGraves(bool all) {
+    if (m_heldGraves.empty() || !m_tombstones) {
+        return;
+    }
+    // Steps that began before the oldest day in the history are gone from it
+    bool historyEmpty = !m_history || m_history->getStepCount() == 0;
+    int oldestDay = historyEmpty ? 0 : m_history->getOldestDay();
+    auto released = std::remove_if(m_heldGraves.begin(), m_heldGraves.end(), [&](const HeldGrave& held) {
+        if (!all && !historyEmpty && held.day >= oldestDay) {
+            return false;
+        }
+        m_tombstones->addGrave(held.grave);
+        return true;
+    });
+    m_heldGraves.erase(released, m_heldGraves.end());
+}
+
+int JourneySession::rewindDays(int days) {
+    if (!m_history) {
+        return 0;
+    }
+    int rewound = m_history->rewindDays(m_journey, days);
+
+    // A death whose step was rewound never happened
+    const Party& party = m_journey.getParty();
+    m_heldGraves.erase(std::remove_if(m_heldGraves.begin(), m_heldGraves.end(), [&](const HeldGrave& held) {
+        return held.member >= party.size() || party[held.member].isAlive;
+    }), m_heldGraves.end());
+
+    if (rewound > 0 && m_journey.isLogging()) {
+        std::cout << "Rewound " << rewound << " day(s) to day " << m_journey.getDaysElapsed()
+                  << " (" << m_history->getStepCount() << " steps, "
+                  << m_history->getBytesUsed() << "/" << m_history->getByteBudget()
+                  << " bytes of history left)" << std::endl;
+    }
+    return rewound;
+}
@@ -0,0 +1,80 @@
+#ifndef JOURNEY_SESSION_HPP
+#define JOURNEY_SESSION_HPP
+
+#include "autosave.hpp"
+#include "journey.hpp"
+#include "journey_history.hpp"
+#include "replay.hpp"
+#include "tombstones.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Key that rewinds one day when rewind history is enabled
+const SDL_Keycode REWIND_KEY = SDLK_BACKSPACE;
+
+// A journey being played, together with what is kept alongside it: the
+// rewind history, the session recording, the autosave journal and the
+// graves it leaves and passes. TravelState and replays both
+// go through applyKey(), so a recording that contains rewinds re-simulates
+// exactly.
+class JourneySession {
+public:
+    explicit JourneySession(Journey journey, size_t rewindBudget = 0);
+    JourneySession(JourneySession&&) = default;
+    ~JourneySession();     // Writes any graves still held
+
+    Journey& getJourney() { return m_journey; }
+    const Journey& getJourney() const { return m_journey; }
+
+    // Null when rewind is disabled
+    const JourneyHistory* getHistory() const { return m_history.get(); }
+    size_t getRewindBudget() const { return m_history ? m_history->getByteBudget() : 0; }
+
+    // resumed: the journey was loaded mid-trail (see SessionRecorder)
+    void startRecording(const std::string& directory, bool resumed = false);
+    const SessionRecorder* getRecorder() const { return m_recorder.get(); }
+
+    // Journal every step from here on; queues a snapshot of the current state
+    void startAutosave(AutosaveWriter& writer);
+
+    // Record this journey's deaths as graves, and look up the graves of
+    // earlier journeys along each stretch of trail it covers. Kept out of
+    // Journey so its state, and therefore replays, never depend on which
+    // graves happen to be in the registry. With rewind on, a grave is held
+    // until its step can no longer be rewound or the journey ends, and
+    // dropped if the step is rewound; the registry is shared, so only
+    // deaths that stand are written to it.
+    void setTombstones(TombstoneRegistry* tombstones) { m_tombstones = tombstones; }
+
+    // Graves of earlier journeys passed by the last step, nearest first
+    const std::vector<Grave>& getPassedGraves() const { return m_passedGraves; }
+
+    // One input step; REWIND_KEY rewinds a day instead when history is on
+    void applyKey(SDL_Keycode key);
+
+    // Days actually rewound (0 if disabled or out of history)
+    int rewindDays(int days);
+
+private:
+    void updateGraves(int milesBefore, int dayBefore, const bool* aliveBefore);
+    // Writes held graves whose step is out of rewind reach, or all of them
+    void releaseGraves(bool all);
+
+    struct HeldGrave {
+        Grave grave;
+        size_t member;      // Party index
+        int day;            // daysElapsed before the step that killed them
+    };
+
+    Journey m_journey;
+    std::unique_ptr<JourneyHistory> m_history;
+    std::unique_ptr<SessionRecorder> m_recorder;
+    std::unique_ptr<AutosaveJournal> m_autosave;
+    TombstoneRegistry* m_tombstones = nullptr;
+    std::vector<Grave> m_passedGraves;
+    std::vector<HeldGrave> m_heldGraves;
+};
+
+#endif // JOURNEY_SESSION_HPP
@@ -0,0 +1,98 @@
+#include "loading_state.hpp"
+#include "game.hpp"
+#include "asset_cache.hpp"
+#include "frame_arena.hpp"
+#include "job_system.hpp"
+#include "startup_profile.hpp"
+#include "frame_profiler.hpp"
+#include "text_cache.hpp"
+#include <iostream>
+
+void buildLoadingText(const PreloadProgress& progress, int windowHeight, FrameArena& frame, ScreenText& text) {
+    // Above the progress bar, which is halfway down
+    int y = windowHeight / 2;
+    text.addCentered("THE OREGON TRAIL", y - 80);
+    text.addCentered(frame.format("Loading... %zu of %zu", progress.requiredFinished, progress.requiredTotal),
+                     y - 40);
+}
+
+LoadingState::LoadingState(Game* game, const std::string& manifestPath, std::unique_ptr<GameState> next)
+    : GameState(game)
+    , m_manifestPath(manifestPath)
+    , m_next(std::move(next))
+{
+    std::cout << "LoadingState initialized with manifest: " << manifestPath << std::endl;
+}
+
+LoadingState::~LoadingState() {
+}
+
+void LoadingState::enter() {
+    std::cout << "Entering LoadingState" << std::endl;
+    if (!m_started) {
+        m_started = true;
+        m_startMilliseconds = startupMilliseconds();
+        AssetCache* assets = m_game->getAssets();
+        auto manifest = assets->getTextLines(m_manifestPath);
+        if (manifest) {
+            assets->preload(parseAssetManifest(*manifest, m_manifestPath), *m_game->getJobs());
+        } else {
+            std::cerr << "Unable to read asset manifest " << m_manifestPath << std::endl;
+        }
+    }
+}
+
+void LoadingState::exit() {
+    std::cout << "Exiting LoadingState" << std::endl;
+}
+
+void LoadingState::handleEvent(const SDL_Event& /*event*/) {
+    // Nothing to choose while loading; quitting is handled by Game
+}
+
+void LoadingState::update(float deltaTime) {
+    // Images reach the GPU in Game::run; this only waits for them
+    AssetCache* assets = m_game->getAssets();
+    if (!assets->isRequiredReady() || !m_next) {
+        return;
+    }
+
+    recordStartupPhase("required assets", m_startMilliseconds);
+    std::cout << "Required assets ready in " << startupMilliseconds() - m_startMilliseconds << " ms" << std::endl;
+    if (assets->hasPendingWork()) {
+        std::cout << "Optional assets keep loading in the background" << std::endl;
+    }
+    m_game->changeState(std::move(m_next));
+}
+
+void LoadingState::render() {
+    SDL_Renderer* renderer = m_game->getRenderer();
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    // The font is one of the things loading, so text only appears once it has
+    if (!m_font) {
+        m_font = m_game->getAssets()->getDefaultFont(16, false);
+    }
+
+    const PreloadProgress& progress = m_game->getAssets()->getPreloadProgress();
+    float fraction = progress.requiredTotal > 0
+        ? static_cast<float>(progress.requiredFinished) / progress.requiredTotal : 1.0f;
+
+    int barWidth = 400;
+    int barHeight = 20;
+    int x = (m_game->getWindowWidth() - barWidth) / 2;
+    int y = m_game->getWindowHeight() / 2;
+
+    SDL_SetRenderDrawColor(renderer, 144, 238, 144, 255);
+    SDL_Rect outline = {x, y, barWidth, barHeight};
+    countDrawCall();
+    SDL_RenderDrawRect(renderer, &outline);
+    SDL_Rect filled = {x + 2, y + 2, static_cast<int>((barWidth - 4) * fraction), barHeight - 4};
+    countDrawCall();
+    SDL_RenderFillRect(renderer, &filled);
+
+    ScreenText text;
+    buildLoadingText(progress, m_game->getWindowHeight(), m_game->getFrameArena(), text);
+    m_game->getTextCache()->draw(m_font, m_textColor, text, m_game->getWindowWidth());
+}
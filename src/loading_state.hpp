@@ -0,0 +1,45 @@
+#ifndef LOADING_STATE_HPP
+#define LOADING_STATE_HPP
+
+#include "game_state.hpp"
+#include "screen_text.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <memory>
+#include <string>
+
+class FrameArena;
+class Game;
+struct PreloadProgress;
+
+// The loading screen's text for one frame
+void buildLoadingText(const PreloadProgress& progress, int windowHeight, FrameArena& frame, ScreenText& text);
+
+// Shown at startup while the assets in a manifest load in the background;
+// hands over to the next state once every required one is ready
+class LoadingState : public GameState {
+public:
+    LoadingState(Game* game, const std::string& manifestPath, std::unique_ptr<GameState> next);
+    virtual ~LoadingState();
+
+    // GameState interface implementation
+    virtual void enter() override;
+    virtual void exit() override;
+    virtual void handleEvent(const SDL_Event& event) override;
+    virtual void update(float deltaTime) override;
+    virtual void render() override;
+    virtual bool isAnimating() const override { return true; }
+    virtual bool isLoadingScreen() const override { return true; }
+    virtual std::string getName() const override { return "LoadingState"; }
+
+private:
+    std::string m_manifestPath;
+    std::unique_ptr<GameState> m_next;
+    bool m_started = false;
+    double m_startMilliseconds = 0.0;   // Since launch
+
+    std::shared_ptr<TTF_Font> m_font;      // Once it has loaded
+    SDL_Color m_textColor = {144, 238, 144, 255}; // Light green
+};
+
+#endif // LOADING_STATE_HPP
@@ -2,23 +2,225 @@
 #include <memory>
 #include "game.hpp"
 #include "menu_state.hpp"
+#include "sweep.hpp"
+#include "batch.hpp"
+#include "columnar.hpp"
+#include "calibration.hpp"
+#include "replay.hpp"
+#include "autosave.hpp"
+#include "journey_session.hpp"
+#include "travel_state.hpp"
+#include "loading_state.hpp"
+#include "job_system.hpp"
+#include "startup_profile.hpp"
+#include "resource_pack.hpp"
+#include "state_benchmark.hpp"
+#include "heap_tracker.hpp"
+#include "frame_check.hpp"
+#include <cctype>
+#include <string>
 
 int main(int argc, char* argv[]) {
+    recordStartupMilestone("main");
     try {
+        // Headless batch tools run without opening a window
+        if (argc > 1 && std::string(argv[1]) == "--sweep") {
+            return runSweepCommand(argc - 2, argv + 2);
+        }
+        if (argc > 1 && std::string(argv[1]) == "--batch") {
+            return runBatchCommand(argc - 2, argv + 2);
+        }
+        if (argc > 1 && std::string(argv[1]) == "--query") {
+            return runQueryCommand(argc - 2, argv + 2);
+        }
+        if (argc > 1 && std::string(argv[1]) == "--replay") {
+            return runReplayCommand(argc - 2, argv + 2);
+        }
+        if (argc > 1 && std::string(argv[1]) == "--build-pack") {
+            return runPackCommand(argc - 2, argv + 2);
+        }
+        if (argc > 1 && std::string(argv[1]) == "--check-frames") {
+            return runFrameCheckCommand(argc - 2, argv + 2);
+        }
+        
+        // Optional startup phases
+        bool calibrate = false;
+        CalibrationConfig calibrationConfig;
+        std::string recordingDirectory = "recordings";
+        size_t rewindBudget = 0;
+        std::string autosaveDirectory = "autosave";
+        std::string scoresDirectory = "scores";
+        std::string savesDirectory = "saves";
+        std::string gravesDirectory = "graves";
+        int updateRate = 60;
+        int frameCap = 60;
+        bool idleWhenStatic = true;
+        float travelRate = 5.0f;
+        bool travelToggle = false;
+        size_t assetBudget = 64 * 1024 * 1024;
+        bool profileStartup = false;
+        std::string packPath;
+        bool usePack = true;
+        bool hotReload = true;
+        int benchRoundTrips = 0;
+        bool checkFrameAllocations = false;
+        bool showFrameOverlay = false;
+        std::string heapStatsPath;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--calibrate") {
+                calibrate = true;
+            } else if (arg == "--calibrate-targets" && i + 1 < argc) {
+                calibrate = true;
+                if (!parseDifficultyTargets(argv[++i], calibrationConfig.targets)) {
+                    std::cerr << "Invalid --calibrate-targets, expected e.g. Banker=0.8,Farmer=0.4" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--record-dir" && i + 1 < argc) {
+                recordingDirectory = argv[++i];
+            } else if (arg == "--no-record") {
+                recordingDirectory.clear();
+            } else if (arg == "--classroom") {
+                // Teachers can step back through recent days
+                if (rewindBudget == 0) {
+                    rewindBudget = 64 * 1024;
+                }
+            } else if (arg == "--rewind-budget" && i + 1 < argc) {
+                rewindBudget = std::stoul(argv[++i]);
+            } else if (arg == "--autosave-dir" && i + 1 < argc) {
+                autosaveDirectory = argv[++i];
+            } else if (arg == "--no-autosave") {
+                autosaveDirectory.clear();
+            } else if (arg == "--scores-dir" && i + 1 < argc) {
+                scoresDirectory = argv[++i];
+            } else if (arg == "--saves-dir" && i + 1 < argc) {
+                savesDirectory = argv[++i];
+            } else if (arg == "--graves-dir" && i + 1 < argc) {
+                gravesDirectory = argv[++i];
+            } else if (arg == "--update-rate" && i + 1 < argc) {
+                updateRate = std::stoi(argv[++i]);
+            } else if (arg == "--fps-cap" && i + 1 < argc) {
+                frameCap = std::stoi(argv[++i]);
+            } else if (arg == "--no-idle") {
+                idleWhenStatic = false;
+            } else if (arg == "--travel-rate" && i + 1 < argc) {
+                travelRate = std::stof(argv[++i]);
+            } else if (arg == "--travel-toggle") {
+                travelToggle = true;
+            } else if (arg == "--asset-budget" && i + 1 < argc) {
+                // Megabytes, so kiosks can size it to their memory
+                assetBudget = std::stoul(argv[++i]) * 1024 * 1024;
+            } else if (arg == "--profile-startup") {
+                profileStartup = true;
+            } else if (arg == "--pack-file" && i + 1 < argc) {
+                packPath = argv[++i];
+            } else if (arg == "--no-pack") {
+                usePack = false;
+            } else if (arg == "--no-hot-reload") {
+                hotReload = false;
+            } else if (arg == "--check-frame-allocs") {
+                checkFrameAllocations = true;
+            } else if (arg == "--bench-states") {
+                benchRoundTrips = 200;
+                if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                    benchRoundTrips = std::stoi(argv[++i]);
+                }
+            } else if (arg == "--frame-overlay") {
+                showFrameOverlay = true;
+            } else if (arg == "--heap-stats") {
+                // Started now, so startup is counted too
+                bool tracking = enableHeapTracking();
+                if (!tracking) {
+                    std::cerr << "--heap-stats needs a build with heap tracking (make HEAP_TRACKING=1)" << std::endl;
+                }
+                if (i + 1 < argc && argv[i + 1][0] != '-') {
+                    std::string path = argv[++i];
+                    if (tracking) {
+                        heapStatsPath = path;
+                    }
+                }
+            }
+        }
+        
+        // `make` builds the pack next to the executable, where it is found
+        // whatever directory the game is started from
+        if (packPath.empty()) {
+            char* basePath = SDL_GetBasePath();
+            if (basePath) {
+                packPath = std::string(basePath) + "oregon_trail.pack";
+                SDL_free(basePath);
+            }
+        }
+        
         auto game = std::make_unique<Game>("Oregon Trail", 800, 600);
+        game->setResourcePackPath(usePack ? packPath : "");
+        game->setHotReload(hotReload);
         
         if (!game->initialize()) {
             std::cerr << "Failed to initialize game." << std::endl;
             return 1;
         }
+        game->setRecordingDirectory(recordingDirectory);
+        game->setRewindBudget(rewindBudget);
+        game->setUpdateRate(updateRate);
+        game->setFrameCap(frameCap);
+        game->setIdleWhenStatic(idleWhenStatic);
+        game->setTravelRate(travelRate);
+        game->setTravelToggle(travelToggle);
+        game->setAssetBudget(assetBudget);
+        game->setProfileStartup(profileStartup);
+        game->setCheckFrameAllocations(checkFrameAllocations);
+        game->setShowFrameOverlay(showFrameOverlay);
+        if (!heapStatsPath.empty()) {
+            game->setHeapStatsPath(heapStatsPath);
+        }
+        
+        // Kept for the whole game; every return to the menu re-enters it
+        Game* gamePtr = game.get();
+        game->registerState(MENU_STATE_NAME, [gamePtr] { return std::make_unique<MenuState>(gamePtr); });
+        
+        if (benchRoundTrips > 0) {
+            return runStateBenchmark(*game, benchRoundTrips);
+        }
+        
+        // Each reads its own directory, so they open side by side
+        JobGroup stores;
+        JobSystem* jobs = game->getJobs();
+        jobs->run(stores, [&] { game->openHighScores(scoresDirectory); });
+        jobs->run(stores, [&] { game->openSaveSlots(savesDirectory); });
+        jobs->run(stores, [&] { game->openTombstones(gravesDirectory); });
+        
+        if (calibrate) {
+            for (const auto& result : calibrateDifficulty(game->getTrail(), calibrationConfig)) {
+                game->setSimParams(result.profession, result.params);
+            }
+        }
+        
+        // Pick up a journey cut short by a crash or power loss
+        std::unique_ptr<JourneySession> recovered;
+        if (!autosaveDirectory.empty()) {
+            StartupTimer timer("autosave recovery");
+            recovered = recoverAutosave(autosaveDirectory, game->getTrail());
+            game->startAutosave(autosaveDirectory);
+        }
+        jobs->wait(stores);
+        
+        std::unique_ptr<GameState> firstState;
+        if (recovered) {
+            firstState = std::make_unique<TravelState>(game.get(), std::move(*recovered));
+        } else {
+            // The initial menu state
+            firstState = game->acquireState(MENU_STATE_NAME);
+        }
         
-        // Create and push the initial menu state
-        auto menuState = std::make_unique<MenuState>(game.get());
-        game->pushState(std::move(menuState));
+        // Shown until the assets the first state needs have loaded
+        game->pushState(std::make_unique<LoadingState>(game.get(), "resources/data/assets.txt",
+                                                       std::move(firstState)));
         
         game->run();
         
-        return 0;
+        // A steady frame that allocated fails the check
+        return game->getAllocatingFrameCount() > 0 ? 1 : 0;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
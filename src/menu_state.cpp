@@ -1,16 +1,50 @@
 #include "menu_state.hpp"
 #include "game.hpp"
+#include "asset_cache.hpp"
+#include "frame_arena.hpp"
 #include "info_state.hpp"
-#include <fstream>
+#include "travel_state.hpp"
+#include "high_scores.hpp"
+#include "slot_state.hpp"
+#include "text_cache.hpp"
+#include <ctime>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <SDL2/SDL.h>
 
 #include <iostream>
 
+namespace {
+
+const char* const MENU_TEXT_PATH = "resources/text/menu.txt";
+const char* const INTRO_TEXT_PATH = "resources/text/intro.txt";
+
+} // namespace
+
+void buildMenuText(const std::vector<std::string>& introText, const std::vector<std::string>& options,
+                   int selected, FrameArena& frame, ScreenText& text) {
+    text.addCentered("THE OREGON TRAIL", 50);
+    
+    int y = 100;
+    for (const auto& line : introText) {
+        text.add(line.c_str(), 50, y);
+        y += 20;
+    }
+    
+    y = 300;
+    for (size_t i = 0; i < options.size(); ++i) {
+        const char* prefix = (i == static_cast<size_t>(selected)) ? "> " : "  ";
+        text.add(frame.format("%s%s", prefix, options[i].c_str()), 200, y);
+        y += 30;
+    }
+    
+    text.addCentered("Use arrow keys to select, Enter to choose", 550);
+}
+
 MenuState::MenuState(Game* game)
     : GameState(game)
     , m_selectedOption(0)
-    , m_font(nullptr)
 {
     // Set Apple II style green text color
     m_textColor = {144, 238, 144, 255}; // Light green
@@ -18,64 +52,37 @@ MenuState::MenuState(Game* game)
 }
 
 MenuState::~MenuState() {
-    if (m_font) {
-        TTF_CloseFont(m_font);
-        m_font = nullptr;
-    }
 }
 
 void MenuState::enter() {
     std::cout << "Entering MenuState" << std::endl;
-    // Load font if not already loaded
+    m_selectedOption = 0;
+    
+    // Shared with every other state; only the first one to ask loads it
     if (!m_font) {
-        std::cout << "Attempting to load font from assets/fonts/apple2.ttf" << std::endl;
-        m_font = TTF_OpenFont("assets/fonts/apple2.ttf", 16);
-        if (!m_font) {
-            std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
-            std::cout << "Trying fallback font..." << std::endl;
-            
-            // Try multiple fallback fonts
-            const char* fallbackFonts[] = {
-                "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
-                "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
-                "/usr/share/fonts/truetype/liberation/LiberationMono-Regular.ttf",
-                nullptr
-            };
-            
-            for (int i = 0; fallbackFonts[i] != nullptr; i++) {
-                std::cout << "Trying fallback font: " << fallbackFonts[i] << std::endl;
-                m_font = TTF_OpenFont(fallbackFonts[i], 16);
-                if (m_font) {
-                    std::cout << "Successfully loaded fallback font: " << fallbackFonts[i] << std::endl;
-                    break;
-                }
-            }
-            
-            if (!m_font) {
-                std::cerr << "Failed to load any fallback font: " << TTF_GetError() << std::endl;
-                // Continue without a font - we'll handle this in the render methods
-            }
-        } else {
-            std::cout << "Successfully loaded apple2.ttf font" << std::endl;
-        }
+        m_font = m_game->getAssets()->getDefaultFont(16);
     }
     
-    // Load menu text and intro
-    loadMenuText();
-    loadIntroText();
+    // Read on the first visit only; the menu is kept between visits, and
+    // edits to either file reach it through the reload hooks (only that
+    // one is parsed again)
+    if (!m_textLoaded) {
+        loadMenuText();
+        loadIntroText();
+        AssetCache* assets = m_game->getAssets();
+        assets->onReload(MENU_TEXT_PATH, getLifetime(), [this] { loadMenuText(); });
+        assets->onReload(INTRO_TEXT_PATH, getLifetime(), [this] { loadIntroText(); });
+        m_textLoaded = true;
+    }
 }
 
 void MenuState::loadIntroText() {
     m_introText.clear();
     
-    // Try to load from file
-    std::ifstream introFile("resources/text/intro.txt");
-    if (introFile.is_open()) {
-        std::string line;
-        while (std::getline(introFile, line)) {
-            m_introText.push_back(line);
-        }
-        introFile.close();
+    // Read once per game, not on every return to the menu
+    auto lines = m_game->getAssets()->getTextLines(INTRO_TEXT_PATH);
+    if (lines) {
+        m_introText = *lines;
     }
     
     // If file load failed or file was empty, use default intro text
@@ -109,86 +116,76 @@ void MenuState::render() {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
     
-    // Render title
-    renderTextCentered("THE OREGON TRAIL", 50);
-    
-    // Render intro text
-    int y = 100;
-    for (const auto& line : m_introText) {
-        renderText(line, 50, y);
-        y += 20;
-    }
-    
-    // Render menu options
-    y = 300;
-    for (size_t i = 0; i < m_menuOptions.size(); ++i) {
-        std::string prefix = (i == static_cast<size_t>(m_selectedOption)) ? "> " : "  ";
-        renderText(prefix + m_menuOptions[i], 200, y);
-        y += 30;
-    }
-    
-    // Instruction text at bottom
-    renderTextCentered("Use arrow keys to select, Enter to choose", 550);
+    ScreenText text;
+    buildMenuText(m_introText, m_menuOptions, m_selectedOption, m_game->getFrameArena(), text);
+    m_game->getTextCache()->draw(m_font, m_textColor, text, m_game->getWindowWidth());
 }
 
 void MenuState::loadMenuText() {
     m_menuOptions.clear();
     
-    // Try to load from file
-    std::ifstream menuFile("resources/text/menu.txt");
-    if (menuFile.is_open()) {
-        std::string line;
-        while (std::getline(menuFile, line)) {
+    // Read once per game, not on every return to the menu
+    auto lines = m_game->getAssets()->getTextLines(MENU_TEXT_PATH);
+    if (lines) {
+        for (const std::string& line : *lines) {
             if (!line.empty()) {
                 m_menuOptions.push_back(line);
             }
         }
-        menuFile.close();
     }
     
     // If file load failed or file was empty, use default menu options
     if (m_menuOptions.empty()) {
         m_menuOptions = {
             "Travel the trail",
+            "Continue a saved journey",
             "Learn about the trail",
             "See the high scores",
             "Choose your profession",
             "Exit"
         };
     }
-}
-
-void MenuState::renderText(const std::string& text, int x, int y) {
-    if (text.empty()) {
-        return;
-    }
     
-    if (!m_font) {
-        std::cerr << "Cannot render text '" << text << "': font not loaded" << std::endl;
-        return;
+    // The file may have been edited down to fewer options
+    if (m_selectedOption >= static_cast<int>(m_menuOptions.size())) {
+        m_selectedOption = static_cast<int>(m_menuOptions.size()) - 1;
     }
-    
-    SDL_Surface* textSurface = TTF_RenderText_Solid(m_font, text.c_str(), m_textColor);
-    if (!textSurface) {
-        std::cerr << "Unable to render text surface: " << TTF_GetError() << std::endl;
-        return;
+}
+
+std::string MenuState::getHighScoreText() const {
+    std::vector<HighScoreEntry> scores;
+    if (m_game->getHighScores()) {
+        scores = m_game->getHighScores()->getTop(10);
     }
     
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(m_game->getRenderer(), textSurface);
-    if (!textTexture) {
-        std::cerr << "Unable to create texture from rendered text: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(textSurface);
-        return;
+    std::ostringstream text;
+    if (scores.empty()) {
+        text << "No high scores available yet.\n\n"
+             << "Complete a journey to record your score!\n\n";
+    } else {
+        text << "Rank  Score  Profession  Days  Survivors  Date\n\n";
+        for (size_t i = 0; i < scores.size(); ++i) {
+            const HighScoreEntry& entry = scores[i];
+            std::time_t when = static_cast<std::time_t>(entry.timestamp);
+            char date[16] = "";
+            std::strftime(date, sizeof(date), "%Y-%m-%d", std::localtime(&when));
+            text << std::left << std::setw(6) << (std::to_string(i + 1) + ".")
+                 << std::right << std::setw(5) << entry.score << "  "
+                 << std::left << std::setw(12) << entry.profession
+                 << std::right << std::setw(4) << entry.daysElapsed
+                 << std::setw(11) << entry.survivors << "  "
+                 << date << "\n";
+        }
+        text << "\n";
     }
-    
-    SDL_Rect renderQuad = { x, y, textSurface->w, textSurface->h };
-    SDL_RenderCopy(m_game->getRenderer(), textTexture, nullptr, &renderQuad);
-    
-    SDL_FreeSurface(textSurface);
-    SDL_DestroyTexture(textTexture);
+    text << "Scoring is based on:\n"
+         << "- Health of the party members who survive\n"
+         << "- Resources and cash remaining\n"
+         << "- Days taken to complete the journey\n"
+         << "- Profession difficulty (Carpenter x2, Farmer x3)";
+    return text.str();
 }
 
-
 void MenuState::handleMenuSelection() {
     std::cout << "Selected option: " << m_selectedOption << " - " 
               << (m_selectedOption < static_cast<int>(m_menuOptions.size()) ? m_menuOptions[m_selectedOption] : "Unknown") 
@@ -196,27 +193,22 @@ void MenuState::handleMenuSelection() {
 
     switch(m_selectedOption) {
         case 0: // Travel the trail
-            std::cout << "Travel the trail selected - Creating placeholder TravelState" << std::endl;
+            std::cout << "Travel the trail selected - Creating TravelState" << std::endl;
             {
-                // Create a placeholder state with "Not Implemented" message
-                auto travelState = std::make_unique<InfoState>(
-                    m_game, 
-                    "Travel the Trail", 
-                    "This feature is coming soon!\n\n"
-                    "The full travel simulation will include:\n"
-                    "- Daily travel progress\n"
-                    "- Resource management\n"
-                    "- Weather effects\n"
-                    "- River crossings\n"
-                    "- Health and illness\n"
-                    "- Random events\n\n"
-                    "Check back in a future update!"
-                );
+                auto travelState = std::make_unique<TravelState>(m_game, "Banker");
                 m_game->changeState(std::move(travelState));
             }
             break;
             
-        case 1: // Learn about the trail
+        case 1: // Continue a saved journey
+            std::cout << "Continue a saved journey selected - Creating SlotState" << std::endl;
+            {
+                auto slotState = std::make_unique<SlotState>(m_game);
+                m_game->changeState(std::move(slotState));
+            }
+            break;
+            
+        case 2: // Learn about the trail
             std::cout << "Learn about the trail selected - Creating LearnState" << std::endl;
             {
                 // Create an info state with Oregon Trail information
@@ -247,26 +239,19 @@ void MenuState::handleMenuSelection() {
             }
             break;
             
-        case 2: // See the high scores
+        case 3: // See the high scores
             std::cout << "See the high scores selected - Creating HighScoreState" << std::endl;
             {
                 auto highScoreState = std::make_unique<InfoState>(
                     m_game, 
                     "High Scores", 
-                    "No high scores available yet.\n\n"
-                    "Complete a journey to record your score!\n\n"
-                    "Scoring is based on:\n"
-                    "- Number of party members who survive\n"
-                    "- Resources remaining\n"
-                    "- Cash remaining\n"
-                    "- Profession difficulty\n"
-                    "- Days taken to complete the journey"
+                    getHighScoreText()
                 );
                 m_game->changeState(std::move(highScoreState));
             }
             break;
             
-        case 3: // Choose your profession
+        case 4: // Choose your profession
             std::cout << "Choose your profession selected - Creating ProfessionState" << std::endl;
             {
                 auto professionState = std::make_unique<InfoState>(
@@ -287,7 +272,7 @@ void MenuState::handleMenuSelection() {
             }
             break;
             
-        case 4: // Exit
+        case 5: // Exit
             std::cout << "Exit selected" << std::endl;
             m_game->quit();
             break;
@@ -297,37 +282,6 @@ void MenuState::handleMenuSelection() {
             break;
     }
 }
-void MenuState::renderTextCentered(const std::string& text, int y) {
-    if (text.empty()) {
-        return;
-    }
-    
-    if (!m_font) {
-        std::cerr << "Cannot render centered text '" << text << "': font not loaded" << std::endl;
-        return;
-    }
-    
-    SDL_Surface* textSurface = TTF_RenderText_Solid(m_font, text.c_str(), m_textColor);
-    if (!textSurface) {
-        std::cerr << "Unable to render text surface: " << TTF_GetError() << std::endl;
-        return;
-    }
-    
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(m_game->getRenderer(), textSurface);
-    if (!textTexture) {
-        std::cerr << "Unable to create texture from rendered text: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(textSurface);
-        return;
-    }
-    
-    int x = (m_game->getWindowWidth() - textSurface->w) / 2;
-    SDL_Rect renderQuad = { x, y, textSurface->w, textSurface->h };
-    SDL_RenderCopy(m_game->getRenderer(), textTexture, nullptr, &renderQuad);
-    
-    SDL_FreeSurface(textSurface);
-    SDL_DestroyTexture(textTexture);
-}
-
 void MenuState::handleEvent(const SDL_Event& event) {
     std::cout << "MenuState handling event: " << event.type << std::endl;
     
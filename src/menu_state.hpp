@@ -2,10 +2,22 @@
 #define MENU_STATE_HPP
 
 #include "game_state.hpp"
+#include "screen_text.hpp"
 #include <vector>
+#include <memory>
 #include <string>
 #include <SDL2/SDL_ttf.h>
 
+// Registered with Game::registerState under this name; every return to the
+// menu re-enters the one instance
+const char* const MENU_STATE_NAME = "menu";
+
+class FrameArena;
+
+// The menu's text for one frame, with the selected option marked
+void buildMenuText(const std::vector<std::string>& introText, const std::vector<std::string>& options,
+                   int selected, FrameArena& frame, ScreenText& text);
+
 class MenuState : public GameState {
 public:
     MenuState(Game* game);
@@ -24,17 +36,17 @@ private:
     std::vector<std::string> m_menuOptions;
     std::vector<std::string> m_introText;
     int m_selectedOption;
+    bool m_textLoaded = false;      // Menu and intro text read, and reloads hooked up
     
     // Text rendering
-    TTF_Font* m_font;
+    std::shared_ptr<TTF_Font> m_font;
     SDL_Color m_textColor;
     
     // Helper methods
     void loadMenuText();
     void loadIntroText();
-    void renderText(const std::string& text, int x, int y);
-    void renderTextCentered(const std::string& text, int y);
     void handleMenuSelection();
+    std::string getHighScoreText() const;
 };
 
 #endif // MENU_STATE_HPP
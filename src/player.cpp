@@ -10,7 +10,7 @@ Player::Player(const std::string& name)
     , m_spareWagonParts(0)
 {
     // Add player as first party member
-    m_partyMembers.emplace_back(name);
+    m_partyNames.emplace_back(name);
     
     // Set starting resources based on profession
     setProfession(Profession::BANKER);
@@ -39,8 +39,8 @@ void Player::setProfession(Profession profession) {
 
 void Player::addPartyMember(const std::string& name) {
     // Maximum party size is 5 (player + 4 others)
-    if (m_partyMembers.size() < 5) {
-        m_partyMembers.emplace_back(name);
+    if (m_partyNames.size() < 5) {
+        m_partyNames.emplace_back(name);
     }
 }
 
@@ -13,15 +13,6 @@ enum class Profession {
     FARMER
 };
 
-struct PartyMember {
-    std::string name;
-    int health;
-    bool isAlive;
-    
-    PartyMember(const std::string& memberName) 
-        : name(memberName), health(100), isAlive(true) {}
-};
-
 class Player {
 public:
     Player(const std::string& name);
@@ -55,7 +46,7 @@ private:
     int m_clothing;
     int m_spareWagonParts;
     
-    std::vector<PartyMember> m_partyMembers;
+    std::vector<std::string> m_partyNames;
 };
 
 #endif // PLAYER_HPP
@@ -0,0 +1,615 @@
+#include "replay.hpp"
+#include "journey_session.hpp"
+#include "stats.hpp"
+#include "work_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char* const RECORDING_EXTENSION = ".otr";
+const int MAX_REPLAY_KEYS = 100000;
+
+// Deaths: where on the trail people die, and of what
+
+class DeathReducer : public ReplayReducer {
+public:
+    const char* getName() const override { return "deaths"; }
+
+    void beginSession(const Journey& journey) override {
+        if (m_places.empty()) {
+            for (const auto& location : journey.getLandmarks()) {
+                m_places.push_back(location.name);
+            }
+            m_byPlace.resize(m_places.size());
+        }
+        m_sessions++;
+    }
+
+    void step(const ReplayStep& before, const Journey& after) override {
+        const Party& party = after.getParty();
+        for (size_t i = 0; i < party.size() && i < 32; ++i) {
+            if (!(before.aliveMask & (1u << i)) || party[i].isAlive) {
+                continue;
+            }
+            // Deaths happen on the way to the next landmark, so they are
+            // charged to the stretch after the last one reached
+            size_t place = static_cast<size_t>(before.landmarkIndex);
+            if (place >= m_byPlace.size()) {
+                m_byPlace.resize(place + 1);
+            }
+            m_byPlace[place][static_cast<int>(party[i].causeOfDeath)]++;
+            m_deathMiles.add(after.getMilesTraveled());
+            m_deathDays.add(after.getDaysElapsed());
+        }
+    }
+
+    void endSession(const Journey& journey) override {
+        if (journey.getAliveCount() == 0) {
+            m_wipedOut++;
+        }
+    }
+
+    void merge(const ReplayReducer& other) override {
+        const DeathReducer& rhs = static_cast<const DeathReducer&>(other);
+        if (m_places.empty()) {
+            m_places = rhs.m_places;
+        }
+        if (m_byPlace.size() < rhs.m_byPlace.size()) {
+            m_byPlace.resize(rhs.m_byPlace.size());
+        }
+        for (size_t place = 0; place < rhs.m_byPlace.size(); ++place) {
+            for (int cause = 0; cause < DEATH_CAUSE_COUNT; ++cause) {
+                m_byPlace[place][cause] += rhs.m_byPlace[place][cause];
+            }
+        }
+        m_deathMiles.merge(rhs.m_deathMiles);
+        m_deathDays.merge(rhs.m_deathDays);
+        m_sessions += rhs.m_sessions;
+        m_wipedOut += rhs.m_wipedOut;
+    }
+
+    void report(std::ostream& out) const override {
+        out << "Deaths: " << m_deathMiles.getCount() << " over " << m_sessions << " sessions, "
+            << m_wipedOut << " parties lost entirely\n";
+        if (m_deathMiles.getCount() > 0) {
+            out << "  mile of death p10/p50/p90: " << m_deathMiles.quantile(0.1) << " / "
+                << m_deathMiles.quantile(0.5) << " / " << m_deathMiles.quantile(0.9) << "\n";
+            out << "  day of death p10/p50/p90:  " << m_deathDays.quantile(0.1) << " / "
+                << m_deathDays.quantile(0.5) << " / " << m_deathDays.quantile(0.9) << "\n";
+        }
+        for (size_t place = 0; place < m_byPlace.size(); ++place) {
+            uint64_t total = 0;
+            for (uint64_t count : m_byPlace[place]) {
+                total += count;
+            }
+            if (total == 0) {
+                continue;
+            }
+            out << "  after " << (place < m_places.size() ? m_places[place] : "?") << ": " << total;
+            for (int cause = 1; cause < DEATH_CAUSE_COUNT; ++cause) {
+                if (m_byPlace[place][cause] > 0) {
+                    out << " " << getDeathCauseName(static_cast<DeathCause>(cause)) << "=" << m_byPlace[place][cause];
+                }
+            }
+            out << "\n";
+        }
+    }
+
+private:
+    std::vector<std::string> m_places;
+    std::vector<std::array<uint64_t, DEATH_CAUSE_COUNT>> m_byPlace;
+    HdrHistogram m_deathMiles{7, 1 << 20};
+    HdrHistogram m_deathDays{7, 100000};
+    uint64_t m_sessions = 0;
+    uint64_t m_wipedOut = 0;
+};
+
+// Rivers: which crossing option players pick at each river
+
+class RiverReducer : public ReplayReducer {
+public:
+    static const int OPTION_COUNT = 4;
+
+    const char* getName() const override { return "rivers"; }
+
+    void beginSession(const Journey& journey) override {
+        if (m_rivers.empty()) {
+            for (const auto& location : journey.getLandmarks()) {
+                m_rivers.push_back(location.isRiver ? location.name : std::string());
+            }
+            m_choices.resize(m_rivers.size());
+        }
+    }
+
+    void step(const ReplayStep& before, const Journey& after) override {
+        if (before.subState != TravelSubState::River) {
+            return;
+        }
+        int option = before.key - SDLK_1;
+        if (option < 0 || option >= OPTION_COUNT) {
+            return;
+        }
+        size_t river = static_cast<size_t>(before.landmarkIndex);
+        if (river >= m_choices.size()) {
+            m_choices.resize(river + 1);
+        }
+        RiverCounts& counts = m_choices[river];
+        counts.picked[option]++;
+
+        int lost = 0;
+        const Party& party = after.getParty();
+        for (size_t i = 0; i < party.size() && i < 32; ++i) {
+            if ((before.aliveMask & (1u << i)) && !party[i].isAlive) {
+                lost++;
+            }
+        }
+        counts.drowned[option] += lost;
+    }
+
+    void merge(const ReplayReducer& other) override {
+        const RiverReducer& rhs = static_cast<const RiverReducer&>(other);
+        if (m_rivers.empty()) {
+            m_rivers = rhs.m_rivers;
+        }
+        if (m_choices.size() < rhs.m_choices.size()) {
+            m_choices.resize(rhs.m_choices.size());
+        }
+        for (size_t river = 0; river < rhs.m_choices.size(); ++river) {
+            for (int option = 0; option < OPTION_COUNT; ++option) {
+                m_choices[river].picked[option] += rhs.m_choices[river].picked[option];
+                m_choices[river].drowned[option] += rhs.m_choices[river].drowned[option];
+            }
+        }
+    }
+
+    void report(std::ostream& out) const override {
+        static const char* const optionNames[OPTION_COUNT] = {"ford", "caulk", "guide", "wait"};
+        out << "River choices (picked, deaths):\n";
+        for (size_t river = 0; river < m_choices.size(); ++river) {
+            uint64_t total = 0;
+            for (uint64_t count : m_choices[river].picked) {
+                total += count;
+            }
+            if (total == 0) {
+                continue;
+            }
+            out << "  " << (river < m_rivers.size() ? m_rivers[river] : "?") << ":";
+            for (int option = 0; option < OPTION_COUNT; ++option) {
+                out << " " << optionNames[option] << "=" << m_choices[river].picked[option]
+                    << " (" << std::fixed << std::setprecision(0)
+                    << 100.0 * m_choices[river].picked[option] / total << "%, "
+                    << m_choices[river].drowned[option] << ")";
+            }
+            out << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+    }
+
+private:
+    struct RiverCounts {
+        uint64_t picked[OPTION_COUNT] = {};
+        uint64_t drowned[OPTION_COUNT] = {};
+    };
+
+    std::vector<std::string> m_rivers;
+    std::vector<RiverCounts> m_choices;
+};
+
+// Rest: how often and how long players rest
+
+class RestReducer : public ReplayReducer {
+public:
+    const char* getName() const override { return "rest"; }
+
+    void beginSession(const Journey& journey) override {
+        (void)journey;
+        m_sessionRestDays = 0;
+        m_sessionRests = 0;
+    }
+
+    void step(const ReplayStep& before, const Journey& after) override {
+        if (before.subState != TravelSubState::Resting) {
+            return;
+        }
+        int days = after.getDaysElapsed() - before.daysElapsed;
+        if (days <= 0) {
+            return;
+        }
+        m_restLength.add(days);
+        m_restMiles.add(before.milesTraveled);
+        m_sessionRestDays += days;
+        m_sessionRests++;
+    }
+
+    void endSession(const Journey& journey) override {
+        (void)journey;
+        m_restDaysPerSession.add(m_sessionRestDays);
+        m_restsPerSession.add(m_sessionRests);
+    }
+
+    void merge(const ReplayReducer& other) override {
+        const RestReducer& rhs = static_cast<const RestReducer&>(other);
+        m_restLength.merge(rhs.m_restLength);
+        m_restMiles.merge(rhs.m_restMiles);
+        m_restDaysPerSession.merge(rhs.m_restDaysPerSession);
+        m_restsPerSession.merge(rhs.m_restsPerSession);
+    }
+
+    void report(std::ostream& out) const override {
+        out << "Rest: " << m_restLength.getCount() << " stops, mean " << m_restLength.getMean() << " days\n";
+        if (m_restsPerSession.getCount() > 0) {
+            out << "  stops per session p50/p90: " << m_restsPerSession.quantile(0.5) << " / "
+                << m_restsPerSession.quantile(0.9) << "\n";
+            out << "  rest days per session p50/p90/max: " << m_restDaysPerSession.quantile(0.5) << " / "
+                << m_restDaysPerSession.quantile(0.9) << " / " << m_restDaysPerSession.getMax() << "\n";
+        }
+        if (m_restMiles.getCount() > 0) {
+            out << "  mile of rest p10/p50/p90: " << m_restMiles.quantile(0.1) << " / "
+                << m_restMiles.quantile(0.5) << " / " << m_restMiles.quantile(0.9) << "\n";
+        }
+    }
+
+private:
+    HdrHistogram m_restLength{7, 1000};
+    HdrHistogram m_restMiles{7, 1 << 20};
+    HdrHistogram m_restDaysPerSession{7, 100000};
+    HdrHistogram m_restsPerSession{7, 100000};
+    int m_sessionRestDays = 0;
+    int m_sessionRests = 0;
+};
+
+std::string hexString(uint64_t value) {
+    std::ostringstream out;
+    out << std::hex << std::setw(16) << std::setfill('0') << value;
+    return out.str();
+}
+
+std::string hexBytes(const std::string& bytes) {
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (unsigned char byte : bytes) {
+        hex += DIGITS[byte >> 4];
+        hex += DIGITS[byte & 0x0f];
+    }
+    return hex;
+}
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+// Empty if the text is not whole hex bytes
+std::string bytesFromHex(const std::string& hex) {
+    if (hex.size() % 2 != 0) {
+        return std::string();
+    }
+    std::string bytes;
+    bytes.reserve(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        int high = hexDigit(hex[i]);
+        int low = hexDigit(hex[i + 1]);
+        if (high < 0 || low < 0) {
+            return std::string();
+        }
+        bytes += static_cast<char>(high * 16 + low);
+    }
+    return bytes;
+}
+
+ReplayStep captureStep(const Journey& journey, SDL_Keycode key) {
+    ReplayStep step;
+    step.key = key;
+    step.subState = journey.getSubState();
+    step.landmarkIndex = std::max(0, journey.getNextLandmarkIndex() - 1);
+    step.milesTraveled = journey.getMilesTraveled();
+    step.daysElapsed = journey.getDaysElapsed();
+    const Party& party = journey.getParty();
+    for (size_t i = 0; i < party.size() && i < 32; ++i) {
+        if (party[i].isAlive) {
+            step.aliveMask |= 1u << i;
+        }
+    }
+    return step;
+}
+
+void collectRecordings(const std::string& path, std::vector<std::string>& files) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    if (fs::is_directory(path, error)) {
+        for (fs::recursive_directory_iterator it(path, error), end; it != end; it.increment(error)) {
+            if (it->is_regular_file(error) && it->path().extension() == RECORDING_EXTENSION) {
+                files.push_back(it->path().string());
+            }
+        }
+    } else {
+        files.push_back(path);
+    }
+}
+
+void printReplayUsage() {
+    std::cout << "Usage: oregon_trail --replay <file-or-directory>... [options]\n"
+              << "  --reducers <list>          Any of deaths,rivers,rest (default: all)\n"
+              << "  --trail <file>             Trail the sessions were played on\n"
+              << "  --threads <n>              Worker threads (default: all cores)" << std::endl;
+}
+
+} // namespace
+
+// Header
+
+void writeReplayHeader(std::ostream& out, const Journey& journey, size_t rewindBudget) {
+    out << "profession " << journey.getProfession() << "\n"
+        << "seed " << journey.getSeed() << "\n"
+        << "trail " << hexString(journey.getTrail().hash) << "\n"
+        << "rewind " << rewindBudget << "\n";
+    std::streamsize precision = out.precision(17);
+    for (const auto& info : simParamTable()) {
+        out << "param " << info.name << " " << info.get(journey.getParams()) << "\n";
+    }
+    out.precision(precision);
+}
+
+void parseReplayHeaderLine(const std::string& line, ReplayHeader& header) {
+    std::istringstream fields(line);
+    std::string field;
+    fields >> field;
+    if (field == "profession") {
+        fields >> header.profession;
+    } else if (field == "seed") {
+        fields >> header.seed;
+    } else if (field == "trail") {
+        fields >> std::hex >> header.trailHash;
+    } else if (field == "rewind") {
+        fields >> header.rewindBudget;
+    } else if (field == "param") {
+        std::string name;
+        double value = 0.0;
+        fields >> name >> value;
+        if (const SimParamInfo* info = findSimParam(name)) {
+            info->set(header.params, value);
+        }
+    } else if (field == "state") {
+        std::string hex;
+        fields >> hex;
+        header.resumed = true;
+        header.startState = bytesFromHex(hex);
+    }
+}
+
+// SessionRecorder
+
+SessionRecorder::SessionRecorder(const std::string& directory, const Journey& journey, size_t rewindBudget,
+                                 bool resumed) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    std::ostringstream name;
+    name << directory << "/session-" << std::time(nullptr) << "-" << journey.getSeed() << RECORDING_EXTENSION;
+    m_path = name.str();
+
+    m_out.open(m_path);
+    if (!m_out.is_open()) {
+        std::cerr << "Unable to record session to " << m_path << std::endl;
+        return;
+    }
+
+    m_out << "OTREC 1\n";
+    writeReplayHeader(m_out, journey, rewindBudget);
+    if (resumed) {
+        m_out << "state " << hexBytes(journey.saveState()) << "\n";
+    }
+    m_out << "keys" << std::endl;
+    std::cout << "Recording session to " << m_path << std::endl;
+}
+
+void SessionRecorder::recordKey(SDL_Keycode key) {
+    if (m_out.is_open()) {
+        // Flushed per key so an interrupted session is still replayable
+        m_out << key << std::endl;
+    }
+}
+
+// ReplayReader
+
+bool ReplayReader::open(const std::string& path) {
+    m_in.open(path);
+    if (!m_in.is_open()) {
+        std::cerr << "Unable to open recording: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(m_in, line) || line != "OTREC 1") {
+        std::cerr << "Not a session recording: " << path << std::endl;
+        return false;
+    }
+
+    while (std::getline(m_in, line)) {
+        if (line == "keys") {
+            return true;
+        }
+        parseReplayHeaderLine(line, m_header);
+    }
+
+    std::cerr << "Recording has no key section: " << path << std::endl;
+    return false;
+}
+
+bool ReplayReader::nextKey(SDL_Keycode& key) {
+    long long value;
+    if (!(m_in >> value)) {
+        return false;
+    }
+    key = static_cast<SDL_Keycode>(value);
+    return true;
+}
+
+// Reducers
+
+std::unique_ptr<ReplayReducer> createReplayReducer(const std::string& name) {
+    if (name == "deaths") {
+        return std::unique_ptr<ReplayReducer>(new DeathReducer());
+    }
+    if (name == "rivers") {
+        return std::unique_ptr<ReplayReducer>(new RiverReducer());
+    }
+    if (name == "rest") {
+        return std::unique_ptr<ReplayReducer>(new RestReducer());
+    }
+    return nullptr;
+}
+
+bool replaySession(ReplayReader& reader, std::shared_ptr<const TrailData> trail,
+                   const std::vector<std::unique_ptr<ReplayReducer>>& reducers) {
+    const ReplayHeader& header = reader.getHeader();
+    if (trail && header.trailHash != trail->hash) {
+        return false;
+    }
+
+    JourneySession session(Journey(header.profession, header.seed, header.params, std::move(trail)),
+                           header.rewindBudget);
+    Journey& journey = session.getJourney();
+    journey.setLogging(false);
+    if (!header.resumed) {
+        journey.setupInitialJourney();
+    } else if (!journey.loadState(header.startState)) {
+        return false;
+    }
+
+    for (const auto& reducer : reducers) {
+        reducer->beginSession(journey);
+    }
+
+    SDL_Keycode key;
+    for (int keys = 0; keys < MAX_REPLAY_KEYS && reader.nextKey(key); ++keys) {
+        ReplayStep before = captureStep(journey, key);
+        session.applyKey(key);
+        for (const auto& reducer : reducers) {
+            reducer->step(before, journey);
+        }
+        if (journey.isGameOver() || journey.wantsMenu()) {
+            break;
+        }
+    }
+
+    for (const auto& reducer : reducers) {
+        reducer->endSession(journey);
+    }
+    return true;
+}
+
+int runReplayCommand(int argc, char* argv[]) {
+    std::vector<std::string> paths;
+    std::vector<std::string> reducerNames = {"deaths", "rivers", "rest"};
+    std::string trailPath = "resources/data/trail.txt";
+    unsigned threads = 0;
+
+    try {
+        for (int i = 0; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--reducers" && hasValue) {
+                reducerNames.clear();
+                std::istringstream list(argv[++i]);
+                std::string name;
+                while (std::getline(list, name, ',')) {
+                    reducerNames.push_back(name);
+                }
+            } else if (arg == "--trail" && hasValue) {
+                trailPath = argv[++i];
+            } else if (arg == "--threads" && hasValue) {
+                threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg.compare(0, 2, "--") == 0) {
+                std::cerr << "Unknown replay option: " << arg << std::endl;
+                printReplayUsage();
+                return 1;
+            } else {
+                paths.push_back(arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid replay option value: " << e.what() << std::endl;
+        printReplayUsage();
+        return 1;
+    }
+
+    if (paths.empty()) {
+        printReplayUsage();
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    for (const auto& path : paths) {
+        collectRecordings(path, files);
+    }
+
+    std::shared_ptr<const TrailData> trail = loadTrailData(trailPath);
+    WorkStealingPool pool(threads);
+
+    // One reducer set per worker, so replays never contend on shared state
+    std::vector<std::vector<std::unique_ptr<ReplayReducer>>> workerReducers(pool.getWorkerCount());
+    for (auto& reducers : workerReducers) {
+        for (const auto& name : reducerNames) {
+            std::unique_ptr<ReplayReducer> reducer = createReplayReducer(name);
+            if (!reducer) {
+                std::cerr << "Unknown reducer: " << name << std::endl;
+                printReplayUsage();
+                return 1;
+            }
+            reducers.push_back(std::move(reducer));
+        }
+    }
+
+    std::cout << "Replaying " << files.size() << " sessions on " << pool.getWorkerCount()
+              << " threads" << std::endl;
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::atomic<size_t> replayed(0);
+    std::atomic<size_t> skipped(0);
+
+    for (const auto& file : files) {
+        pool.submit([&, file]() {
+            ReplayReader reader;
+            const auto& reducers = workerReducers[WorkStealingPool::currentWorker()];
+            if (reader.open(file) && replaySession(reader, trail, reducers)) {
+                replayed++;
+            } else {
+                skipped++;
+            }
+        });
+    }
+    pool.wait();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Replayed " << replayed << " sessions in " << seconds << "s";
+    if (skipped > 0) {
+        std::cout << " (" << skipped << " unreadable or recorded on a different trail)";
+    }
+    std::cout << std::endl;
+
+    std::vector<std::unique_ptr<ReplayReducer>>& total = workerReducers[0];
+    for (size_t w = 1; w < workerReducers.size(); ++w) {
+        for (size_t r = 0; r < total.size(); ++r) {
+            total[r]->merge(*workerReducers[w][r]);
+        }
+    }
+    for (const auto& reducer : total) {
+        reducer->report(std::cout);
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "journey.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A recorded session is everything needed to re-simulate it: profession,
+// seed, trail hash, the SimParams in effect and the keys TravelState saw.
+//
+//   OTREC 1
+//   profession Banker
+//   seed 1234
+//   trail 89abcdef01234567
+//   rewind 65536
+//   param foodPerPersonPerDay 2
+//   ...
+//   state 0a1b2c...        (resumed journeys only: where it picked up)
+//   keys
+//   32
+//   49
+//
+// Keys are appended one per line as they are pressed, so a session cut
+// short by a crash still replays up to its last key.
+
+struct ReplayHeader {
+    std::string profession = "Banker";
+    uint64_t seed = 0;
+    uint64_t trailHash = 0;
+    size_t rewindBudget = 0;        // Rewind history bytes; 0 = rewind off
+    SimParams params;
+    bool resumed = false;           // Starts from startState, not a new journey
+    std::string startState;         // Journey::saveState() bytes
+};
+
+// The header lines between the magic line and the payload; autosaves
+// store their journey's setup the same way
+void writeReplayHeader(std::ostream& out, const Journey& journey, size_t rewindBudget);
+void parseReplayHeaderLine(const std::string& line, ReplayHeader& header);
+
+// Writes a recording of one live journey
+class SessionRecorder {
+public:
+    // Creates a new file in directory; on failure logs and records nothing.
+    // A resumed journey records the state it resumed from, since its keys
+    // do not start from a new journey.
+    SessionRecorder(const std::string& directory, const Journey& journey, size_t rewindBudget = 0,
+                    bool resumed = false);
+
+    bool isRecording() const { return m_out.is_open(); }
+    const std::string& getPath() const { return m_path; }
+    void recordKey(SDL_Keycode key);
+
+private:
+    std::ofstream m_out;
+    std::string m_path;
+};
+
+// Streams a recording back one key at a time
+class ReplayReader {
+public:
+    bool open(const std::string& path);
+    const ReplayHeader& getHeader() const { return m_header; }
+    bool nextKey(SDL_Keycode& key);
+
+private:
+    std::ifstream m_in;
+    ReplayHeader m_header;
+};
+
+// The journey as it was just before a replayed key was applied
+struct ReplayStep {
+    SDL_Keycode key = 0;
+    TravelSubState subState = TravelSubState::Setup;
+    int landmarkIndex = 0;          // Most recent landmark reached
+    int milesTraveled = 0;
+    int daysElapsed = 0;
+    uint32_t aliveMask = 0;         // Bit i set if party member i was alive
+};
+
+// Aggregates one question over many replays in constant memory. Each pool
+// worker owns its own instance; they are merged once every replay is done.
+class ReplayReducer {
+public:
+    virtual ~ReplayReducer() = default;
+
+    virtual const char* getName() const = 0;
+
+    virtual void beginSession(const Journey& journey) { (void)journey; }
+    virtual void step(const ReplayStep& before, const Journey& after) = 0;
+    virtual void endSession(const Journey& journey) { (void)journey; }
+
+    virtual void merge(const ReplayReducer& other) = 0;
+    virtual void report(std::ostream& out) const = 0;
+};
+
+// "deaths", "rivers" or "rest"; nullptr if unknown
+std::unique_ptr<ReplayReducer> createReplayReducer(const std::string& name);
+
+// Re-simulates one recording through the reducers. Returns false if it
+// cannot be read or was recorded on a different trail.
+bool replaySession(ReplayReader& reader, std::shared_ptr<const TrailData> trail,
+                   const std::vector<std::unique_ptr<ReplayReducer>>& reducers);
+
+// Entry point for "oregon_trail --replay ..."; returns the process exit code
+int runReplayCommand(int argc, char* argv[]);
+
+#endif // REPLAY_HPP
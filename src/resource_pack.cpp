@@ -0,0 +1,263 @@
+#include "resource_pack.hpp"
+#include "compress.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char PACK_MAGIC[8] = {'O', 'T', 'P', 'A', 'C', 'K', '0', '1'};
+const size_t INDEX_ENTRY_FIXED_SIZE = 2 + 8 + 4 + 4 + 4;
+
+const uint32_t ENTRY_COMPRESSED = 1;
+
+// Compressed entries are decoded on every read, so compression has to
+// save at least this fraction of the file to be used
+const size_t MIN_SAVING_DIVISOR = 8;
+
+void putU16(std::vector<uint8_t>& out, uint16_t value) {
+    for (int i = 0; i < 2; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void putU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint64_t getLE(const uint8_t* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+size_t alignUp(size_t offset) {
+    return (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+}
+
+void printPackUsage() {
+    std::cout << "Usage: oregon_trail --build-pack <output> <file>...\n"
+              << "  Each file is stored under the path given, which is the path the game opens it by." << std::endl;
+}
+
+} // namespace
+
+SDL_RWops* PackBlob::openRW() const {
+    return SDL_RWFromConstMem(data, static_cast<int>(size));
+}
+
+ResourcePack::~ResourcePack() {
+    close();
+}
+
+void ResourcePack::close() {
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_entries.clear();
+    m_path.clear();
+}
+
+bool ResourcePack::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;   // No pack; the caller falls back to loose files
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 12) {
+        std::cerr << "Resource pack is too small: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Unable to map resource pack: " << path << std::endl;
+        m_size = 0;
+        return false;
+    }
+    m_data = static_cast<const uint8_t*>(mapping);
+    // Nearly all of it is read at startup; one sequential read-ahead beats
+    // page faults scattered over a slow SD card
+    madvise(mapping, m_size, MADV_WILLNEED);
+
+    const uint8_t* end = m_data + m_size;
+    bool valid = std::memcmp(m_data, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0;
+    const uint8_t* p = m_data + 8;
+    uint32_t entryCount = valid ? static_cast<uint32_t>(getLE(p, 4)) : 0;
+    p += 4;
+    for (uint32_t i = 0; valid && i < entryCount; ++i) {
+        if (static_cast<size_t>(end - p) < INDEX_ENTRY_FIXED_SIZE) {
+            valid = false;
+            break;
+        }
+        size_t nameLength = static_cast<size_t>(getLE(p, 2));
+        p += 2;
+        if (static_cast<size_t>(end - p) < nameLength + INDEX_ENTRY_FIXED_SIZE - 2) {
+            valid = false;
+            break;
+        }
+        std::string name(reinterpret_cast<const char*>(p), nameLength);
+        p += nameLength;
+
+        Entry entry;
+        entry.offset = getLE(p, 8);
+        entry.size = static_cast<uint32_t>(getLE(p + 8, 4));
+        entry.rawSize = static_cast<uint32_t>(getLE(p + 12, 4));
+        entry.flags = static_cast<uint32_t>(getLE(p + 16, 4));
+        p += 20;
+        if (entry.offset > m_size || entry.size > m_size - entry.offset ||
+            (!(entry.flags & ENTRY_COMPRESSED) && entry.size != entry.rawSize)) {
+            valid = false;
+            break;
+        }
+        m_entries[name] = entry;
+    }
+
+    if (!valid) {
+        std::cerr << "Resource pack is corrupt: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    m_path = path;
+    std::cout << "Opened resource pack " << path << " (" << m_entries.size() << " entries, "
+              << m_size << " bytes)" << std::endl;
+    return true;
+}
+
+bool ResourcePack::read(const std::string& name, PackBlob& blob) const {
+    auto it = m_entries.find(name);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    const Entry& entry = it->second;
+    const uint8_t* stored = m_data + entry.offset;
+
+    if (!(entry.flags & ENTRY_COMPRESSED)) {
+        blob.data = stored;
+        blob.size = entry.size;
+        blob.decoded.reset();
+        return true;
+    }
+
+    auto decoded = std::make_shared<std::vector<uint8_t>>(entry.rawSize);
+    if (!decompressBlock(stored, entry.size, decoded->data(), decoded->size())) {
+        std::cerr << "Resource pack entry " << name << " is corrupt" << std::endl;
+        return false;
+    }
+    blob.data = decoded->data();
+    blob.size = decoded->size();
+    blob.decoded = std::move(decoded);
+    return true;
+}
+
+bool buildResourcePack(const std::string& output, const std::vector<std::string>& files) {
+    struct Packed {
+        std::string name;
+        std::vector<uint8_t> data;
+        uint32_t rawSize = 0;
+        uint32_t flags = 0;
+        uint64_t offset = 0;
+    };
+
+    std::vector<Packed> packed;
+    size_t indexSize = 8 + 4;
+    for (const std::string& file : files) {
+        std::ifstream in(file, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "Unable to read " << file << std::endl;
+            return false;
+        }
+        Packed entry;
+        entry.name = file;
+        entry.data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        entry.rawSize = static_cast<uint32_t>(entry.data.size());
+
+        std::vector<uint8_t> compressed;
+        compressBlock(entry.data.data(), entry.data.size(), compressed);
+        if (compressed.size() + entry.data.size() / MIN_SAVING_DIVISOR <= entry.data.size()) {
+            entry.data.swap(compressed);
+            entry.flags |= ENTRY_COMPRESSED;
+        }
+
+        indexSize += INDEX_ENTRY_FIXED_SIZE + entry.name.size();
+        packed.push_back(std::move(entry));
+    }
+
+    size_t offset = alignUp(indexSize);
+    for (Packed& entry : packed) {
+        entry.offset = offset;
+        offset = alignUp(offset + entry.data.size());
+    }
+
+    std::vector<uint8_t> bytes(PACK_MAGIC, PACK_MAGIC + sizeof(PACK_MAGIC));
+    putU32(bytes, static_cast<uint32_t>(packed.size()));
+    for (const Packed& entry : packed) {
+        putU16(bytes, static_cast<uint16_t>(entry.name.size()));
+        bytes.insert(bytes.end(), entry.name.begin(), entry.name.end());
+        putU64(bytes, entry.offset);
+        putU32(bytes, static_cast<uint32_t>(entry.data.size()));
+        putU32(bytes, entry.rawSize);
+        putU32(bytes, entry.flags);
+    }
+    for (const Packed& entry : packed) {
+        bytes.resize(entry.offset, 0);
+        bytes.insert(bytes.end(), entry.data.begin(), entry.data.end());
+    }
+
+    // Written aside and renamed, so a running game never maps half a pack
+    std::string temporary = output + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out) {
+            std::cerr << "Unable to write " << temporary << std::endl;
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), output.c_str()) != 0) {
+        std::cerr << "Unable to replace " << output << std::endl;
+        return false;
+    }
+
+    for (const Packed& entry : packed) {
+        std::cout << "  " << entry.name << ": " << entry.rawSize << " bytes"
+                  << ((entry.flags & ENTRY_COMPRESSED) ? ", compressed to " + std::to_string(entry.data.size())
+                                                       : std::string(", stored"))
+                  << std::endl;
+    }
+    std::cout << "Wrote " << output << " (" << packed.size() << " entries, " << bytes.size() << " bytes)" << std::endl;
+    return true;
+}
+
+int runPackCommand(int argc, char* argv[]) {
+    if (argc < 2) {
+        printPackUsage();
+        return 1;
+    }
+    std::vector<std::string> files(argv + 1, argv + argc);
+    return buildResourcePack(argv[0], files) ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#ifndef RESOURCE_PACK_HPP
+#define RESOURCE_PACK_HPP
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Single-file pack of the game's fonts, text and data, so the game finds
+// them wherever it is launched from and reads them in one go rather than
+// as many small files.
+//
+// Entries are named by the relative path the game would otherwise open
+// ("assets/fonts/apple2.ttf"). Each is stored as is, or compressed with
+// compressBlock() when that saves enough to be worth decoding.
+//
+// Layout (little-endian):
+//   "OTPACK01" u32 entryCount
+//   { u16 nameLength, name, u64 offset, u32 size, u32 rawSize, u32 flags }*
+//   entry data, each starting on a PACK_ALIGNMENT boundary
+
+const size_t PACK_ALIGNMENT = 64;
+
+// Bytes of one entry. Stored entries point straight into the mapping (no
+// copy); compressed ones are decoded into a buffer the blob owns. Either
+// way the bytes stay valid while the blob, or a copy of it, exists and the
+// pack is open.
+struct PackBlob {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    std::shared_ptr<const std::vector<uint8_t>> decoded;
+
+    // Read-only SDL stream over the bytes, for the *_RW loaders. The blob
+    // must outlive it (fonts read from it for as long as they are open).
+    SDL_RWops* openRW() const;
+};
+
+// A pack mapped into memory. Opened once; after that it is read-only and
+// safe to read from any thread.
+class ResourcePack {
+public:
+    ResourcePack() = default;
+    ~ResourcePack();
+
+    ResourcePack(const ResourcePack&) = delete;
+    ResourcePack& operator=(const ResourcePack&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    bool contains(const std::string& name) const { return m_entries.count(name) > 0; }
+
+    // False if the pack has no such entry or it fails to decode
+    bool read(const std::string& name, PackBlob& blob) const;
+
+    const std::string& getPath() const { return m_path; }
+    size_t getEntryCount() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        uint64_t offset = 0;
+        uint32_t size = 0;      // Bytes in the pack
+        uint32_t rawSize = 0;   // Bytes once decoded
+        uint32_t flags = 0;
+    };
+
+    std::string m_path;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    std::map<std::string, Entry> m_entries;
+};
+
+// Writes a pack holding files, each named by the path given. Returns false
+// if a file cannot be read or the pack cannot be written.
+bool buildResourcePack(const std::string& output, const std::vector<std::string>& files);
+
+// --build-pack <output> <file>... (run by `make pack`)
+int runPackCommand(int argc, char* argv[]);
+
+#endif // RESOURCE_PACK_HPP
@@ -0,0 +1,87 @@
+#ifndef RNG_HPP
+#define RNG_HPP
+
+#include <cstdint>
+
+// Small, trivially copyable random number generator (PCG32) used by the
+// trail simulation. Seeding is cheap enough to start millions of journeys in
+// batch runs, and range() is implemented here rather than through
+// std::uniform_int_distribution so that a seed produces the same journey on
+// every standard library.
+class TrailRng {
+public:
+    using result_type = uint32_t;
+
+    explicit TrailRng(uint64_t seedValue = 0x853c49e6748fea9bULL) { seed(seedValue); }
+
+    void seed(uint64_t seedValue) {
+        m_state = 0;
+        m_inc = (seedValue << 1u) | 1u;
+        (*this)();
+        m_state += seedValue;
+        (*this)();
+    }
+
+    result_type operator()() {
+        uint64_t oldState = m_state;
+        m_state = oldState * 6364136223846793005ULL + m_inc;
+        uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+        uint32_t rot = static_cast<uint32_t>(oldState >> 59u);
+        return (xorShifted >> rot) | (xorShifted << ((~rot + 1u) & 31u));
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xffffffffu; }
+
+    // Uniform integer in [lo, hi] (inclusive, like uniform_int_distribution)
+    int range(int lo, int hi) {
+        if (hi <= lo) {
+            return lo;
+        }
+        uint32_t span = static_cast<uint32_t>(hi - lo) + 1u;
+        // Lemire's multiply-shift with rejection to avoid modulo bias
+        uint64_t product = static_cast<uint64_t>((*this)()) * span;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < span) {
+            uint32_t threshold = (0u - span) % span;
+            while (low < threshold) {
+                product = static_cast<uint64_t>((*this)()) * span;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return lo + static_cast<int>(product >> 32);
+    }
+
+    // Uniform double in [0, 1)
+    double unit() {
+        return ((*this)() >> 8) * (1.0 / 16777216.0);
+    }
+
+    // True with the given probability (0.0 - 1.0)
+    bool chance(double probability) {
+        return unit() < probability;
+    }
+
+    // Raw generator state, for saving a journey to disk
+    uint64_t getState() const { return m_state; }
+    uint64_t getIncrement() const { return m_inc; }
+    void setState(uint64_t state, uint64_t increment) {
+        m_state = state;
+        m_inc = increment | 1u;
+    }
+
+private:
+    uint64_t m_state;
+    uint64_t m_inc;
+};
+
+// Derives a well-mixed seed from a base seed and an index (SplitMix64), so
+// batch runs can give every journey its own reproducible stream
+inline uint64_t mixSeed(uint64_t base, uint64_t index) {
+    uint64_t z = base + (index + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+#endif // RNG_HPP
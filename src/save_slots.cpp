@@ -0,0 +1,267 @@
+#include "save_slots.hpp"
+#include "journey_session.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char DIRECTORY_MAGIC[8] = {'O', 'T', 'S', 'L', 'O', 'T', 'S', '1'};
+const size_t DIRECTORY_HEADER_SIZE = 64;
+
+struct SlotDirectoryHeader {
+    char magic[8];
+    uint32_t slotCount;
+    uint32_t entrySize;
+    uint8_t reserved[48];
+};
+
+static_assert(sizeof(SlotDirectoryHeader) == DIRECTORY_HEADER_SIZE, "Slot directory header is 64 bytes");
+
+const char SLOT_MAGIC[8] = {'O', 'T', 'S', 'L', 'O', 'T', '0', '1'};
+
+// Start of every slot-NN.sav; followed by paramCount doubles and the state
+struct SlotFileHeader {
+    char magic[8];
+    uint64_t seed;
+    uint64_t trailHash;
+    uint64_t rewindBudget;
+    char profession[16];
+    uint32_t paramCount;
+    uint32_t stateSize;
+};
+
+uint32_t entryChecksum(const SaveSlotInfo& info) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&info) + offsetof(SaveSlotInfo, name);
+    size_t size = sizeof(SaveSlotInfo) - offsetof(SaveSlotInfo, name);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void copyText(char* out, size_t size, const std::string& text) {
+    std::memset(out, 0, size);
+    std::memcpy(out, text.data(), std::min(text.size(), size - 1));
+}
+
+} // namespace
+
+SaveSlots::SaveSlots(const std::string& directory)
+    : m_directory(directory)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    std::string path = directory + "/slots.dir";
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        std::cerr << "Unable to open save slot directory " << path << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    m_mapSize = DIRECTORY_HEADER_SIZE + SAVE_SLOT_COUNT * sizeof(SaveSlotInfo);
+    struct stat info;
+    bool fresh = ::fstat(m_fd, &info) != 0 || static_cast<size_t>(info.st_size) != m_mapSize;
+    if (fresh && ::ftruncate(m_fd, static_cast<off_t>(m_mapSize)) != 0) {
+        std::cerr << "Unable to size save slot directory " << path << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    m_map = ::mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (m_map == MAP_FAILED) {
+        std::cerr << "Unable to map save slot directory " << path << ": " << std::strerror(errno) << std::endl;
+        m_map = nullptr;
+        return;
+    }
+
+    auto* header = static_cast<SlotDirectoryHeader*>(m_map);
+    if (fresh || std::memcmp(header->magic, DIRECTORY_MAGIC, sizeof(DIRECTORY_MAGIC)) != 0 ||
+        header->slotCount != SAVE_SLOT_COUNT || header->entrySize != sizeof(SaveSlotInfo)) {
+        // New or from an incompatible version: start with every slot empty
+        std::memset(m_map, 0, m_mapSize);
+        std::memcpy(header->magic, DIRECTORY_MAGIC, sizeof(DIRECTORY_MAGIC));
+        header->slotCount = SAVE_SLOT_COUNT;
+        header->entrySize = sizeof(SaveSlotInfo);
+        ::msync(m_map, m_mapSize, MS_ASYNC);
+    }
+    m_slots = reinterpret_cast<SaveSlotInfo*>(static_cast<char*>(m_map) + DIRECTORY_HEADER_SIZE);
+}
+
+SaveSlots::~SaveSlots() {
+    if (m_map) {
+        ::munmap(m_map, m_mapSize);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+std::string SaveSlots::getSlotPath(int index) const {
+    std::ostringstream path;
+    path << m_directory << "/slot-" << std::setw(2) << std::setfill('0') << index << ".sav";
+    return path.str();
+}
+
+const SaveSlotInfo* SaveSlots::getSlot(int index) const {
+    if (!m_slots || index < 0 || index >= SAVE_SLOT_COUNT) {
+        return nullptr;
+    }
+    const SaveSlotInfo& info = m_slots[index];
+    if (!info.used || info.checksum != entryChecksum(info)) {
+        return nullptr;
+    }
+    return &info;
+}
+
+int SaveSlots::chooseSlot() const {
+    int oldest = 0;
+    for (int i = 0; i < SAVE_SLOT_COUNT; ++i) {
+        const SaveSlotInfo* info = getSlot(i);
+        if (!info) {
+            return i;
+        }
+        if (info->timestamp < m_slots[oldest].timestamp) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+bool SaveSlots::save(int index, const JourneySession& session, const std::string& name) {
+    if (!m_slots || index < 0 || index >= SAVE_SLOT_COUNT) {
+        return false;
+    }
+    const Journey& journey = session.getJourney();
+    const auto& params = simParamTable();
+    std::string state = journey.saveState();
+
+    SlotFileHeader header = {};
+    std::memcpy(header.magic, SLOT_MAGIC, sizeof(SLOT_MAGIC));
+    header.seed = journey.getSeed();
+    header.trailHash = journey.getTrail().hash;
+    header.rewindBudget = session.getRewindBudget();
+    copyText(header.profession, sizeof(header.profession), journey.getProfession());
+    header.paramCount = static_cast<uint32_t>(params.size());
+    header.stateSize = static_cast<uint32_t>(state.size());
+
+    std::vector<char> data(sizeof(header) + params.size() * sizeof(double) + state.size());
+    std::memcpy(data.data(), &header, sizeof(header));
+    for (size_t i = 0; i < params.size(); ++i) {
+        double value = params[i].get(journey.getParams());
+        std::memcpy(data.data() + sizeof(header) + i * sizeof(double), &value, sizeof(value));
+    }
+    std::memcpy(data.data() + sizeof(header) + params.size() * sizeof(double), state.data(), state.size());
+
+    // Replace the file whole so a slot is never half old, half new. Left to
+    // the page cache rather than synced: saving happens on the input path.
+    std::string path = getSlotPath(index);
+    std::string temporaryPath = path + ".tmp";
+    FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Unable to write save slot " << temporaryPath << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    written = std::fclose(file) == 0 && written;
+    if (!written || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Unable to write save slot " << path << std::endl;
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+
+    SaveSlotInfo info = {};
+    info.used = 1;
+    copyText(info.name, sizeof(info.name), name);
+    copyText(info.profession, sizeof(info.profession), journey.getProfession());
+    info.timestamp = static_cast<int64_t>(std::time(nullptr));
+    info.milesTraveled = journey.getMilesTraveled();
+    info.survivors = journey.getAliveCount();
+    info.daysElapsed = journey.getDaysElapsed();
+    info.month = journey.getMonth();
+    info.day = journey.getCurrentDay();
+    info.year = journey.getYear();
+    info.seed = journey.getSeed();
+    info.checksum = entryChecksum(info);
+    m_slots[index] = info;
+    ::msync(m_map, m_mapSize, MS_ASYNC);
+
+    std::cout << "Saved journey to slot " << index + 1 << ": " << name << std::endl;
+    return true;
+}
+
+std::unique_ptr<JourneySession> SaveSlots::load(int index, std::shared_ptr<const TrailData> trail) const {
+    if (!getSlot(index)) {
+        return nullptr;
+    }
+
+    std::string path = getSlotPath(index);
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Unable to open save slot " << path << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    struct stat info;
+    size_t size = ::fstat(fd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    void* map = size >= sizeof(SlotFileHeader) ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        std::cerr << "Unable to map save slot " << path << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<JourneySession> session;
+    const char* bytes = static_cast<const char*>(map);
+    SlotFileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    const auto& params = simParamTable();
+    size_t stateOffset = sizeof(header) + static_cast<size_t>(header.paramCount) * sizeof(double);
+
+    if (std::memcmp(header.magic, SLOT_MAGIC, sizeof(SLOT_MAGIC)) != 0 || header.paramCount != params.size() ||
+        stateOffset + header.stateSize != size) {
+        std::cerr << "Save slot " << path << " is damaged or from another version" << std::endl;
+    } else if (trail && header.trailHash != trail->hash) {
+        std::cerr << "Save slot " << path << " was made on a different trail" << std::endl;
+    } else {
+        SimParams simParams;
+        for (size_t i = 0; i < params.size(); ++i) {
+            double value;
+            std::memcpy(&value, bytes + sizeof(header) + i * sizeof(double), sizeof(value));
+            params[i].set(simParams, value);
+        }
+        header.profession[sizeof(header.profession) - 1] = '\0';
+
+        Journey journey(header.profession, header.seed, simParams, trail);
+        if (journey.loadState(bytes + stateOffset, header.stateSize)) {
+            session = std::make_unique<JourneySession>(std::move(journey), header.rewindBudget);
+        } else {
+            std::cerr << "Save slot " << path << " has an unreadable journey" << std::endl;
+        }
+    }
+
+    ::munmap(map, size);
+    return session;
+}
+
+bool SaveSlots::erase(int index) {
+    if (!m_slots || index < 0 || index >= SAVE_SLOT_COUNT) {
+        return false;
+    }
+    std::memset(&m_slots[index], 0, sizeof(SaveSlotInfo));
+    ::msync(m_map, m_mapSize, MS_ASYNC);
+    std::remove(getSlotPath(index).c_str());
+    return true;
+}
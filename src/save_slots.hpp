@@ -0,0 +1,77 @@
+#ifndef SAVE_SLOTS_HPP
+#define SAVE_SLOTS_HPP
+
+#include "journey.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class JourneySession;
+
+const int SAVE_SLOT_COUNT = 100;
+
+// Key that saves the journey in progress to its slot
+const SDL_Keycode SAVE_KEY = SDLK_F5;
+
+// Everything the slot list shows about one save. Stored as-is in the
+// mapped slot directory, so the layout is fixed.
+struct SaveSlotInfo {
+    uint32_t used;                  // 0 = empty slot
+    uint32_t checksum;              // Of everything after this field
+    char name[48];                  // NUL terminated
+    char profession[16];
+    int64_t timestamp;              // When it was saved, seconds since the epoch
+    int32_t milesTraveled;
+    int32_t survivors;
+    int32_t daysElapsed;
+    int32_t month;
+    int32_t day;
+    int32_t year;
+    uint64_t seed;
+    uint8_t reserved[16];
+};
+
+static_assert(sizeof(SaveSlotInfo) == 128, "Slot directory entries are 128 bytes on disk");
+
+// Named save slots for journeys in progress.
+//
+//   slots.dir      header + SAVE_SLOT_COUNT SaveSlotInfo entries, mapped
+//                  read/write for the life of the game. Listing every slot
+//                  reads this one mapping and opens nothing else.
+//   slot-NN.sav    fixed binary header, the SimParams values in table
+//                  order, then Journey::saveState() data. Loading maps it
+//                  and hands the bytes straight to Journey::loadState().
+class SaveSlots {
+public:
+    explicit SaveSlots(const std::string& directory);
+    ~SaveSlots();
+
+    SaveSlots(const SaveSlots&) = delete;
+    SaveSlots& operator=(const SaveSlots&) = delete;
+
+    bool isOpen() const { return m_slots != nullptr; }
+
+    // Null if the slot is empty (or its directory entry is damaged)
+    const SaveSlotInfo* getSlot(int index) const;
+
+    // An empty slot, or the one saved longest ago if all are taken
+    int chooseSlot() const;
+
+    bool save(int index, const JourneySession& session, const std::string& name);
+    std::unique_ptr<JourneySession> load(int index, std::shared_ptr<const TrailData> trail) const;
+    bool erase(int index);
+
+    const std::string& getDirectory() const { return m_directory; }
+
+private:
+    std::string getSlotPath(int index) const;
+
+    std::string m_directory;
+    int m_fd = -1;
+    void* m_map = nullptr;
+    size_t m_mapSize = 0;
+    SaveSlotInfo* m_slots = nullptr;
+};
+
+#endif // SAVE_SLOTS_HPP
@@ -0,0 +1,47 @@
+#ifndef SCREEN_TEXT_HPP
+#define SCREEN_TEXT_HPP
+
+#include <cstddef>
+
+// x of a line drawn centered across the window
+const int SCREEN_CENTERED = -1;
+
+// One line of text on a screen. The text is a literal, owned by the state,
+// or formatted into the frame arena, so it lasts only for the frame.
+struct ScreenLine {
+    const char* text;
+    int x;              // Or SCREEN_CENTERED
+    int y;
+};
+
+// Everything a screen writes in one frame, worked out before any of it is
+// drawn. Each screen has a build function that its render() and
+// --check-frames both call, so the check sees exactly the text the game
+// draws. Fixed size, so building never allocates.
+class ScreenText {
+public:
+    static const size_t MAX_LINES = 64;
+
+    // Lines past MAX_LINES are counted and dropped
+    void add(const char* text, int x, int y) {
+        if (m_count == MAX_LINES) {
+            ++m_dropped;
+            return;
+        }
+        m_lines[m_count++] = ScreenLine{text, x, y};
+    }
+    void addCentered(const char* text, int y) { add(text, SCREEN_CENTERED, y); }
+
+    size_t size() const { return m_count; }
+    size_t getDropped() const { return m_dropped; }
+    const ScreenLine& operator[](size_t index) const { return m_lines[index]; }
+    const ScreenLine* begin() const { return m_lines; }
+    const ScreenLine* end() const { return m_lines + m_count; }
+
+private:
+    ScreenLine m_lines[MAX_LINES];
+    size_t m_count = 0;
+    size_t m_dropped = 0;
+};
+
+#endif // SCREEN_TEXT_HPP
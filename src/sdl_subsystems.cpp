@@ -0,0 +1,79 @@
+#include "sdl_subsystems.hpp"
+#include "startup_profile.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <SDL2/SDL_ttf.h>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+// One subsystem: started at most once, remembered either way
+struct Subsystem {
+    std::once_flag once;
+    std::atomic<bool> started{false};
+};
+
+Subsystem imageLoader;
+Subsystem fontLoader;
+Subsystem audio;
+
+} // namespace
+
+bool requireImageLoader() {
+    std::call_once(imageLoader.once, [] {
+        StartupTimer timer("SDL_image");
+        int imgFlags = IMG_INIT_PNG;
+        if (!(IMG_Init(imgFlags) & imgFlags)) {
+            std::cerr << "SDL_image initialization failed: " << IMG_GetError() << std::endl;
+            return;
+        }
+        imageLoader.started = true;
+    });
+    return imageLoader.started;
+}
+
+bool requireFontLoader() {
+    std::call_once(fontLoader.once, [] {
+        StartupTimer timer("SDL_ttf");
+        if (TTF_Init() != 0) {
+            std::cerr << "SDL_ttf initialization failed: " << TTF_GetError() << std::endl;
+            return;
+        }
+        fontLoader.started = true;
+    });
+    return fontLoader.started;
+}
+
+bool requireAudio() {
+    std::call_once(audio.once, [] {
+        StartupTimer timer("SDL audio and SDL_mixer");
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+            std::cerr << "SDL audio initialization failed: " << SDL_GetError() << std::endl;
+            return;
+        }
+        if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
+            std::cerr << "SDL_mixer initialization failed: " << Mix_GetError() << std::endl;
+            SDL_QuitSubSystem(SDL_INIT_AUDIO);
+            return;
+        }
+        audio.started = true;
+    });
+    return audio.started;
+}
+
+void shutdownSubsystems() {
+    if (audio.started) {
+        Mix_CloseAudio();
+        Mix_Quit();
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+    if (fontLoader.started) {
+        TTF_Quit();
+    }
+    if (imageLoader.started) {
+        IMG_Quit();
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef SDL_SUBSYSTEMS_HPP
+#define SDL_SUBSYSTEMS_HPP
+
+// The SDL libraries beyond video start on first use rather than at launch:
+// the loading screen needs none of them for its first frame, and nothing
+// plays audio until a sound is loaded. Each starts exactly once, from
+// whichever thread asks first (asset decoding asks from the job system's
+// workers); concurrent callers wait for it. Returns false if it failed,
+// which is remembered and not retried.
+bool requireImageLoader();     // SDL_image, for PNG
+bool requireFontLoader();      // SDL_ttf
+bool requireAudio();           // SDL audio and SDL_mixer
+
+// Quits whichever of them started. Called once, after everything that
+// uses them has gone.
+void shutdownSubsystems();
+
+#endif // SDL_SUBSYSTEMS_HPP
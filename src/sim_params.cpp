@@ -0,0 +1,63 @@
+#include "sim_params.hpp"
+#include "heap_tracker.hpp"
+#include <cmath>
+
+namespace {
+
+int roundToInt(double value) {
+    return static_cast<int>(std::lround(value));
+}
+
+} // namespace
+
+#define SIM_PARAM_DOUBLE(field) \
+    { #field, \
+      [](const SimParams& p) { return p.field; }, \
+      [](SimParams& p, double v) { p.field = v; } }
+
+#define SIM_PARAM_INT_NAMED(name, field) \
+    { name, \
+      [](const SimParams& p) { return static_cast<double>(p.field); }, \
+      [](SimParams& p, double v) { p.field = roundToInt(v); } }
+
+#define SIM_PARAM_INT(field) SIM_PARAM_INT_NAMED(#field, field)
+
+const std::vector<SimParamInfo>& simParamTable() {
+    HeapScope scope(HeapSubsystem::Other);          // Kept for the whole run
+    static const std::vector<SimParamInfo> table = {
+        SIM_PARAM_INT(foodPerPersonPerDay),
+        SIM_PARAM_DOUBLE(randomEventChance),
+        SIM_PARAM_DOUBLE(illnessChance),
+        SIM_PARAM_DOUBLE(clothingWearChance),
+        SIM_PARAM_DOUBLE(wagonDamageChance),
+        SIM_PARAM_DOUBLE(seasonalWeatherChance),
+        SIM_PARAM_DOUBLE(betterWeatherChance),
+        SIM_PARAM_INT(baseDailyMiles),
+        SIM_PARAM_INT_NAMED("milesModifierFair", weatherMileModifier[0]),
+        SIM_PARAM_INT_NAMED("milesModifierCloudy", weatherMileModifier[1]),
+        SIM_PARAM_INT_NAMED("milesModifierRainy", weatherMileModifier[2]),
+        SIM_PARAM_INT_NAMED("milesModifierStormy", weatherMileModifier[3]),
+        SIM_PARAM_INT_NAMED("milesModifierSnowy", weatherMileModifier[4]),
+        SIM_PARAM_INT(brokenWagonMilePenalty),
+        SIM_PARAM_INT(illnessDamage),
+        SIM_PARAM_INT(medicineRecovery),
+        SIM_PARAM_INT(restRecovery),
+        SIM_PARAM_INT(starvationDamage),
+        SIM_PARAM_INT(starvationDayDamage),
+        SIM_PARAM_INT(exposureDamage)
+    };
+    return table;
+}
+
+#undef SIM_PARAM_DOUBLE
+#undef SIM_PARAM_INT
+#undef SIM_PARAM_INT_NAMED
+
+const SimParamInfo* findSimParam(const std::string& name) {
+    for (const auto& info : simParamTable()) {
+        if (name == info.name) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,49 @@
+#ifndef SIM_PARAMS_HPP
+#define SIM_PARAMS_HPP
+
+#include <string>
+#include <vector>
+
+// Balance constants for the trail simulation. The defaults reproduce the
+// original hard-coded behaviour of TravelState; batch tools override them
+// to explore other tunings.
+struct SimParams {
+    // Consumption
+    int foodPerPersonPerDay = 2;            // Pounds of food eaten per person per day
+
+    // Daily chances (0.0 - 1.0)
+    double randomEventChance = 0.15;        // Random event while traveling
+    double illnessChance = 0.05;            // Per party member per day
+    double clothingWearChance = 0.10;       // Clothing wears out in rain or storms
+    double wagonDamageChance = 0.05;        // Wagon part breaks in storms
+    double seasonalWeatherChance = 0.70;    // Weather matches the season
+    double betterWeatherChance = 0.15;      // Weather is better than the season
+
+    // Travel
+    int baseDailyMiles = 10;
+    int weatherMileModifier[5] = {5, 0, -3, -7, -10}; // Fair, Cloudy, Rainy, Stormy, Snowy
+    int brokenWagonMilePenalty = 5;
+
+    // Health
+    int illnessDamage = 15;
+    int medicineRecovery = 10;
+    int restRecovery = 5;
+    int starvationDamage = 10;              // Applied by updateHealth when out of food
+    int starvationDayDamage = 15;           // Applied at the end of a day without food
+    int exposureDamage = 5;                 // Bad weather without clothing
+};
+
+// Describes one tunable field of SimParams so tools can address it by name
+struct SimParamInfo {
+    const char* name;
+    double (*get)(const SimParams& params);
+    void (*set)(SimParams& params, double value);
+};
+
+// All tunable parameters, in declaration order
+const std::vector<SimParamInfo>& simParamTable();
+
+// Look up a parameter by name; returns nullptr if unknown
+const SimParamInfo* findSimParam(const std::string& name);
+
+#endif // SIM_PARAMS_HPP
@@ -0,0 +1,81 @@
+#include "sim_thread.hpp"
+#include "heap_tracker.hpp"
+#include <iostream>
+
+namespace {
+
+// Inputs that can be waiting at once; far more than anyone can type in a frame
+const size_t INPUT_QUEUE_CAPACITY = 256;
+
+} // namespace
+
+SimulationThread::SimulationThread(StepFunction step, FillFunction fill)
+    : m_step(std::move(step))
+    , m_fill(std::move(fill))
+    , m_input(INPUT_QUEUE_CAPACITY)
+{
+    // The render thread has something to draw before the first step
+    publish();
+    m_thread = std::thread(&SimulationThread::run, this);
+}
+
+SimulationThread::~SimulationThread() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping.store(true);
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool SimulationThread::submit(const SimInput& input) {
+    SimInput queued = input;
+    if (!m_input.tryPush(std::move(queued))) {
+        std::cerr << "Simulation input queue full, dropped key " << input.key << std::endl;
+        return false;
+    }
+    ++m_submitted;
+    {
+        // Under the lock, or the notify can fall between the thread checking
+        // for work and going to sleep
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_pending = true;
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+void SimulationThread::run() {
+    HeapScope scope(HeapSubsystem::Sim);
+    for (;;) {
+        // Read the flag first so inputs queued before a stop are handled
+        bool stopping = m_stopping.load();
+
+        bool stepped = false;
+        SimInput input;
+        while (m_input.tryPop(input)) {
+            m_step(input);
+            m_steps.fetch_add(1, std::memory_order_relaxed);
+            stepped = true;
+        }
+        if (stepped) {
+            publish();
+        }
+
+        if (stopping) {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [this] { return m_pending || m_stopping.load(); });
+        m_pending = false;
+    }
+}
+
+void SimulationThread::publish() {
+    JourneyView& view = m_views.getBackBuffer();
+    m_fill(view);
+    view.steps = m_steps.load(std::memory_order_relaxed);
+    m_views.publish();
+}
@@ -0,0 +1,89 @@
+#ifndef SIM_THREAD_HPP
+#define SIM_THREAD_HPP
+
+#include "journey.hpp"
+#include "spsc_queue.hpp"
+#include "triple_buffer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Everything render() draws: a copy of the journey after the last step
+// and what that step had to say. Copying a journey shares its setup, trail
+// and event text, so publishing one costs a few hundred bytes.
+struct JourneyView {
+    Journey journey;
+    std::string statusText;         // Shown until the next key
+    int highScoreRank = 0;          // Place on the high-score table, 0 if none
+    uint32_t haltedTravelRun = 0;   // Last continuous travel run that stopped
+    uint64_t steps = 0;             // Inputs handled so far
+};
+
+// One input for the simulation thread: a key the player pressed, or a day
+// of continuous travel. Travel days carry the number of the run that sent
+// them; once something stops that run, the rest of its days are ignored,
+// however many were already queued.
+struct SimInput {
+    SDL_Keycode key = 0;
+    uint32_t travelRun = 0;         // 0 = pressed by the player
+};
+
+// Runs a journey's simulation on its own thread so a heavy step (a week of
+// rest, a long autosave snapshot, a batch of graves) never holds up a
+// frame. Inputs go in through a lock-free queue; after each batch of them
+// the thread publishes a JourneyView through a triple buffer, which the
+// render thread reads without waiting.
+//
+// The step and fill functions run on the simulation thread only, and
+// whatever they touch belongs to that thread until the object is
+// destroyed.
+class SimulationThread {
+public:
+    using StepFunction = std::function<void(const SimInput& input)>;
+    using FillFunction = std::function<void(JourneyView& view)>;
+
+    // Publishes a first view on the calling thread, then starts
+    SimulationThread(StepFunction step, FillFunction fill);
+    ~SimulationThread();   // Applies whatever is still queued, then joins
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Called from the render thread only. Never blocks; false if the
+    // queue is full and the input was dropped.
+    bool submit(const SimInput& input);
+    bool submitKey(SDL_Keycode key) { return submit(SimInput{key, 0}); }
+
+    // Called from the render thread only. The newest view; it stays valid
+    // and unchanged until the next call.
+    const JourneyView& getView() { return m_views.acquire(); }
+
+    uint64_t getStepCount() const { return m_steps.load(std::memory_order_relaxed); }
+
+    // Inputs accepted by submit(); compare with JourneyView::steps to tell
+    // whether a view is up to date. Render thread only.
+    uint64_t getSubmittedCount() const { return m_submitted; }
+
+private:
+    void run();
+    void publish();
+
+    StepFunction m_step;
+    FillFunction m_fill;
+    SpscQueue<SimInput> m_input;
+    TripleBuffer<JourneyView> m_views;
+
+    std::thread m_thread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_pending = false;                 // Guarded by m_wakeMutex
+    std::atomic<bool> m_stopping{false};
+    std::atomic<uint64_t> m_steps{0};
+    uint64_t m_submitted = 0;               // Render thread only
+};
+
+#endif // SIM_THREAD_HPP
@@ -0,0 +1,190 @@
+#include "slot_state.hpp"
+#include "game.hpp"
+#include "asset_cache.hpp"
+#include "frame_arena.hpp"
+#include "menu_state.hpp"
+#include "save_slots.hpp"
+#include "travel_state.hpp"
+#include "frame_profiler.hpp"
+#include "text_cache.hpp"
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+
+namespace {
+
+const char* const MONTH_NAMES[] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+const char* describeSlot(const SaveSlots* slots, int index, const char* prefix, FrameArena& frame) {
+    const SaveSlotInfo* info = slots ? slots->getSlot(index) : nullptr;
+    if (!info) {
+        return frame.format("%s%3d. (empty)", prefix, index + 1);
+    }
+    
+    const char* month = (info->month >= 1 && info->month <= 12) ? MONTH_NAMES[info->month - 1] : "???";
+    return frame.format("%s%3d. %-24.24s %-9.9s %s %2d %d  %4d mi  %d alive",
+                        prefix, index + 1, info->name, info->profession, month, info->day, info->year,
+                        info->milesTraveled, info->survivors);
+}
+
+} // namespace
+
+int visibleSlotRows(int windowHeight) {
+    return (windowHeight - 190) / 20;
+}
+
+void buildSlotText(const SaveSlots* slots, int selected, int scrollOffset, const std::string& statusText,
+                   int windowHeight, FrameArena& frame, ScreenText& text) {
+    text.addCentered("Saved Journeys", 50);
+    
+    int y = 100;
+    int visibleRows = visibleSlotRows(windowHeight);
+    for (int i = scrollOffset; i < scrollOffset + visibleRows && i < SAVE_SLOT_COUNT; ++i) {
+        text.add(describeSlot(slots, i, i == selected ? "> " : "  ", frame), 30, y);
+        y += 20;
+    }
+    
+    text.addCentered(statusText.c_str(), windowHeight - 80);
+    text.addCentered("Enter: Load | Delete: Erase slot | ESC: Return to menu", windowHeight - 30);
+}
+
+SlotState::SlotState(Game* game)
+    : GameState(game)
+{
+    std::cout << "SlotState initialized" << std::endl;
+}
+
+SlotState::~SlotState() {
+}
+
+void SlotState::enter() {
+    std::cout << "Entering SlotState" << std::endl;
+    
+    // Shared with every other state; only the first one to ask loads it
+    if (!m_font) {
+        m_font = m_game->getAssets()->getDefaultFont(16);
+    }
+    
+    // Start on the most recent save
+    SaveSlots* slots = m_game->getSaveSlots();
+    if (slots) {
+        int64_t newest = -1;
+        for (int i = 0; i < SAVE_SLOT_COUNT; ++i) {
+            const SaveSlotInfo* info = slots->getSlot(i);
+            if (info && info->timestamp > newest) {
+                newest = info->timestamp;
+                m_selectedSlot = i;
+            }
+        }
+    }
+    m_scrollOffset = std::max(0, m_selectedSlot - getVisibleRows() / 2);
+}
+
+void SlotState::exit() {
+    std::cout << "Exiting SlotState" << std::endl;
+}
+
+void SlotState::returnToMenu() {
+    m_game->changeState(MENU_STATE_NAME);
+}
+
+void SlotState::loadSelectedSlot() {
+    SaveSlots* slots = m_game->getSaveSlots();
+    if (!slots || !slots->getSlot(m_selectedSlot)) {
+        m_statusText = "That slot is empty.";
+        return;
+    }
+    
+    std::unique_ptr<JourneySession> session = slots->load(m_selectedSlot, m_game->getTrail());
+    if (!session) {
+        m_statusText = "That save could not be loaded.";
+        return;
+    }
+    
+    std::cout << "Loading save slot " << m_selectedSlot + 1 << std::endl;
+    auto travelState = std::make_unique<TravelState>(m_game, std::move(*session), m_selectedSlot);
+    m_game->changeState(std::move(travelState));
+}
+
+void SlotState::handleEvent(const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) {
+        return;
+    }
+    
+    m_statusText.clear();
+    int visibleRows = getVisibleRows();
+    switch (event.key.keysym.sym) {
+        case SDLK_ESCAPE:
+            returnToMenu();
+            return;
+            
+        case SDLK_RETURN:
+        case SDLK_SPACE:
+            loadSelectedSlot();
+            return;
+            
+        case SDLK_DELETE:
+            if (m_game->getSaveSlots() && m_game->getSaveSlots()->getSlot(m_selectedSlot)) {
+                m_game->getSaveSlots()->erase(m_selectedSlot);
+                m_statusText = "Slot " + std::to_string(m_selectedSlot + 1) + " deleted.";
+            }
+            break;
+            
+        case SDLK_UP:
+            m_selectedSlot = std::max(0, m_selectedSlot - 1);
+            break;
+            
+        case SDLK_DOWN:
+            m_selectedSlot = std::min(SAVE_SLOT_COUNT - 1, m_selectedSlot + 1);
+            break;
+            
+        case SDLK_PAGEUP:
+            m_selectedSlot = std::max(0, m_selectedSlot - visibleRows);
+            break;
+            
+        case SDLK_PAGEDOWN:
+            m_selectedSlot = std::min(SAVE_SLOT_COUNT - 1, m_selectedSlot + visibleRows);
+            break;
+            
+        default:
+            break;
+    }
+    
+    // Keep the selection on screen
+    if (m_selectedSlot < m_scrollOffset) {
+        m_scrollOffset = m_selectedSlot;
+    } else if (m_selectedSlot >= m_scrollOffset + visibleRows) {
+        m_scrollOffset = m_selectedSlot - visibleRows + 1;
+    }
+}
+
+void SlotState::update(float deltaTime) {
+    // Nothing animates here
+}
+
+int SlotState::getVisibleRows() const {
+    return visibleSlotRows(m_game->getWindowHeight());
+}
+
+void SlotState::render() {
+    SDL_Renderer* renderer = m_game->getRenderer();
+    
+    // Clear screen to black
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    
+    // Horizontal lines under the title and above the instructions
+    SDL_SetRenderDrawColor(renderer, 144, 238, 144, 255); // Light green
+    countDrawCall();
+    SDL_RenderDrawLine(renderer, 50, 80, m_game->getWindowWidth() - 50, 80);
+    countDrawCall();
+    SDL_RenderDrawLine(renderer, 50, m_game->getWindowHeight() - 50,
+                      m_game->getWindowWidth() - 50, m_game->getWindowHeight() - 50);
+    
+    ScreenText text;
+    buildSlotText(m_game->getSaveSlots(), m_selectedSlot, m_scrollOffset, m_statusText, m_game->getWindowHeight(),
+                  m_game->getFrameArena(), text);
+    m_game->getTextCache()->draw(m_font, m_textColor, text, m_game->getWindowWidth());
+}
@@ -0,0 +1,51 @@
+#ifndef SLOT_STATE_HPP
+#define SLOT_STATE_HPP
+
+#include "game_state.hpp"
+#include "screen_text.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <memory>
+#include <string>
+
+class FrameArena;
+class Game;
+class SaveSlots;
+
+// Rows of slots that fit between the title and the status line
+int visibleSlotRows(int windowHeight);
+
+// The slot list's text for one frame. Every slot shows as empty if slots
+// is null.
+void buildSlotText(const SaveSlots* slots, int selected, int scrollOffset, const std::string& statusText,
+                   int windowHeight, FrameArena& frame, ScreenText& text);
+
+// Lists the save slots straight from the mapped slot directory and resumes
+// the chosen journey
+class SlotState : public GameState {
+public:
+    SlotState(Game* game);
+    virtual ~SlotState();
+    
+    // GameState interface implementation
+    virtual void enter() override;
+    virtual void exit() override;
+    virtual void handleEvent(const SDL_Event& event) override;
+    virtual void update(float deltaTime) override;
+    virtual void render() override;
+    virtual std::string getName() const override { return "SlotState"; }
+    
+private:
+    void returnToMenu();
+    void loadSelectedSlot();
+    int getVisibleRows() const;
+    
+    // Member variables
+    std::shared_ptr<TTF_Font> m_font;
+    SDL_Color m_textColor = {144, 238, 144, 255}; // Light green
+    int m_selectedSlot = 0;
+    int m_scrollOffset = 0;
+    std::string m_statusText;
+};
+
+#endif // SLOT_STATE_HPP
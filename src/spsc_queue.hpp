@@ -0,0 +1,70 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Neither side ever blocks: tryPush() fails when the queue is full
+// and tryPop() fails when it is empty, and the caller decides what to do.
+template <typename T>
+class SpscQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+    bool tryPush(T&& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool tryPop(T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+        value = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t getCapacity() const { return m_slots.size(); }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask = 0;
+
+    // Each index is written by one side only; each side keeps a stale copy
+    // of the other's index so the shared cache line is read only when the
+    // queue looks full (or empty)
+    alignas(64) std::atomic<size_t> m_head{0};   // Next slot to pop
+    size_t m_cachedTail = 0;                     // Consumer's view of m_tail
+    alignas(64) std::atomic<size_t> m_tail{0};   // Next slot to push
+    size_t m_cachedHead = 0;                     // Producer's view of m_head
+};
+
+#endif // SPSC_QUEUE_HPP
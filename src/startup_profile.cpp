@@ -0,0 +1,77 @@
+#include "startup_profile.hpp"
+#include "heap_tracker.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Both set during static initialization, on the main thread
+const std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now();
+const std::thread::id mainThreadId = std::this_thread::get_id();
+
+std::mutex& phasesMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<StartupPhase>& phases() {
+    static std::vector<StartupPhase> recorded;
+    return recorded;
+}
+
+} // namespace
+
+double startupMilliseconds() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - processStart).count();
+}
+
+void recordStartupPhase(const std::string& name, double startMilliseconds) {
+    StartupPhase phase;
+    phase.name = name;
+    phase.startMilliseconds = startMilliseconds;
+    phase.milliseconds = startupMilliseconds() - startMilliseconds;
+    phase.mainThread = std::this_thread::get_id() == mainThreadId;
+
+    HeapScope scope(HeapSubsystem::Other);          // Kept for the whole run
+    std::lock_guard<std::mutex> lock(phasesMutex());
+    phases().push_back(phase);
+}
+
+void recordStartupMilestone(const std::string& name) {
+    recordStartupPhase(name, startupMilliseconds());
+}
+
+std::vector<StartupPhase> getStartupPhases() {
+    std::vector<StartupPhase> sorted;
+    {
+        std::lock_guard<std::mutex> lock(phasesMutex());
+        sorted = phases();
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const StartupPhase& a, const StartupPhase& b) {
+        return a.startMilliseconds < b.startMilliseconds;
+    });
+    return sorted;
+}
+
+void printStartupProfile(std::ostream& out) {
+    std::vector<StartupPhase> sorted = getStartupPhases();
+    double mainThreadTotal = 0.0;
+    double end = 0.0;
+
+    out << "Startup profile (ms since launch):" << std::endl;
+    out << "     start      took  thread  phase" << std::endl;
+    out << std::fixed << std::setprecision(2);
+    for (const StartupPhase& phase : sorted) {
+        out << std::setw(10) << phase.startMilliseconds << std::setw(10) << phase.milliseconds
+            << (phase.mainThread ? "  main    " : "  worker  ") << phase.name << std::endl;
+        if (phase.mainThread) {
+            mainThreadTotal += phase.milliseconds;
+        }
+        end = std::max(end, phase.startMilliseconds + phase.milliseconds);
+    }
+    out << "Time to first interactive frame: " << end << " ms (" << mainThreadTotal
+        << " ms in timed main-thread phases)" << std::defaultfloat << std::endl;
+}
@@ -0,0 +1,43 @@
+#ifndef STARTUP_PROFILE_HPP
+#define STARTUP_PROFILE_HPP
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One timed step of getting the game on screen
+struct StartupPhase {
+    std::string name;
+    double startMilliseconds = 0.0;     // Since the process started
+    double milliseconds = 0.0;          // How long it took (0 for a milestone)
+    bool mainThread = true;             // Otherwise it ran alongside, on a worker
+};
+
+// Milliseconds since the process started (more exactly, since static
+// initialization, which comes before main())
+double startupMilliseconds();
+
+// Phases are always recorded, from any thread; it costs a lock and a
+// clock read each, and there are only a dozen. --profile-startup prints
+// them once the first frame the player can act on is on screen.
+void recordStartupPhase(const std::string& name, double startMilliseconds);
+void recordStartupMilestone(const std::string& name);
+std::vector<StartupPhase> getStartupPhases();
+void printStartupProfile(std::ostream& out);
+
+// Records the phase from construction to destruction
+class StartupTimer {
+public:
+    explicit StartupTimer(std::string name) : m_name(std::move(name)), m_start(startupMilliseconds()) {}
+    ~StartupTimer() { recordStartupPhase(m_name, m_start); }
+
+    StartupTimer(const StartupTimer&) = delete;
+    StartupTimer& operator=(const StartupTimer&) = delete;
+
+private:
+    std::string m_name;
+    double m_start;
+};
+
+#endif // STARTUP_PROFILE_HPP
@@ -0,0 +1,78 @@
+#include "state_benchmark.hpp"
+#include "game.hpp"
+#include "info_state.hpp"
+#include "menu_state.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const char* const BENCHMARK_TEXT = "Timing state transitions.";
+
+struct Latency {
+    double median = 0.0;
+    double percentile95 = 0.0;
+    double max = 0.0;
+};
+
+// Microseconds taken by each call of backToMenu, after leaving the menu
+// for an info screen. The first round trip is not timed: it loads the
+// font, and for the registered menu it builds the instance.
+Latency timeReturns(Game& game, int roundTrips, const std::function<void()>& backToMenu) {
+    std::vector<double> samples;
+    for (int i = 0; i <= roundTrips; ++i) {
+        game.changeState(std::make_unique<InfoState>(&game, "Benchmark", BENCHMARK_TEXT));
+        auto start = std::chrono::steady_clock::now();
+        backToMenu();
+        auto end = std::chrono::steady_clock::now();
+        if (i > 0) {
+            samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+    Latency latency;
+    if (!samples.empty()) {
+        latency.median = samples[samples.size() / 2];
+        latency.percentile95 = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+        latency.max = samples.back();
+    }
+    return latency;
+}
+
+void printLatency(const char* label, const Latency& latency) {
+    std::cout << "  " << std::left << std::setw(26) << label << std::right << std::fixed << std::setprecision(1)
+              << "median " << std::setw(8) << latency.median << " us, 95th percentile " << std::setw(8)
+              << latency.percentile95 << " us, max " << std::setw(8) << latency.max << " us" << std::endl;
+}
+
+} // namespace
+
+int runStateBenchmark(Game& game, int roundTrips) {
+    if (roundTrips < 1 || game.hasStates()) {
+        std::cerr << "The state benchmark needs at least one round trip and no states pushed" << std::endl;
+        return 1;
+    }
+    game.pushState(std::make_unique<InfoState>(&game, "Benchmark", BENCHMARK_TEXT));
+
+    // States log every transition; writing that to a terminal would be
+    // most of what is timed
+    std::streambuf* log = std::cout.rdbuf(nullptr);
+    Latency rebuilt = timeReturns(game, roundTrips, [&game] {
+        game.changeState(std::make_unique<MenuState>(&game));
+    });
+    Latency registered = timeReturns(game, roundTrips, [&game] {
+        game.changeState(MENU_STATE_NAME);
+    });
+    std::cout.rdbuf(log);
+    std::cout.clear();
+
+    std::cout << "Returning to the menu (" << roundTrips << " round trips, logging muted):" << std::endl;
+    printLatency("new MenuState each time:", rebuilt);
+    printLatency("registered MenuState:", registered);
+    return 0;
+}
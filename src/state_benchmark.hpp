@@ -0,0 +1,12 @@
+#ifndef STATE_BENCHMARK_HPP
+#define STATE_BENCHMARK_HPP
+
+class Game;
+
+// --bench-states [round trips]: times going back to the menu from another
+// screen, building a new MenuState each time against re-entering the
+// registered one, and prints the latencies. Needs an initialized game with
+// the menu registered and no states pushed yet. Returns an exit code.
+int runStateBenchmark(Game& game, int roundTrips);
+
+#endif // STATE_BENCHMARK_HPP
@@ -0,0 +1,221 @@
+#include "stats.hpp"
+#include <algorithm>
+#include <cmath>
+
+HdrHistogram::HdrHistogram(int subBucketBits, int64_t maxValue)
+    : m_subBucketBits(std::max(2, std::min(subBucketBits, 20)))
+    , m_maxValue(std::max<int64_t>(1, maxValue))
+{
+    m_counts.assign(bucketIndex(m_maxValue) + 1, 0);
+}
+
+size_t HdrHistogram::bucketIndex(int64_t value) const {
+    uint64_t v = static_cast<uint64_t>(std::max<int64_t>(0, value));
+    uint64_t subBucketCount = uint64_t(1) << m_subBucketBits;
+    if (v < subBucketCount) {
+        return static_cast<size_t>(v);
+    }
+
+    // Drop low bits so the mantissa fits in [half, full) sub-buckets
+    int msb = 63 - __builtin_clzll(v);
+    int shift = msb - m_subBucketBits + 1;
+    uint64_t half = subBucketCount >> 1;
+    return static_cast<size_t>(static_cast<uint64_t>(shift) * half + (v >> shift));
+}
+
+int64_t HdrHistogram::bucketLowest(size_t index) const {
+    size_t subBucketCount = size_t(1) << m_subBucketBits;
+    if (index < subBucketCount) {
+        return static_cast<int64_t>(index);
+    }
+    size_t half = subBucketCount >> 1;
+    size_t shift = index / half - 1;
+    size_t mantissa = index - shift * half;
+    return static_cast<int64_t>(mantissa) << shift;
+}
+
+int64_t HdrHistogram::bucketHighest(size_t index) const {
+    return bucketLowest(index + 1) - 1;
+}
+
+void HdrHistogram::add(int64_t value, uint64_t count) {
+    value = std::max<int64_t>(0, std::min(value, m_maxValue));
+    if (m_totalCount == 0) {
+        m_min = value;
+        m_max = value;
+    } else {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+    m_counts[bucketIndex(value)] += count;
+    m_totalCount += count;
+    m_sum += static_cast<double>(value) * count;
+}
+
+void HdrHistogram::merge(const HdrHistogram& other) {
+    if (other.m_totalCount == 0) {
+        return;
+    }
+    if (other.m_subBucketBits != m_subBucketBits || other.m_counts.size() > m_counts.size()) {
+        // Different layouts: re-add each bucket at its representative value
+        for (size_t i = 0; i < other.m_counts.size(); ++i) {
+            if (other.m_counts[i]) {
+                add((other.bucketLowest(i) + other.bucketHighest(i)) / 2, other.m_counts[i]);
+            }
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < other.m_counts.size(); ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_min = m_totalCount ? std::min(m_min, other.m_min) : other.m_min;
+    m_max = m_totalCount ? std::max(m_max, other.m_max) : other.m_max;
+    m_totalCount += other.m_totalCount;
+    m_sum += other.m_sum;
+}
+
+int64_t HdrHistogram::quantile(double q) const {
+    if (m_totalCount == 0) {
+        return 0;
+    }
+    q = std::max(0.0, std::min(1.0, q));
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * m_totalCount));
+    rank = std::max<uint64_t>(1, rank);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_counts.size(); ++i) {
+        seen += m_counts[i];
+        if (seen >= rank) {
+            // Report the bucket midpoint, clamped to what was actually seen
+            int64_t value = (bucketLowest(i) + bucketHighest(i)) / 2;
+            return std::max(m_min, std::min(m_max, value));
+        }
+    }
+    return m_max;
+}
+
+TDigest::TDigest(double compression)
+    : m_compression(std::max(20.0, compression))
+    , m_bufferLimit(static_cast<size_t>(m_compression * 5))
+{
+    m_buffer.reserve(m_bufferLimit);
+}
+
+void TDigest::add(double value, double weight) {
+    if (std::isnan(value) || weight <= 0.0) {
+        return;
+    }
+    if (getCount() == 0.0) {
+        m_min = value;
+        m_max = value;
+    } else {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+
+    m_buffer.push_back({value, weight});
+    m_bufferWeight += weight;
+    if (m_buffer.size() >= m_bufferLimit) {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.getCount() == 0.0) {
+        return;
+    }
+    other.compress();
+
+    if (getCount() == 0.0) {
+        m_min = other.m_min;
+        m_max = other.m_max;
+    } else {
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    for (const auto& centroid : other.m_centroids) {
+        m_buffer.push_back(centroid);
+        m_bufferWeight += centroid.weight;
+        if (m_buffer.size() >= m_bufferLimit) {
+            compress();
+        }
+    }
+}
+
+void TDigest::compress() const {
+    if (m_buffer.empty()) {
+        return;
+    }
+
+    m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+    std::sort(m_buffer.begin(), m_buffer.end(),
+              [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+    double total = m_totalWeight + m_bufferWeight;
+    m_centroids.clear();
+
+    // Merge neighbours while the combined centroid stays under the size
+    // limit for its position; the limit shrinks towards both tails
+    Centroid current = m_buffer.front();
+    double weightSoFar = 0.0;
+    for (size_t i = 1; i < m_buffer.size(); ++i) {
+        const Centroid& next = m_buffer[i];
+        double proposed = current.weight + next.weight;
+        double q0 = weightSoFar / total;
+        double q2 = (weightSoFar + proposed) / total;
+        double limit = total * 4.0 * std::min(q0 * (1.0 - q0), q2 * (1.0 - q2)) / m_compression;
+
+        if (proposed <= limit) {
+            current.mean += (next.mean - current.mean) * next.weight / proposed;
+            current.weight = proposed;
+        } else {
+            weightSoFar += current.weight;
+            m_centroids.push_back(current);
+            current = next;
+        }
+    }
+    m_centroids.push_back(current);
+
+    m_totalWeight = total;
+    m_bufferWeight = 0.0;
+    m_buffer.clear();
+}
+
+double TDigest::quantile(double q) const {
+    compress();
+    if (m_centroids.empty()) {
+        return 0.0;
+    }
+    if (m_centroids.size() == 1) {
+        return m_centroids.front().mean;
+    }
+
+    q = std::max(0.0, std::min(1.0, q));
+    double target = q * m_totalWeight;
+
+    // Each centroid's mean sits at the middle of its weight; interpolate
+    // between neighbouring middles, and towards min/max at the ends
+    const Centroid& first = m_centroids.front();
+    if (target < first.weight / 2.0) {
+        return m_min + (first.mean - m_min) * target / (first.weight / 2.0);
+    }
+
+    double cumulative = first.weight / 2.0;
+    for (size_t i = 0; i + 1 < m_centroids.size(); ++i) {
+        const Centroid& left = m_centroids[i];
+        const Centroid& right = m_centroids[i + 1];
+        double gap = (left.weight + right.weight) / 2.0;
+        if (target < cumulative + gap) {
+            double t = (target - cumulative) / gap;
+            return left.mean + t * (right.mean - left.mean);
+        }
+        cumulative += gap;
+    }
+
+    const Centroid& last = m_centroids.back();
+    double tail = last.weight / 2.0;
+    double t = tail > 0.0 ? std::min(1.0, (target - cumulative) / tail) : 1.0;
+    return last.mean + t * (m_max - last.mean);
+}
@@ -0,0 +1,80 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed-memory, mergeable accumulators for batch results. Each worker
+// thread fills its own copies and they are merged once at the end, so a
+// batch of any size never stores or sorts individual outcomes.
+
+// Log-linear histogram of non-negative integers (HDR histogram layout).
+// Values below 2^subBucketBits are counted exactly; larger values land in
+// buckets whose width is under 1 / 2^(subBucketBits - 1) of the value.
+class HdrHistogram {
+public:
+    explicit HdrHistogram(int subBucketBits = 7, int64_t maxValue = (int64_t(1) << 40));
+
+    void add(int64_t value, uint64_t count = 1);
+    void merge(const HdrHistogram& other);
+
+    uint64_t getCount() const { return m_totalCount; }
+    int64_t getMin() const { return m_totalCount ? m_min : 0; }
+    int64_t getMax() const { return m_totalCount ? m_max : 0; }
+    double getMean() const { return m_totalCount ? m_sum / m_totalCount : 0.0; }
+
+    // Value at quantile q (0.0 - 1.0), accurate to the bucket width
+    int64_t quantile(double q) const;
+
+private:
+    size_t bucketIndex(int64_t value) const;
+    int64_t bucketLowest(size_t index) const;
+    int64_t bucketHighest(size_t index) const;
+
+    int m_subBucketBits;
+    int64_t m_maxValue;
+    std::vector<uint64_t> m_counts;
+    uint64_t m_totalCount = 0;
+    int64_t m_min = 0;
+    int64_t m_max = 0;
+    double m_sum = 0.0;
+};
+
+// Merging t-digest (Dunning) for quantiles of real values. Keeps at most a
+// few hundred centroids for the default compression, with the smallest
+// ones near the tails where percentiles need the most precision.
+class TDigest {
+public:
+    explicit TDigest(double compression = 100.0);
+
+    void add(double value, double weight = 1.0);
+    void merge(const TDigest& other);
+
+    double getCount() const { return m_totalWeight + m_bufferWeight; }
+    double getMin() const { return m_min; }
+    double getMax() const { return m_max; }
+
+    // Estimated value at quantile q (0.0 - 1.0)
+    double quantile(double q) const;
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    // Fold buffered points into the centroid list
+    void compress() const;
+
+    double m_compression;
+    size_t m_bufferLimit;
+    mutable std::vector<Centroid> m_centroids;
+    mutable std::vector<Centroid> m_buffer;
+    mutable double m_totalWeight = 0.0;
+    mutable double m_bufferWeight = 0.0;
+    double m_min = 0.0;
+    double m_max = 0.0;
+};
+
+#endif // STATS_HPP
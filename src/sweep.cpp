@@ -0,0 +1,375 @@
+#include "sweep.hpp"
+#include "rng.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+SweepRunner::SweepRunner(const SweepConfig& config)
+    : m_config(config)
+{
+    for (const auto& axis : m_config.axes) {
+        m_axisParams.push_back(findSimParam(axis.name));
+    }
+
+    if (m_config.mode == SweepMode::LatinHypercube && getSetCount() <= MAX_SWEEP_SETS) {
+        buildLatinHypercube();
+    }
+}
+
+size_t SweepRunner::getSetCount() const {
+    if (m_config.mode == SweepMode::LatinHypercube) {
+        return std::min(static_cast<size_t>(std::max(0, m_config.samples)), MAX_SWEEP_SETS + 1);
+    }
+
+    // Stops multiplying once past the limit, so it cannot overflow
+    size_t count = 1;
+    for (const auto& axis : m_config.axes) {
+        count *= static_cast<size_t>(std::max(1, axis.steps));
+        if (count > MAX_SWEEP_SETS) {
+            return MAX_SWEEP_SETS + 1;
+        }
+    }
+    return count;
+}
+
+void SweepRunner::buildLatinHypercube() {
+    size_t samples = static_cast<size_t>(std::max(0, m_config.samples));
+    size_t axisCount = m_config.axes.size();
+    m_lhsValues.assign(samples * axisCount, 0.0);
+
+    TrailRng rng(m_config.seed);
+    std::vector<size_t> strata(samples);
+
+    // Each axis is split into equal strata and every stratum is used exactly
+    // once, in an independently shuffled order per axis
+    for (size_t a = 0; a < axisCount; ++a) {
+        std::iota(strata.begin(), strata.end(), 0);
+        for (size_t i = samples; i > 1; --i) {
+            size_t j = static_cast<size_t>(rng.range(0, static_cast<int>(i) - 1));
+            std::swap(strata[i - 1], strata[j]);
+        }
+
+        const SweepAxis& axis = m_config.axes[a];
+        for (size_t s = 0; s < samples; ++s) {
+            double position = (strata[s] + rng.unit()) / static_cast<double>(samples);
+            m_lhsValues[s * axisCount + a] = axis.minValue + position * (axis.maxValue - axis.minValue);
+        }
+    }
+}
+
+std::vector<double> SweepRunner::valuesForSet(size_t index) const {
+    size_t axisCount = m_config.axes.size();
+    std::vector<double> values(axisCount);
+
+    if (m_config.mode == SweepMode::LatinHypercube) {
+        std::copy(m_lhsValues.begin() + index * axisCount,
+                  m_lhsValues.begin() + (index + 1) * axisCount,
+                  values.begin());
+        return values;
+    }
+
+    // Grid sets are decoded from the index instead of being stored, so a
+    // large grid costs no memory up front
+    for (size_t a = axisCount; a-- > 0;) {
+        const SweepAxis& axis = m_config.axes[a];
+        size_t steps = static_cast<size_t>(std::max(1, axis.steps));
+        size_t step = index % steps;
+        index /= steps;
+
+        double t = steps > 1 ? static_cast<double>(step) / static_cast<double>(steps - 1) : 0.0;
+        values[a] = axis.minValue + t * (axis.maxValue - axis.minValue);
+    }
+    return values;
+}
+
+SweepResult SweepRunner::evaluateSet(size_t index) const {
+    SweepResult result;
+    result.setIndex = index;
+    result.values = valuesForSet(index);
+
+    SimParams params = m_config.baseParams;
+    for (size_t a = 0; a < m_axisParams.size(); ++a) {
+        m_axisParams[a]->set(params, result.values[a]);
+    }
+
+    // Every set replays the same seeds (common random numbers), so
+    // differences between rows come from the parameters, not from luck
+    BatchSpec spec;
+    spec.profession = m_config.profession;
+    spec.params = params;
+    spec.trail = m_config.trail;
+    spec.journeys = m_config.journeysPerSet;
+    spec.seed = m_config.seed;
+    runBatchRange(spec, 0, spec.journeys, result.summary);
+    return result;
+}
+
+bool SweepRunner::run() {
+    for (size_t a = 0; a < m_axisParams.size(); ++a) {
+        if (!m_axisParams[a]) {
+            std::cerr << "Unknown sweep parameter: " << m_config.axes[a].name << std::endl;
+            return false;
+        }
+    }
+
+    size_t setCount = getSetCount();
+    if (setCount == 0 || setCount > MAX_SWEEP_SETS) {
+        std::cerr << "Sweep must have between 1 and " << MAX_SWEEP_SETS << " parameter sets" << std::endl;
+        return false;
+    }
+
+    std::ofstream out(m_config.outputPath);
+    if (!out.is_open()) {
+        std::cerr << "Unable to open sweep output: " << m_config.outputPath << std::endl;
+        return false;
+    }
+
+    // Header row
+    out << "set";
+    for (const auto& axis : m_config.axes) {
+        out << "," << axis.name;
+    }
+    out << ",journeys,survived,survival_rate,mean_survivors,mean_arrival_day,mean_food,mean_money"
+        << ",arrival_day_p10,arrival_day_p50,arrival_day_p90,food_p10,food_p50,food_p90"
+        << ",money_p10,money_p50,money_p90";
+    for (int cause = 1; cause < DEATH_CAUSE_COUNT; ++cause) {
+        out << ",deaths_" << getDeathCauseName(static_cast<DeathCause>(cause));
+    }
+    out << "\n";
+    out.flush();
+
+    unsigned threadCount = resolveThreadCount(m_config.threads);
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, std::max<size_t>(1, setCount)));
+
+    std::cout << "Sweeping " << setCount << " parameter sets x " << m_config.journeysPerSet
+              << " journeys on " << threadCount << " threads" << std::endl;
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::atomic<size_t> nextSet(0);
+    std::atomic<size_t> finished(0);
+    std::mutex outputMutex;
+    std::vector<SweepRow> rows(setCount);
+
+    // Workers pull the next unevaluated set, so fast and slow sets balance
+    // across cores. Rows are written as they complete (in completion order).
+    auto worker = [&]() {
+        for (;;) {
+            size_t index = nextSet.fetch_add(1);
+            if (index >= setCount) {
+                break;
+            }
+
+            SweepResult result = evaluateSet(index);
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            SweepRow& row = rows[result.setIndex];
+            row.survivalRate = result.summary.getSurvivalRate();
+            row.meanSurvivors = result.summary.getMeanSurvivors();
+            row.meanArrivalDay = result.summary.getMeanArrivalDay();
+            row.done = true;
+            
+            out << result.setIndex;
+            for (double value : result.values) {
+                out << "," << value;
+            }
+            const BatchSummary& summary = result.summary;
+            out << "," << summary.journeys
+                << "," << summary.survived
+                << "," << summary.getSurvivalRate()
+                << "," << summary.getMeanSurvivors()
+                << "," << summary.getMeanArrivalDay()
+                << "," << summary.getMeanFood()
+                << "," << summary.getMeanMoney()
+                << "," << summary.arrivalDays.quantile(0.1)
+                << "," << summary.arrivalDays.quantile(0.5)
+                << "," << summary.arrivalDays.quantile(0.9)
+                << "," << summary.food.quantile(0.1)
+                << "," << summary.food.quantile(0.5)
+                << "," << summary.food.quantile(0.9)
+                << "," << summary.money.quantile(0.1)
+                << "," << summary.money.quantile(0.5)
+                << "," << summary.money.quantile(0.9);
+            for (int cause = 1; cause < DEATH_CAUSE_COUNT; ++cause) {
+                out << "," << summary.deaths[cause];
+            }
+            out << "\n";
+            out.flush();
+
+            size_t done = ++finished;
+            if (done % 10 == 0 || done == setCount) {
+                std::cout << "Sweep progress: " << done << "/" << setCount << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    printTable(std::cout, rows);
+    std::cout << "Sweep finished in " << seconds << "s, results in " << m_config.outputPath << std::endl;
+    return out.good();
+}
+
+void SweepRunner::printTable(std::ostream& out, const std::vector<SweepRow>& rows) const {
+    std::vector<int> widths;
+    out << std::right << std::setw(7) << "set";
+    for (const auto& axis : m_config.axes) {
+        widths.push_back(std::max<int>(12, static_cast<int>(axis.name.size()) + 2));
+        out << std::setw(widths.back()) << axis.name;
+    }
+    out << std::setw(11) << "survival" << std::setw(11) << "survivors" << std::setw(13) << "arrival_day" << "\n";
+
+    // In set order, so a grid reads axis by axis
+    for (size_t index = 0; index < rows.size(); ++index) {
+        const SweepRow& row = rows[index];
+        if (!row.done) {
+            continue;
+        }
+        out << std::setw(7) << index;
+        std::vector<double> values = valuesForSet(index);
+        for (size_t a = 0; a < values.size(); ++a) {
+            out << std::setw(widths[a]) << values[a];
+        }
+        out << std::fixed << std::setprecision(3) << std::setw(11) << row.survivalRate
+            << std::setprecision(2) << std::setw(11) << row.meanSurvivors
+            << std::setprecision(1) << std::setw(13) << row.meanArrivalDay << std::defaultfloat
+            << std::setprecision(6) << "\n";
+    }
+    out.flush();
+}
+
+namespace {
+
+void printSweepUsage() {
+    std::cout << "Usage: oregon_trail --sweep [options]\n"
+              << "  --grid                     Evaluate every combination of axis steps (default)\n"
+              << "  --lhs <samples>            Evaluate a Latin hypercube of <samples> sets\n"
+              << "                             (either way, at most " << MAX_SWEEP_SETS << " sets)\n"
+              << "  --param name=min:max[:steps]  Add an axis (repeatable)\n"
+              << "  --set name=value           Override a fixed parameter\n"
+              << "  --journeys <n>             Journeys per parameter set (default 1000)\n"
+              << "  --profession <name>        Banker, Carpenter or Farmer\n"
+              << "  --trail <file>             Trail data file (default: built-in trail)\n"
+              << "  --threads <n>              Worker threads (default: all cores)\n"
+              << "  --seed <n>                 Base random seed\n"
+              << "  --out <file>               CSV output path (default sweep.csv)\n"
+              << "Parameters:";
+    for (const auto& info : simParamTable()) {
+        std::cout << " " << info.name;
+    }
+    std::cout << std::endl;
+}
+
+bool parseAxis(const std::string& spec, SweepAxis& axis) {
+    size_t equals = spec.find('=');
+    if (equals == std::string::npos) {
+        return false;
+    }
+    axis.name = spec.substr(0, equals);
+
+    std::string range = spec.substr(equals + 1);
+    size_t firstColon = range.find(':');
+    if (firstColon == std::string::npos) {
+        return false;
+    }
+    size_t secondColon = range.find(':', firstColon + 1);
+
+    try {
+        axis.minValue = std::stod(range.substr(0, firstColon));
+        if (secondColon == std::string::npos) {
+            axis.maxValue = std::stod(range.substr(firstColon + 1));
+            axis.steps = 5;
+        } else {
+            axis.maxValue = std::stod(range.substr(firstColon + 1, secondColon - firstColon - 1));
+            axis.steps = std::stoi(range.substr(secondColon + 1));
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return axis.steps >= 1;
+}
+
+} // namespace
+
+int runSweepCommand(int argc, char* argv[]) {
+    SweepConfig config;
+
+    try {
+        for (int i = 0; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--grid") {
+                config.mode = SweepMode::Grid;
+            } else if (arg == "--lhs" && hasValue) {
+                config.mode = SweepMode::LatinHypercube;
+                config.samples = std::stoi(argv[++i]);
+            } else if (arg == "--param" && hasValue) {
+                SweepAxis axis;
+                if (!parseAxis(argv[++i], axis)) {
+                    std::cerr << "Invalid --param: " << argv[i] << std::endl;
+                    printSweepUsage();
+                    return 1;
+                }
+                config.axes.push_back(axis);
+            } else if (arg == "--set" && hasValue) {
+                std::string spec = argv[++i];
+                size_t equals = spec.find('=');
+                const SimParamInfo* info = equals == std::string::npos ? nullptr :
+                                           findSimParam(spec.substr(0, equals));
+                if (!info) {
+                    std::cerr << "Invalid --set: " << spec << std::endl;
+                    printSweepUsage();
+                    return 1;
+                }
+                info->set(config.baseParams, std::stod(spec.substr(equals + 1)));
+            } else if (arg == "--journeys" && hasValue) {
+                config.journeysPerSet = std::stoi(argv[++i]);
+            } else if (arg == "--profession" && hasValue) {
+                config.profession = argv[++i];
+            } else if (arg == "--trail" && hasValue) {
+                config.trail = loadTrailData(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                config.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--seed" && hasValue) {
+                config.seed = std::stoull(argv[++i]);
+            } else if (arg == "--out" && hasValue) {
+                config.outputPath = argv[++i];
+            } else {
+                std::cerr << "Unknown sweep option: " << arg << std::endl;
+                printSweepUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid sweep option value: " << e.what() << std::endl;
+        printSweepUsage();
+        return 1;
+    }
+
+    if (config.journeysPerSet < 1) {
+        std::cerr << "Sweep needs at least 1 journey per parameter set" << std::endl;
+        printSweepUsage();
+        return 1;
+    }
+    if (config.axes.empty()) {
+        std::cerr << "Sweep needs at least one --param axis" << std::endl;
+        printSweepUsage();
+        return 1;
+    }
+
+    SweepRunner runner(config);
+    return runner.run() ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include "batch.hpp"
+#include "sim_params.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Most parameter sets one sweep evaluates; a bigger grid is refused
+// rather than left to run for weeks (or to overflow the set count)
+const size_t MAX_SWEEP_SETS = 100000;
+
+// How parameter sets are chosen from the axes
+enum class SweepMode {
+    Grid,           // Every combination of evenly spaced steps
+    LatinHypercube  // A fixed number of stratified random samples
+};
+
+// One parameter being varied
+struct SweepAxis {
+    std::string name;   // Name from simParamTable()
+    double minValue = 0.0;
+    double maxValue = 0.0;
+    int steps = 1;      // Grid mode only
+};
+
+struct SweepConfig {
+    SweepMode mode = SweepMode::Grid;
+    std::vector<SweepAxis> axes;
+    int samples = 32;               // Latin hypercube mode only
+    int journeysPerSet = 1000;
+    std::string profession = "Banker";
+    SimParams baseParams;           // Values for parameters not on an axis
+    std::shared_ptr<const TrailData> trail;
+    unsigned threads = 0;           // 0 = one per hardware thread
+    uint64_t seed = 1848;
+    std::string outputPath = "sweep.csv";
+};
+
+// Aggregated outcome of all journeys run with one parameter set
+struct SweepResult {
+    size_t setIndex = 0;
+    std::vector<double> values;     // One per axis
+    BatchSummary summary;
+};
+
+// Evaluates parameter sets in parallel and streams one CSV row per set to
+// disk as soon as it finishes. Only a few headline numbers per set are
+// kept, for the table printed once the sweep is done.
+class SweepRunner {
+public:
+    explicit SweepRunner(const SweepConfig& config);
+
+    // Saturates at MAX_SWEEP_SETS + 1, which run() refuses
+    size_t getSetCount() const;
+    bool run();
+
+private:
+    // Headline numbers of one set for the table
+    struct SweepRow {
+        double survivalRate = 0.0;
+        double meanSurvivors = 0.0;
+        double meanArrivalDay = 0.0;
+        bool done = false;
+    };
+
+    std::vector<double> valuesForSet(size_t index) const;
+    SweepResult evaluateSet(size_t index) const;
+    void buildLatinHypercube();
+    void printTable(std::ostream& out, const std::vector<SweepRow>& rows) const;
+
+    SweepConfig m_config;
+    std::vector<const SimParamInfo*> m_axisParams;
+    // Latin hypercube samples, laid out [sample][axis]
+    std::vector<double> m_lhsValues;
+};
+
+// Entry point for "oregon_trail --sweep ..."; returns the process exit code
+int runSweepCommand(int argc, char* argv[]);
+
+#endif // SWEEP_HPP
@@ -0,0 +1,106 @@
+#include "text_cache.hpp"
+#include "frame_profiler.hpp"
+#include "screen_text.hpp"
+#include "trail_data.hpp"
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+uint64_t hashText(const TTF_Font* font, SDL_Color color, const char* text) {
+    uint64_t hash = hashBytes(&font, sizeof(font));
+    hash = hashBytes(&color, sizeof(color), hash);
+    return hashBytes(text, std::strlen(text), hash);
+}
+
+bool sameColor(SDL_Color a, SDL_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+} // namespace
+
+TextCache::TextCache(SDL_Renderer* renderer)
+    : m_renderer(renderer)
+{
+}
+
+TextCache::~TextCache() {
+    for (auto& entry : m_entries) {
+        SDL_DestroyTexture(entry.second.texture);
+    }
+}
+
+void TextCache::beginFrame() {
+    ++m_frame;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (m_frame - it->second.lastFrame > EVICT_AFTER_FRAMES) {
+            SDL_DestroyTexture(it->second.texture);
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+const TextCache::Entry* TextCache::find(const std::shared_ptr<TTF_Font>& font, SDL_Color color,
+                                        const char* text) {
+    uint64_t key = hashText(font.get(), color, text);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end() && it->second.font == font && sameColor(it->second.color, color) &&
+        it->second.text == text) {
+        it->second.lastFrame = m_frame;
+        return &it->second;
+    }
+
+    // Not drawn lately (or another text with the same hash was, which
+    // this one replaces)
+    ++m_renders;
+    SDL_Surface* surface = TTF_RenderText_Solid(font.get(), text, color);
+    if (!surface) {
+        std::cerr << "Unable to render text surface: " << TTF_GetError() << std::endl;
+        return nullptr;
+    }
+    countTextureUpload();
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(m_renderer, surface);
+    if (!texture) {
+        std::cerr << "Unable to create texture from rendered text: " << SDL_GetError() << std::endl;
+        SDL_FreeSurface(surface);
+        return nullptr;
+    }
+
+    Entry& entry = m_entries[key];
+    SDL_DestroyTexture(entry.texture);
+    entry.font = font;
+    entry.color = color;
+    entry.text = text;
+    entry.texture = texture;
+    entry.width = surface->w;
+    entry.height = surface->h;
+    entry.lastFrame = m_frame;
+    SDL_FreeSurface(surface);
+    return &entry;
+}
+
+void TextCache::draw(const std::shared_ptr<TTF_Font>& font, SDL_Color color, const char* text, int x, int y,
+                     int width) {
+    if (text[0] == '\0' || !font) {
+        return;
+    }
+    const Entry* entry = find(font, color, text);
+    if (!entry) {
+        return;
+    }
+
+    if (x == SCREEN_CENTERED) {
+        x = (width - entry->width) / 2;
+    }
+    SDL_Rect quad = {x, y, entry->width, entry->height};
+    countDrawCall();
+    SDL_RenderCopy(m_renderer, entry->texture, nullptr, &quad);
+}
+
+void TextCache::draw(const std::shared_ptr<TTF_Font>& font, SDL_Color color, const ScreenText& text, int width) {
+    for (const ScreenLine& line : text) {
+        draw(font, color, line.text, line.x, line.y, width);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef TEXT_CACHE_HPP
+#define TEXT_CACHE_HPP
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class ScreenText;
+
+// Textures of the text drawn in recent frames. Rendering a line with
+// SDL_ttf and uploading it allocates, so a line drawn again in the same
+// font and color reuses its texture instead, and a frame that shows the
+// same text as the last one renders and uploads nothing. A texture not
+// drawn for EVICT_AFTER_FRAMES frames is destroyed. Main thread only.
+class TextCache {
+public:
+    static const uint64_t EVICT_AFTER_FRAMES = 60;
+
+    explicit TextCache(SDL_Renderer* renderer);
+    ~TextCache();   // Before the renderer is destroyed
+
+    TextCache(const TextCache&) = delete;
+    TextCache& operator=(const TextCache&) = delete;
+
+    // Start of a frame: destroys the textures that have gone unused
+    void beginFrame();
+
+    // Draws text with its top left at (x, y), or centered across width
+    // when x is SCREEN_CENTERED. Empty text draws nothing.
+    void draw(const std::shared_ptr<TTF_Font>& font, SDL_Color color, const char* text, int x, int y, int width);
+    void draw(const std::shared_ptr<TTF_Font>& font, SDL_Color color, const ScreenText& text, int width);
+
+    size_t size() const { return m_entries.size(); }
+
+    // Lines rendered with SDL_ttf so far, cache misses
+    uint64_t getRenderCount() const { return m_renders; }
+
+private:
+    struct Entry {
+        std::shared_ptr<TTF_Font> font;     // Held, so its address is not reused while cached
+        SDL_Color color;
+        std::string text;
+        SDL_Texture* texture = nullptr;
+        int width = 0;
+        int height = 0;
+        uint64_t lastFrame = 0;
+    };
+
+    // Cached texture for the text, rendering it on a miss. Null if it
+    // cannot be rendered.
+    const Entry* find(const std::shared_ptr<TTF_Font>& font, SDL_Color color, const char* text);
+
+    SDL_Renderer* m_renderer;
+    std::unordered_map<uint64_t, Entry> m_entries;  // By hash of font, color and text
+    uint64_t m_frame = 0;
+    uint64_t m_renders = 0;
+};
+
+#endif // TEXT_CACHE_HPP
@@ -0,0 +1,384 @@
+#include "tombstones.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Grave record layout (little-endian):
+//    0 u32 magic         4 i32 mile          8 i64 timestamp
+//   16 u8 cause + 3 reserved                20 char[28] name
+//   48 char[44] epitaph                     92 u32 checksum of bytes 0-91
+const size_t RECORD_SIZE = 96;
+const size_t NAME_SIZE = 28;
+const size_t EPITAPH_SIZE = 44;
+const uint32_t RECORD_MAGIC = 0x5647544f; // "OTGV"
+
+// Index layout: "OTGRAVE1", u64 log bytes covered, u64 grave count,
+// u32 mile count, u32 record size, reserved to 64 bytes; then u64 start
+// of each mile (mile count + 1 entries); then the records sorted by mile
+const size_t INDEX_HEADER_SIZE = 64;
+const char INDEX_MAGIC[8] = {'O', 'T', 'G', 'R', 'A', 'V', 'E', '1'};
+
+// Graves not yet in the index before opening folds them in
+const size_t REBUILD_THRESHOLD = 4096;
+
+void putValue(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t getValue(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint32_t checksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+int recordMile(const uint8_t* record) {
+    return static_cast<int32_t>(getValue(record + 4, 4));
+}
+
+void encodeGrave(const Grave& grave, uint8_t* record) {
+    std::memset(record, 0, RECORD_SIZE);
+    putValue(record, RECORD_MAGIC, 4);
+    putValue(record + 4, static_cast<uint32_t>(std::max(0, grave.mile)), 4);
+    putValue(record + 8, static_cast<uint64_t>(grave.timestamp), 8);
+    record[16] = static_cast<uint8_t>(grave.cause);
+    std::memcpy(record + 20, grave.name.data(), std::min(grave.name.size(), NAME_SIZE - 1));
+    std::memcpy(record + 48, grave.epitaph.data(), std::min(grave.epitaph.size(), EPITAPH_SIZE - 1));
+    putValue(record + 92, checksum(record, RECORD_SIZE - 4), 4);
+}
+
+bool isValidRecord(const uint8_t* record) {
+    return getValue(record, 4) == RECORD_MAGIC &&
+           getValue(record + 92, 4) == checksum(record, RECORD_SIZE - 4) &&
+           record[16] < DEATH_CAUSE_COUNT && recordMile(record) >= 0;
+}
+
+Grave decodeGrave(const uint8_t* record) {
+    Grave grave;
+    grave.mile = recordMile(record);
+    grave.timestamp = static_cast<int64_t>(getValue(record + 8, 8));
+    grave.cause = static_cast<DeathCause>(record[16]);
+    const char* name = reinterpret_cast<const char*>(record + 20);
+    grave.name.assign(name, strnlen(name, NAME_SIZE));
+    const char* epitaph = reinterpret_cast<const char*>(record + 48);
+    grave.epitaph.assign(epitaph, strnlen(epitaph, EPITAPH_SIZE));
+    return grave;
+}
+
+// Whole records of the log from offset on; a torn last record is left out
+std::vector<uint8_t> readLogFrom(int fd, uint64_t offset) {
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) <= offset) {
+        return std::vector<uint8_t>();
+    }
+    uint64_t size = (static_cast<uint64_t>(info.st_size) - offset) / RECORD_SIZE * RECORD_SIZE;
+    std::vector<uint8_t> data(size);
+    size_t done = 0;
+    while (done < size) {
+        ssize_t got = ::pread(fd, data.data() + done, size - done, static_cast<off_t>(offset + done));
+        if (got <= 0) {
+            break;
+        }
+        done += static_cast<size_t>(got);
+    }
+    data.resize(done / RECORD_SIZE * RECORD_SIZE);
+    return data;
+}
+
+} // namespace
+
+std::string makeEpitaph(const std::string& name, DeathCause cause) {
+    static const char* const illness[] = {"Taken by fever", "Sick but never complained", "Gone ahead to Oregon"};
+    static const char* const starvation[] = {"Hungry no more", "Shared the last of the food", "Starved on the trail"};
+    static const char* const exposure[] = {"Froze in the night", "The cold came too soon", "Rest warm now"};
+    static const char* const drowning[] = {"Should have caulked the wagon", "The river took them", "Drowned crossing"};
+    static const char* const dysentery[] = {"Died of dysentery", "Dysentery got the better of them", "Here lies a dysentery victim"};
+    static const char* const other[] = {"Rest in peace"};
+
+    const char* const* choices = other;
+    size_t count = 1;
+    switch (cause) {
+        case DeathCause::Illness:    choices = illness;    count = 3; break;
+        case DeathCause::Starvation: choices = starvation; count = 3; break;
+        case DeathCause::Exposure:   choices = exposure;   count = 3; break;
+        case DeathCause::Drowning:   choices = drowning;   count = 3; break;
+        case DeathCause::Dysentery:  choices = dysentery;  count = 3; break;
+        case DeathCause::None:       break;
+    }
+    uint32_t hash = checksum(reinterpret_cast<const uint8_t*>(name.data()), name.size());
+    return choices[hash % count];
+}
+
+TombstoneRegistry::TombstoneRegistry(const std::string& directory)
+    : m_directory(directory)
+    , m_logPath(directory + "/graves.log")
+    , m_indexPath(directory + "/graves.idx")
+{
+    // An index that is there but will not map is rebuilt from the log
+    bool damaged = !mapIndex() && ::access(m_indexPath.c_str(), F_OK) == 0;
+    loadRecent();
+    if (damaged || m_recent.size() > REBUILD_THRESHOLD) {
+        rebuildIndex();
+    }
+    std::cout << "Tombstone registry " << m_directory << ": " << getGraveCount() << " graves" << std::endl;
+}
+
+TombstoneRegistry::~TombstoneRegistry() {
+    unmapIndex();
+    if (m_logFd >= 0) {
+        ::close(m_logFd);
+    }
+}
+
+bool TombstoneRegistry::mapIndex() {
+    int fd = ::open(m_indexPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    size_t size = ::fstat(fd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    void* map = size >= INDEX_HEADER_SIZE ? ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(map);
+    uint64_t count = getValue(bytes + 16, 8);
+    uint32_t mileCount = static_cast<uint32_t>(getValue(bytes + 24, 4));
+    size_t tableSize = (static_cast<size_t>(mileCount) + 1) * sizeof(uint64_t);
+    bool valid = std::memcmp(bytes, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 && getValue(bytes + 28, 4) == RECORD_SIZE &&
+                 size >= INDEX_HEADER_SIZE + tableSize && count == (size - INDEX_HEADER_SIZE - tableSize) / RECORD_SIZE &&
+                 size == INDEX_HEADER_SIZE + tableSize + count * RECORD_SIZE;
+    // Lookups trust the mile starts to stay in order and within the records
+    uint64_t previous = 0;
+    for (uint32_t mile = 0; valid && mile <= mileCount; ++mile) {
+        uint64_t start = getValue(bytes + INDEX_HEADER_SIZE + mile * sizeof(uint64_t), 8);
+        valid = start >= previous && start <= count;
+        previous = start;
+    }
+    if (!valid || previous != count) {
+        std::cerr << "Ignoring damaged grave index " << m_indexPath << std::endl;
+        ::munmap(map, size);
+        return false;
+    }
+
+    ::madvise(map, size, MADV_RANDOM);
+    m_map = map;
+    m_mapSize = size;
+    m_logCovered = getValue(bytes + 8, 8);
+    m_indexedCount = count;
+    m_mileCount = mileCount;
+    m_mileStarts = bytes + INDEX_HEADER_SIZE;
+    m_records = bytes + INDEX_HEADER_SIZE + tableSize;
+    return true;
+}
+
+void TombstoneRegistry::unmapIndex() {
+    if (m_map) {
+        ::munmap(m_map, m_mapSize);
+    }
+    m_map = nullptr;
+    m_mapSize = 0;
+    m_mileStarts = nullptr;
+    m_records = nullptr;
+    m_mileCount = 0;
+    m_indexedCount = 0;
+    m_logCovered = 0;
+}
+
+void TombstoneRegistry::loadRecent() {
+    m_recent.clear();
+    int fd = ::open(m_logPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    std::vector<uint8_t> log = readLogFrom(fd, m_logCovered);
+    ::close(fd);
+
+    for (size_t offset = 0; offset < log.size(); offset += RECORD_SIZE) {
+        if (isValidRecord(log.data() + offset)) {
+            m_recent.push_back(decodeGrave(log.data() + offset));
+        }
+    }
+    std::stable_sort(m_recent.begin(), m_recent.end(),
+                     [](const Grave& a, const Grave& b) { return a.mile < b.mile; });
+}
+
+void TombstoneRegistry::addGrave(const Grave& grave) {
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    uint8_t record[RECORD_SIZE];
+    encodeGrave(grave, record);
+
+    if (m_logFd < 0) {
+        m_logFd = ::open(m_logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    }
+    if (m_logFd < 0 || ::flock(m_logFd, LOCK_EX) != 0) {
+        std::cerr << "Unable to record grave in " << m_logPath << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+    if (::write(m_logFd, record, RECORD_SIZE) != static_cast<ssize_t>(RECORD_SIZE)) {
+        std::cerr << "Unable to record grave in " << m_logPath << ": " << std::strerror(errno) << std::endl;
+    }
+    ::flock(m_logFd, LOCK_UN);
+
+    auto position = std::upper_bound(m_recent.begin(), m_recent.end(), grave,
+                                     [](const Grave& a, const Grave& b) { return a.mile < b.mile; });
+    m_recent.insert(position, decodeGrave(record));
+}
+
+std::vector<Grave> TombstoneRegistry::findGraves(int fromMile, int toMile, size_t limit) const {
+    std::vector<Grave> graves;
+    fromMile = std::max(0, fromMile);
+    if (toMile < fromMile || limit == 0) {
+        return graves;
+    }
+
+    // Indexed graves in range: [first, last)
+    uint64_t first = 0;
+    uint64_t last = 0;
+    if (m_map && static_cast<uint32_t>(fromMile) < m_mileCount) {
+        uint32_t end = std::min<uint32_t>(static_cast<uint32_t>(toMile) + 1, m_mileCount);
+        first = getValue(m_mileStarts + fromMile * sizeof(uint64_t), 8);
+        last = getValue(m_mileStarts + end * sizeof(uint64_t), 8);
+    }
+
+    // Recent graves in range, merged in by mile
+    auto recent = std::lower_bound(m_recent.begin(), m_recent.end(), fromMile,
+                                   [](const Grave& grave, int mile) { return grave.mile < mile; });
+    while (graves.size() < limit) {
+        bool haveRecent = recent != m_recent.end() && recent->mile <= toMile;
+        bool haveIndexed = first < last;
+        if (!haveRecent && !haveIndexed) {
+            break;
+        }
+        if (haveIndexed && (!haveRecent || recordMile(m_records + first * RECORD_SIZE) <= recent->mile)) {
+            graves.push_back(decodeGrave(m_records + first * RECORD_SIZE));
+            first++;
+        } else {
+            graves.push_back(*recent);
+            ++recent;
+        }
+    }
+    return graves;
+}
+
+bool TombstoneRegistry::rebuildIndex() {
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    int fd = ::open(m_logPath.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0 || ::flock(fd, LOCK_EX) != 0) {
+        std::cerr << "Unable to lock grave log " << m_logPath << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+
+    // Another process may have rebuilt it since we mapped it
+    unmapIndex();
+    mapIndex();
+
+    // Graves the index holds are copied over as they are, so a damaged one
+    // means starting again from the whole log
+    for (uint64_t i = 0; i < m_indexedCount; ++i) {
+        if (!isValidRecord(m_records + i * RECORD_SIZE)) {
+            std::cerr << "Rebuilding damaged grave index " << m_indexPath << " from the log" << std::endl;
+            unmapIndex();
+            break;
+        }
+    }
+
+    // A writer died mid-record; nobody else can be writing while we hold the lock
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size % RECORD_SIZE != 0) {
+        if (::ftruncate(fd, info.st_size - info.st_size % RECORD_SIZE) != 0) {
+            std::cerr << "Unable to trim grave log: " << std::strerror(errno) << std::endl;
+        }
+    }
+    std::vector<uint8_t> log = readLogFrom(fd, m_logCovered);
+    uint64_t covered = m_logCovered + log.size();
+
+    // Counting sort by mile: indexed graves first (already in order), then
+    // the log tail, so graves at the same mile stay oldest first
+    std::vector<const uint8_t*> records;
+    records.reserve(m_indexedCount + log.size() / RECORD_SIZE);
+    for (uint64_t i = 0; i < m_indexedCount; ++i) {
+        records.push_back(m_records + i * RECORD_SIZE);
+    }
+    for (size_t offset = 0; offset < log.size(); offset += RECORD_SIZE) {
+        if (isValidRecord(log.data() + offset)) {
+            records.push_back(log.data() + offset);
+        }
+    }
+
+    uint32_t mileCount = 1;
+    for (const uint8_t* record : records) {
+        mileCount = std::max<uint32_t>(mileCount, static_cast<uint32_t>(recordMile(record)) + 1);
+    }
+    std::vector<uint64_t> starts(static_cast<size_t>(mileCount) + 1, 0);
+    for (const uint8_t* record : records) {
+        starts[recordMile(record) + 1]++;
+    }
+    for (size_t mile = 1; mile < starts.size(); ++mile) {
+        starts[mile] += starts[mile - 1];
+    }
+
+    size_t tableSize = starts.size() * sizeof(uint64_t);
+    std::vector<uint8_t> data(INDEX_HEADER_SIZE + tableSize + records.size() * RECORD_SIZE, 0);
+    std::memcpy(data.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    putValue(data.data() + 8, covered, 8);
+    putValue(data.data() + 16, records.size(), 8);
+    putValue(data.data() + 24, mileCount, 4);
+    putValue(data.data() + 28, RECORD_SIZE, 4);
+    for (size_t mile = 0; mile < starts.size(); ++mile) {
+        putValue(data.data() + INDEX_HEADER_SIZE + mile * sizeof(uint64_t), starts[mile], 8);
+    }
+    std::vector<uint64_t> next(starts.begin(), starts.end() - 1);
+    uint8_t* out = data.data() + INDEX_HEADER_SIZE + tableSize;
+    for (const uint8_t* record : records) {
+        std::memcpy(out + next[recordMile(record)]++ * RECORD_SIZE, record, RECORD_SIZE);
+    }
+
+    std::string temporaryPath = m_indexPath + ".tmp." + std::to_string(::getpid());
+    FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+    bool written = file && std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    written = file && std::fclose(file) == 0 && written;
+    bool replaced = written && std::rename(temporaryPath.c_str(), m_indexPath.c_str()) == 0;
+    if (!replaced) {
+        std::cerr << "Unable to write grave index " << m_indexPath << std::endl;
+        std::remove(temporaryPath.c_str());
+    }
+
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+
+    unmapIndex();
+    mapIndex();
+    loadRecent();
+    return replaced;
+}
@@ -0,0 +1,78 @@
+#ifndef TOMBSTONES_HPP
+#define TOMBSTONES_HPP
+
+#include "journey.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A grave left on the trail by an earlier journey
+struct Grave {
+    int mile = 0;
+    int64_t timestamp = 0;          // Seconds since the epoch
+    DeathCause cause = DeathCause::None;
+    std::string name;
+    std::string epitaph;
+};
+
+// Words on the headstone for someone who died of cause; varies by name
+std::string makeEpitaph(const std::string& name, DeathCause cause);
+
+// Graves from every journey played with this directory, found by trail
+// mile so the ones just passed can be shown as the wagon goes by.
+//
+//   graves.log   append-only fixed 96-byte records, shared by every game
+//                process through flock()
+//   graves.idx   every grave up to some point in the log, sorted by mile,
+//                behind a table of where each mile starts. Mapped
+//                read-only; finding the graves between two miles is two
+//                table reads, however many graves there are.
+//
+// Graves added since the index was built are kept in a small sorted list
+// in memory. Opening the registry folds them into a new index once that
+// list gets long.
+class TombstoneRegistry {
+public:
+    explicit TombstoneRegistry(const std::string& directory);
+    ~TombstoneRegistry();
+
+    TombstoneRegistry(const TombstoneRegistry&) = delete;
+    TombstoneRegistry& operator=(const TombstoneRegistry&) = delete;
+
+    // Appends to the log (left to the page cache; called on the input path)
+    void addGrave(const Grave& grave);
+
+    // Graves with fromMile <= mile <= toMile, nearest the start first, at
+    // most limit of them
+    std::vector<Grave> findGraves(int fromMile, int toMile, size_t limit) const;
+
+    uint64_t getGraveCount() const { return m_indexedCount + m_recent.size(); }
+
+    // Merge the log into a fresh index now
+    bool rebuildIndex();
+
+private:
+    bool mapIndex();
+    void unmapIndex();
+    void loadRecent();
+
+    std::string m_directory;
+    std::string m_logPath;
+    std::string m_indexPath;
+    int m_logFd = -1;                           // Opened on the first grave
+
+    // Mapped index
+    void* m_map = nullptr;
+    size_t m_mapSize = 0;
+    const uint8_t* m_mileStarts = nullptr;      // m_mileCount + 1 u64 entries
+    const uint8_t* m_records = nullptr;
+    uint32_t m_mileCount = 0;
+    uint64_t m_indexedCount = 0;
+    uint64_t m_logCovered = 0;                  // Log bytes in the index
+
+    // Graves in the log past m_logCovered, sorted by mile
+    std::vector<Grave> m_recent;
+};
+
+#endif // TOMBSTONES_HPP
@@ -0,0 +1,145 @@
+#include "trail_data.hpp"
+#include "heap_tracker.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Same format as resources/data/trail.txt
+const char* const DEFAULT_TRAIL =
+    "0|Independence, Missouri|Starting point of the Oregon Trail|landmark|0\n"
+    "102|Kansas River Crossing|The wide Kansas River needs to be crossed.|river|4\n"
+    "185|Big Blue River Crossing|The Big Blue River is normally easy to cross, but recent rains have made it challenging.|river|3\n"
+    "304|Fort Kearney|Fort Kearney is a military post and emigrant supply point.|landmark|0\n"
+    "554|Chimney Rock|Chimney Rock is a famous landmark on the trail, visible from miles away.|landmark|0\n"
+    "640|Fort Laramie|Fort Laramie is an important supply and rest point.|landmark|0\n"
+    "830|Independence Rock|Pioneers try to reach Independence Rock by July 4th to stay on schedule.|landmark|0\n"
+    "932|South Pass|South Pass is a relatively easy passage through the Rocky Mountains.|landmark|0\n"
+    "989|Green River Crossing|The Green River is deep and dangerous to cross.|river|6\n"
+    "1085|Fort Bridger|Fort Bridger is a trading post founded by Jim Bridger.|landmark|0\n"
+    "1256|Snake River Crossing|The Snake River is treacherous and difficult to cross.|river|5\n"
+    "1288|Fort Hall|Fort Hall is an important trading post and supply point.|landmark|0\n"
+    "1410|Fort Boise|Fort Boise is your last major stop before the Blue Mountains.|landmark|0\n"
+    "1920|The Dalles|The Dalles is the end of the overland portion of the trail for many emigrants.|landmark|0\n"
+    "2040|Oregon City, Oregon|Oregon City is the end of the Oregon Trail and your final destination.|landmark|0\n";
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, '|')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+// Parse trail lines into data; invalid lines are reported and skipped
+void parseTrail(std::istream& input, TrailData& trail) {
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::vector<std::string> fields = splitFields(line);
+        if (fields.size() < 3) {
+            std::cerr << "Trail data line " << lineNumber << " is missing fields" << std::endl;
+            continue;
+        }
+
+        try {
+            int distance = std::stoi(fields[0]);
+            bool isRiver = fields.size() > 3 && fields[3] == "river";
+            int depth = fields.size() > 4 ? std::stoi(fields[4]) : 0;
+            trail.landmarks.emplace_back(fields[1], distance, fields[2], true, isRiver, depth);
+        } catch (const std::exception&) {
+            std::cerr << "Trail data line " << lineNumber << " has an invalid number" << std::endl;
+        }
+    }
+
+    // The journey and the asset streamer walk landmarks in trail order
+    auto byDistance = [](const Location& a, const Location& b) { return a.distance < b.distance; };
+    if (!std::is_sorted(trail.landmarks.begin(), trail.landmarks.end(), byDistance)) {
+        std::cerr << "Trail data landmarks are out of order; sorting them by distance" << std::endl;
+        std::stable_sort(trail.landmarks.begin(), trail.landmarks.end(), byDistance);
+    }
+
+    // Hash the parsed content so comment edits do not change the identity
+    uint64_t hash = hashBytes(nullptr, 0);
+    for (const auto& landmark : trail.landmarks) {
+        int numbers[3] = {landmark.distance, landmark.isRiver ? 1 : 0, landmark.riverDepth};
+        hash = hashBytes(numbers, sizeof(numbers), hash);
+        hash = hashBytes(landmark.name.data(), landmark.name.size() + 1, hash);
+        hash = hashBytes(landmark.description.data(), landmark.description.size() + 1, hash);
+    }
+    trail.hash = hash;
+}
+
+} // namespace
+
+int TrailData::getTotalDistance() const {
+    return landmarks.empty() ? 0 : landmarks.back().distance;
+}
+
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::shared_ptr<const TrailData> defaultTrailData() {
+    static const std::shared_ptr<const TrailData> trail = [] {
+        HeapScope scope(HeapSubsystem::Other);      // Kept for the whole run
+        auto data = std::make_shared<TrailData>();
+        std::istringstream input(DEFAULT_TRAIL);
+        parseTrail(input, *data);
+        data->source = "built-in";
+        return data;
+    }();
+    return trail;
+}
+
+std::shared_ptr<const TrailData> loadTrailData(const std::string& path) {
+    std::ifstream trailFile(path);
+    if (!trailFile.is_open()) {
+        std::cerr << "Unable to open trail data " << path << ", using built-in trail" << std::endl;
+        return defaultTrailData();
+    }
+
+    auto data = std::make_shared<TrailData>();
+    parseTrail(trailFile, *data);
+    data->source = path;
+
+    if (data->landmarks.empty()) {
+        std::cerr << "Trail data " << path << " has no landmarks, using built-in trail" << std::endl;
+        return defaultTrailData();
+    }
+
+    std::cout << "Loaded " << data->landmarks.size() << " landmarks from " << path << std::endl;
+    return data;
+}
+
+std::shared_ptr<const TrailData> loadTrailData(const char* data, size_t size, const std::string& source) {
+    auto trail = std::make_shared<TrailData>();
+    std::istringstream input(std::string(data, size));
+    parseTrail(input, *trail);
+    trail->source = source;
+
+    if (trail->landmarks.empty()) {
+        std::cerr << "Trail data " << source << " has no landmarks, using built-in trail" << std::endl;
+        return defaultTrailData();
+    }
+
+    std::cout << "Loaded " << trail->landmarks.size() << " landmarks from " << source << std::endl;
+    return trail;
+}
@@ -0,0 +1,50 @@
+#ifndef TRAIL_DATA_HPP
+#define TRAIL_DATA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Represents a location on the trail
+struct Location {
+    std::string name;
+    int distance;       // Miles from start
+    std::string description;
+    bool isLandmark;
+    bool isRiver;
+    int riverDepth;     // If isRiver is true
+
+    Location(const std::string& name, int distance, const std::string& description,
+             bool isLandmark = false, bool isRiver = false, int riverDepth = 0)
+        : name(name), distance(distance), description(description),
+          isLandmark(isLandmark), isRiver(isRiver), riverDepth(riverDepth) {}
+};
+
+// The landmarks of one trail. Loaded once and shared read-only by every
+// journey that uses it.
+struct TrailData {
+    std::vector<Location> landmarks;
+    uint64_t hash = 0;          // Identifies the content, independent of comments
+    std::string source;         // File it was loaded from, or "built-in"
+
+    // Miles to the final landmark
+    int getTotalDistance() const;
+};
+
+// Load landmarks from a trail data file; falls back to the built-in trail if
+// the file is missing or has no valid entries
+std::shared_ptr<const TrailData> loadTrailData(const std::string& path);
+
+// The same, from file contents already in memory (a resource pack entry);
+// source names it in messages
+std::shared_ptr<const TrailData> loadTrailData(const char* data, size_t size, const std::string& source);
+
+// The classic 1848 trail from Independence to Oregon City
+std::shared_ptr<const TrailData> defaultTrailData();
+
+// 64-bit FNV-1a, used to key caches by content
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL);
+
+#endif // TRAIL_DATA_HPP
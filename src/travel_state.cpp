@@ -1,1321 +1,785 @@
 #include "travel_state.hpp"
 #include "game.hpp"
+#include "asset_cache.hpp"
+#include "frame_arena.hpp"
 #include "menu_state.hpp"
+#include "high_scores.hpp"
+#include "save_slots.hpp"
+#include "frame_profiler.hpp"
+#include "text_cache.hpp"
 #include <iostream>
 #include <algorithm>
-#include <sstream>
-#include <ctime>
+#include <cmath>
 #include <random>
 #include <SDL2/SDL.h>
 
+namespace {
+
+// How long SPACE has to be held before the wagon keeps going by itself
+const float HOLD_TO_TRAVEL_DELAY = 0.35f;
+
+// Continuous travel stays at most this many days ahead of the simulation,
+// so a stop shows on screen on the day it happened
+const uint64_t MAX_TRAVEL_DAYS_AHEAD = 4;
+
+// Which landmarks have which art, ambient audio and music
+const char* const LANDMARK_ASSETS_PATH = "resources/data/landmark_assets.txt";
+
+// Largest size landmark art is drawn at on the landmark screen
+const int LANDMARK_ART_WIDTH = 320;
+const int LANDMARK_ART_HEIGHT = 180;
+
+const char* const MONTH_NAMES[] = {"", "January", "February", "March", "April", "May", "June",
+                                   "July", "August", "September", "October", "November", "December"};
+const char* const WEATHER_NAMES[] = {"Fair", "Cloudy", "Rainy", "Stormy", "Snowy"};
+
+const char* healthWord(int health) {
+    if (health < 20) return "Critical";
+    if (health < 50) return "Poor";
+    if (health < 80) return "Fair";
+    return "Good";
+}
+
+} // namespace
+
 // Constructor
 TravelState::TravelState(Game* game, const std::string& profession)
     : GameState(game)
-    , m_profession(profession)
-    , m_rng(std::random_device{}())
+    , m_session(Journey(profession, std::random_device{}(), game->getSimParams(profession), game->getTrail()),
+                game->getRewindBudget())
+    , m_journey(m_session.getJourney())
 {
     std::cout << "TravelState initialized with profession: " << profession << std::endl;
-    
-    // Setup starting resources based on profession
-    if (profession == "Banker") {
-        m_resources = Resources(1600);
-    } else if (profession == "Carpenter") {
-        m_resources = Resources(800);
-    } else if (profession == "Farmer") {
-        m_resources = Resources(400);
-    } else {
-        // Default
-        m_resources = Resources(1000);
+
+    if (!game->getRecordingDirectory().empty()) {
+        m_session.startRecording(game->getRecordingDirectory());
     }
     
-    // Initialize landmarks
-    m_landmarks = {
-        Location("Independence, Missouri", 0, "Starting point of the Oregon Trail", true),
-        Location("Kansas River Crossing", 102, "The wide Kansas River needs to be crossed.", true, true, 4),
-        Location("Big Blue River Crossing", 185, "The Big Blue River is normally easy to cross, but recent rains have made it challenging.", true, true, 3),
-        Location("Fort Kearney", 304, "Fort Kearney is a military post and emigrant supply point.", true),
-        Location("Chimney Rock", 554, "Chimney Rock is a famous landmark on the trail, visible from miles away.", true),
-        Location("Fort Laramie", 640, "Fort Laramie is an important supply and rest point.", true),
-        Location("Independence Rock", 830, "Pioneers try to reach Independence Rock by July 4th to stay on schedule.", true),
-        Location("South Pass", 932, "South Pass is a relatively easy passage through the Rocky Mountains.", true),
-        Location("Green River Crossing", 989, "The Green River is deep and dangerous to cross.", true, true, 6),
-        Location("Fort Bridger", 1085, "Fort Bridger is a trading post founded by Jim Bridger.", true),
-        Location("Snake River Crossing", 1256, "The Snake River is treacherous and difficult to cross.", true, true, 5),
-        Location("Fort Hall", 1288, "Fort Hall is an important trading post and supply point.", true),
-        Location("Fort Boise", 1410, "Fort Boise is your last major stop before the Blue Mountains.", true),
-        Location("The Dalles", 1920, "The Dalles is the end of the overland portion of the trail for many emigrants.", true),
-        Location("Oregon City, Oregon", 2040, "Oregon City is the end of the Oregon Trail and your final destination.", true)
-    };
-    
-    // Set up help text
-    m_helpText = "SPACE: Continue | 1: Rest | 2: Hunt | 3: Trade | 4: Check Supplies | ESC: Return to Menu";
+    setupHelpText();
 }
 
-TravelState::~TravelState() {
-    if (m_font) {
-        TTF_CloseFont(m_font);
-        m_font = nullptr;
+TravelState::TravelState(Game* game, JourneySession session, int saveSlot)
+    : GameState(game)
+    , m_session(std::move(session))
+    , m_journey(m_session.getJourney())
+    , m_needsSetup(false)
+    , m_saveSlot(saveSlot)
+{
+    std::cout << "TravelState resuming " << m_journey.getProfession() << " journey at day "
+              << m_journey.getDaysElapsed() << std::endl;
+
+    if (!game->getRecordingDirectory().empty()) {
+        m_session.startRecording(game->getRecordingDirectory(), true);
+    }
+
+    setupHelpText();
+}
+
+void TravelState::setupHelpText() {
+    m_helpText = m_game->isTravelToggle() ? "SPACE: Travel/Stop" : "SPACE: Continue (hold to keep going)";
+    m_helpText += " | 1: Rest | 2: Hunt | 3: Trade | 4: Check Supplies | F5: Save | ESC: Return to Menu";
+    if (m_session.getHistory()) {
+        m_helpText += " | BACKSPACE: Rewind a day";
     }
 }
 
+TravelState::~TravelState() {
+    // Stop the simulation before anything it uses goes away
+    m_sim.reset();
+}
+
 void TravelState::enter() {
     std::cout << "Entering TravelState" << std::endl;
     
-    // Load font if not already loaded
+    // Shared with every other state; only the first one to ask loads it
     if (!m_font) {
-        std::cout << "Attempting to load font for TravelState" << std::endl;
-        m_font = TTF_OpenFont("assets/fonts/apple2.ttf", 16);
-        if (!m_font) {
-            std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
-            
-            // Try fallback fonts
-            const char* fallbackFonts[] = {
-                "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
-                "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
-                "/usr/share/fonts/truetype/liberation/LiberationMono-Regular.ttf",
-                nullptr
-            };
-            
-            for (int i = 0; fallbackFonts[i] != nullptr; i++) {
-                std::cout << "Trying fallback font: " << fallbackFonts[i] << std::endl;
-                m_font = TTF_OpenFont(fallbackFonts[i], 16);
-                if (m_font) {
-                    std::cout << "Successfully loaded fallback font: " << fallbackFonts[i] << std::endl;
-                    break;
-                }
-            }
-            
-            if (!m_font) {
-                std::cerr << "Failed to load any fallback font: " << TTF_GetError() << std::endl;
-            }
-        } else {
-            std::cout << "Successfully loaded font for TravelState" << std::endl;
-        }
+        m_font = m_game->getAssets()->getDefaultFont(16);
     }
     
     // Start in setup state
-    m_subState = TravelSubState::Setup;
-    setupInitialJourney();
+    if (m_needsSetup) {
+        m_journey.setupInitialJourney();
+        m_needsSetup = false;
+    }
+
+    if (m_game->getAutosave()) {
+        m_session.startAutosave(*m_game->getAutosave());
+    }
+    m_session.setTombstones(m_game->getTombstones());
+    
+    if (!m_streamer) {
+        auto lines = m_game->getAssets()->getTextLines(LANDMARK_ASSETS_PATH);
+        LandmarkAssets assets = lines ? parseLandmarkAssets(*lines, m_journey.getTrail())
+                                      : LandmarkAssets(m_journey.getLandmarks().size());
+        m_streamer = std::make_unique<AssetStreamer>(*m_game->getAssets(), *m_game->getJobs(),
+                                                     std::move(assets), m_game->getAssetBudget());
+    }
+    
+    // From here until exit() the session belongs to the simulation thread
+    if (!m_sim) {
+        m_sim = std::make_unique<SimulationThread>(
+            [this](const SimInput& input) { simulateInput(input); },
+            [this](JourneyView& view) { fillView(view); });
+    }
 }
 
 void TravelState::exit() {
     std::cout << "Exiting TravelState" << std::endl;
+    m_sim.reset();
+    m_view = nullptr;
+    m_handledSteps = 0;
+    m_spaceHeld = false;
+    stopTravel();
+    m_landmarkArt.reset();
+    m_landmarkArtIndex = -1;
 }
 
 void TravelState::handleEvent(const SDL_Event& event) {
-    if (event.type == SDL_KEYDOWN) {
-        std::cout << "TravelState: Key pressed: " << SDL_GetKeyName(event.key.keysym.sym) << std::endl;
-        
-        // Handle differently based on sub-state
-        switch (m_subState) {
-            case TravelSubState::Setup:
-                handleSetupInput(event.key.keysym.sym);
-                break;
-                
-            case TravelSubState::Traveling:
-                handleTravelInput(event.key.keysym.sym);
-                break;
-                
-            case TravelSubState::Location:
-                if (event.key.keysym.sym == SDLK_SPACE) {
-                    m_subState = TravelSubState::Traveling;
-                } else if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    returnToMenu();
-                }
-                break;
-                
-            case TravelSubState::River:
-                if (event.key.keysym.sym == SDLK_1) {
-                    // Ford the river
-                    std::cout << "Fording the river" << std::endl;
-                    // Simple chance of success based on river depth
-                    int currentLandmarkIndex = std::max(0, m_nextLandmarkIndex - 1);
-                    if (currentLandmarkIndex < static_cast<int>(m_landmarks.size()) && 
-                        m_landmarks[currentLandmarkIndex].isRiver) {
-                        
-                        int depth = m_landmarks[currentLandmarkIndex].riverDepth;
-                        std::uniform_int_distribution<> dis(1, 10);
-                        int roll = dis(m_rng);
-                        
-                        if (roll > depth) {
-                            m_eventMessage = "You successfully forded the river!";
-                        } else {
-                            m_eventMessage = "Disaster! Your wagon tipped while crossing!";
-                            // Lose some supplies
-                            int foodLoss = std::min(m_resources.food / 4, 50);
-                            m_resources.food -= foodLoss;
-                            
-                            // Possible injury to party member
-                            std::uniform_int_distribution<> partyDis(0, m_party.size() - 1);
-                            int memberIndex = partyDis(m_rng);
-                            m_party[memberIndex].health -= 20;
-                            if (m_party[memberIndex].health <= 0) {
-                                m_party[memberIndex].isAlive = false;
-                                m_eventMessage += " " + m_party[memberIndex].name + " has drowned.";
-                            } else {
-                                m_eventMessage += " " + m_party[memberIndex].name + " was injured.";
-                            }
-                        }
-                    }
-                    m_subState = TravelSubState::Event;
-                } else if (event.key.keysym.sym == SDLK_2) {
-                    // Caulk the wagon
-                    std::cout << "Caulking the wagon" << std::endl;
-                    // Higher chance of success but uses resources
-                    if (m_resources.wagonParts >= 1) {
-                        m_resources.wagonParts--;
-                        std::uniform_int_distribution<> dis(1, 10);
-                        int roll = dis(m_rng);
-                        
-                        if (roll > 2) {
-                            m_eventMessage = "You successfully caulked and floated the wagon across!";
-                        } else {
-                            m_eventMessage = "The river was too deep! Your wagon and supplies were damaged.";
-                            // Lose more supplies
-                            int foodLoss = std::min(m_resources.food / 3, 75);
-                            m_resources.food -= foodLoss;
-                            m_resources.clothing = std::max(0, m_resources.clothing - 1);
-                        }
-                    } else {
-                        m_eventMessage = "You don't have enough wagon parts to caulk the wagon.";
-                    }
-                    m_subState = TravelSubState::Event;
-                } else if (event.key.keysym.sym == SDLK_3) {
-                    // Hire a guide
-                    std::cout << "Hiring a guide" << std::endl;
-                    if (m_resources.money >= 40) {
-                        m_resources.money -= 40;
-                        m_eventMessage = "You hired a guide to help you cross the river safely.";
-                        m_subState = TravelSubState::Event;
-                    } else {
-                        m_eventMessage = "You don't have enough money to hire a guide.";
-                        m_subState = TravelSubState::Event;
-                    }
-                } else if (event.key.keysym.sym == SDLK_4) {
-                    // Wait for conditions to improve
-                    std::cout << "Waiting for conditions to improve" << std::endl;
-                    std::uniform_int_distribution<> dis(1, 5);
-                    int daysToWait = dis(m_rng);
-                    for (int i = 0; i < daysToWait; i++) {
-                        advanceDay();
-                    }
-                    m_eventMessage = "You waited " + std::to_string(daysToWait) + 
-                                     " days for river conditions to improve. The river seems a bit calmer now.";
-                    m_subState = TravelSubState::Event;
-                } else if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    returnToMenu();
-                }
-                break;
-                
-            case TravelSubState::Event:
-                if (event.key.keysym.sym == SDLK_SPACE || 
-                    event.key.keysym.sym == SDLK_RETURN) {
-                    // Continue after the event
-                    m_subState = TravelSubState::Traveling;
-                } else if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    returnToMenu();
-                }
-                break;
-                
-            case TravelSubState::Hunting:
-                // Simple hunting mechanics
-                if (event.key.keysym.sym == SDLK_SPACE) {
-                    if (m_resources.ammunition > 0) {
-                        m_resources.ammunition--;
-                        std::uniform_int_distribution<> dis(1, 10);
-                        int roll = dis(m_rng);
-                        if (roll > 3) { // 70% chance of success
-                            int foodGained = roll * 10; // 40-100 pounds of food
-                            m_resources.food += foodGained;
-                            m_eventMessage = "Successful hunt! You gained " + 
-                                            std::to_string(foodGained) + " pounds of food.";
-                        } else {
-                            m_eventMessage = "The hunt was unsuccessful. You wasted ammunition.";
-                        }
-                        m_subState = TravelSubState::Event;
-                    } else {
-                        m_eventMessage = "You're out of ammunition. You cannot hunt.";
-                        m_subState = TravelSubState::Event;
-                    }
-                } else if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    // Return to travel
-                    m_subState = TravelSubState::Traveling;
-                }
-                break;
-                
-            case TravelSubState::Trading:
-                // Simple trading interface
-                if (event.key.keysym.sym == SDLK_1 && m_resources.money >= 20) {
-                    // Buy food
-                    m_resources.money -= 20;
-                    m_resources.food += 50;
-                    m_eventMessage = "You purchased 50 pounds of food for $20.";
-                    m_subState = TravelSubState::Event;
-                } else if (event.key.keysym.sym == SDLK_2 && m_resources.money >= 10) {
-                    // Buy ammunition
-                    m_resources.money -= 10;
-                    m_resources.ammunition += 20;
-                    m_eventMessage = "You purchased 20 bullets for $10.";
-                    m_subState = TravelSubState::Event;
-                } else if (event.key.keysym.sym == SDLK_3 && m_resources.money >= 15) {
-                    // Buy clothing
-                    m_resources.money -= 15;
-                    m_resources.clothing += 1;
-                    m_eventMessage = "You purchased 1 set of clothing for $15.";
-                    m_subState = TravelSubState::Event;
-                } else if (event.key.keysym.sym == SDLK_4 && m_resources.money >= 35) {
-                    // Buy wagon parts
-                    m_resources.money -= 35;
-                    m_resources.wagonParts += 1;
-                    m_eventMessage = "You purchased 1 wagon part for $35.";
-                    m_subState = TravelSubState::Event;
-                } else if (event.key.keysym.sym == SDLK_5 && m_resources.money >= 25) {
-                    // Buy medicine
-                    m_resources.money -= 25;
-                    m_resources.medicines += 1;
-                    m_eventMessage = "You purchased 1 medicine kit for $25.";
-                    m_subState = TravelSubState::Event;
-                } else if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    // Exit trading
-                    m_subState = TravelSubState::Traveling;
-                }
-                break;
-                
-            case TravelSubState::Resting:
-                if (event.key.keysym.sym == SDLK_1) {
-                    // Rest for 1 day
-                    restForDays(1);
-                    m_subState = TravelSubState::Traveling;
-                } else if (event.key.keysym.sym == SDLK_2) {
-                    // Rest for 3 days
-                    restForDays(3);
-                    m_subState = TravelSubState::Traveling;
-                } else if (event.key.keysym.sym == SDLK_3) {
-                    // Rest for a week
-                    restForDays(7);
-                    m_subState = TravelSubState::Traveling;
-                } else if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    // Don't rest
-                    m_subState = TravelSubState::Traveling;
-                }
-                break;
-                
-            case TravelSubState::GameOver:
-                if (event.key.keysym.sym == SDLK_SPACE || 
-                    event.key.keysym.sym == SDLK_RETURN ||
-                    event.key.keysym.sym == SDLK_ESCAPE) {
-                    // Return to main menu
-                    returnToMenu();
-                }
-                break;
+    if (!m_sim) {
+        return;
+    }
+    
+    if (event.type == SDL_KEYUP && event.key.keysym.sym == SDLK_SPACE) {
+        m_spaceHeld = false;
+        if (!m_game->isTravelToggle()) {
+            stopTravel();
         }
     }
-}
-
-void TravelState::update(float deltaTime) {
-    // Only update game state when needed (after player input)
-    if (!m_needsUpdate)
+    if (event.type != SDL_KEYDOWN) {
         return;
-        
-    m_needsUpdate = false;
+    }
+    SDL_Keycode key = event.key.keysym.sym;
     
-    // Check if game is over
-    if (m_gameOver)
+    // Holding SPACE travels at the chosen rate, not the keyboard's repeat rate
+    if (key == SDLK_SPACE && event.key.repeat) {
         return;
-        
-    if (m_subState != TravelSubState::Traveling)
-        return;
-    
-    // Check for landmarks and rivers
-    checkForLandmark();
-    
-    // Generate random events
-    if (m_subState == TravelSubState::Traveling) {
-        // Small chance of random event each day
-        std::uniform_int_distribution<> dis(1, 100);
-        int roll = dis(m_rng);
-        if (roll <= 15) { // 15% chance
-            triggerRandomEvent();
-        }
     }
-}
-
-void TravelState::render() {
-    // Get renderer
-    SDL_Renderer* renderer = m_game->getRenderer();
+    std::cout << "TravelState: Key pressed: " << SDL_GetKeyName(key) << std::endl;
     
-    // Clear screen to black
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-    
-    // Render different screens based on sub-state
-    switch (m_subState) {
-        case TravelSubState::Setup:
-            renderSetupScreen();
-            break;
-            
-        case TravelSubState::Traveling:
-            renderTravelScreen();
-            break;
-            
-        case TravelSubState::Location:
-            renderLocationScreen();
-            break;
-            
-        case TravelSubState::River:
-            renderRiverScreen();
-            break;
-            
-        case TravelSubState::Hunting:
-            renderHuntingScreen();
-            break;
-            
-        case TravelSubState::Trading:
-            renderTradingScreen();
-            break;
-            
-        case TravelSubState::Event:
-            renderEventScreen();
-            break;
-            
-        case TravelSubState::Resting:
-            renderRestingScreen();
-            break;
-            
-        case TravelSubState::GameOver:
-            renderGameOverScreen();
-            break;
+    if (key == SDLK_SPACE && m_sim->getView().journey.getSubState() == TravelSubState::Traveling) {
+        if (m_game->isTravelToggle()) {
+            if (m_travelling) {
+                stopTravel();
+            } else {
+                startTravel();
+            }
+            return;
+        }
+        // One day now; more if SPACE is still down after a moment
+        m_spaceHeld = true;
+        m_holdTime = 0.0f;
+    } else {
+        stopTravel();
     }
-    
-    // Always render help text at bottom
-    renderTextCentered(m_helpText, m_game->getWindowHeight() - 30);
+    m_sim->submitKey(key);
 }
 
-void TravelState::renderText(const std::string& text, int x, int y) {
-    if (text.empty()) {
+void TravelState::update(float deltaTime) {
+    if (!m_sim) {
         return;
     }
     
-    if (!m_font) {
-        std::cerr << "Cannot render text: font not loaded" << std::endl;
+    // The simulation thread resolves landmarks and events with each key;
+    // all that is left here is noticing that the player wants to leave,
+    // and pacing continuous travel
+    const JourneyView& view = m_sim->getView();
+    m_handledSteps = view.steps;
+    if (view.journey.wantsMenu()) {
+        returnToMenu();
         return;
     }
     
-    SDL_Surface* textSurface = TTF_RenderText_Solid(m_font, text.c_str(), m_textColor);
-    if (!textSurface) {
-        std::cerr << "Unable to render text surface: " << TTF_GetError() << std::endl;
+    // Load what lies ahead before the wagon gets there
+    m_streamer->update(view.journey, m_game->getTravelRate());
+    
+    if (m_spaceHeld && !m_travelling) {
+        m_holdTime += deltaTime;
+        if (m_holdTime >= HOLD_TO_TRAVEL_DELAY) {
+            startTravel();
+        }
+    }
+    if (!m_travelling) {
         return;
     }
     
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(m_game->getRenderer(), textSurface);
-    if (!textTexture) {
-        std::cerr << "Unable to create texture from rendered text: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(textSurface);
+    if (view.haltedTravelRun == m_travelRun) {
+        // Reached something that needs the player; SPACE must be pressed again
+        m_spaceHeld = false;
+        stopTravel();
         return;
     }
     
-    SDL_Rect renderQuad = { x, y, textSurface->w, textSurface->h };
-    SDL_RenderCopy(m_game->getRenderer(), textTexture, nullptr, &renderQuad);
-    
-    SDL_FreeSurface(textSurface);
-    SDL_DestroyTexture(textTexture);
+    // Days are sent by the clock, not per frame, so any rate looks the same
+    // at any frame rate
+    m_travelClock += deltaTime * m_game->getTravelRate();
+    while (m_travelClock >= 1.0f) {
+        if (m_sim->getSubmittedCount() - view.steps >= MAX_TRAVEL_DAYS_AHEAD) {
+            m_travelClock = 1.0f;   // Simulation is behind; wait for it
+            break;
+        }
+        m_sim->submit(SimInput{SDLK_SPACE, m_travelRun});
+        m_travelClock -= 1.0f;
+    }
 }
 
-void TravelState::renderTextCentered(const std::string& text, int y) {
-    if (text.empty()) {
-        return;
+void TravelState::startTravel() {
+    if (++m_travelRun == 0) {
+        m_travelRun = 1;    // 0 means a key the player pressed
     }
-    
-    if (!m_font) {
-        std::cerr << "Cannot render centered text: font not loaded" << std::endl;
+    m_travelling = true;
+    m_travelClock = 1.0f;   // First day right away
+}
+
+void TravelState::stopTravel() {
+    m_travelling = false;
+    m_travelClock = 0.0f;
+}
+
+bool TravelState::isAnimating() const {
+    // Keep running while traveling, and until update() has seen the result
+    // of every key the player pressed (render() draws a view at least as new)
+    return m_sim && (m_travelling || m_spaceHeld || m_handledSteps < m_sim->getSubmittedCount());
+}
+
+void TravelState::simulateInput(const SimInput& input) {
+    if (input.travelRun == 0) {
+        m_statusText.clear();
+        
+        // Saving is not a journey step, so it is not recorded or journaled
+        if (input.key == SAVE_KEY) {
+            saveToSlot();
+            return;
+        }
+        stepJourney(input.key);
         return;
     }
     
-    SDL_Surface* textSurface = TTF_RenderText_Solid(m_font, text.c_str(), m_textColor);
-    if (!textSurface) {
-        std::cerr << "Unable to render text surface: " << TTF_GetError() << std::endl;
+    // A day of continuous travel: only while still on the open trail, and
+    // never past the first day that needs the player's attention
+    if (input.travelRun == m_haltedTravelRun) {
         return;
     }
-    
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(m_game->getRenderer(), textSurface);
-    if (!textTexture) {
-        std::cerr << "Unable to create texture from rendered text: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(textSurface);
+    if (m_journey.getSubState() != TravelSubState::Traveling || m_journey.isGameOver()) {
+        m_haltedTravelRun = input.travelRun;
         return;
     }
-    
-    int x = (m_game->getWindowWidth() - textSurface->w) / 2;
-    SDL_Rect renderQuad = { x, y, textSurface->w, textSurface->h };
-    SDL_RenderCopy(m_game->getRenderer(), textTexture, nullptr, &renderQuad);
-    
-    SDL_FreeSurface(textSurface);
-    SDL_DestroyTexture(textTexture);
+    int aliveBefore = m_journey.getAliveCount();
+    stepJourney(SDLK_SPACE);
+    if (m_journey.getSubState() != TravelSubState::Traveling || m_journey.isGameOver() ||
+        m_journey.getAliveCount() < aliveBefore) {
+        m_haltedTravelRun = input.travelRun;
+    }
 }
 
-// Core gameplay mechanics
-void TravelState::setupInitialJourney() {
-    m_setupStage = 0;
-    m_setupInputs.clear();
-    m_currentInput = "";
-    
-    // Default party setup with placeholder names
-    m_party.clear();
-    m_party.push_back(PartyMember("Player"));
-    m_party.push_back(PartyMember("Companion 1"));
-    m_party.push_back(PartyMember("Companion 2"));
-    m_party.push_back(PartyMember("Companion 3"));
-    m_party.push_back(PartyMember("Companion 4"));
-    
-    // Setup initial resources
-    setupStartingResources();
+void TravelState::stepJourney(SDL_Keycode key) {
+    // Recorded and journaled like any other key, so replays see plain SPACEs
+    m_session.applyKey(key);
+    
+    const std::vector<Grave>& graves = m_session.getPassedGraves();
+    if (!graves.empty()) {
+        m_statusText = "You pass the grave of " + graves[0].name + ": \"" + graves[0].epitaph + "\"";
+        if (graves.size() > 1) {
+            m_statusText += " (and " + std::to_string(graves.size() - 1) + " more)";
+        }
+    }
+    
+    if (m_journey.hasReachedOregon() && !m_scoreRecorded) {
+        recordScore();
+    }
 }
 
-void TravelState::setupStartingResources() {
-    // Start with some supplies
-    if (m_profession == "Banker") {
-        m_resources.money = 1600;
-        m_resources.food = 200;
-        m_resources.ammunition = 100;
-        m_resources.clothing = 3;
-        m_resources.wagonParts = 3;
-        m_resources.medicines = 2;
-    } else if (m_profession == "Carpenter") {
-        m_resources.money = 800;
-        m_resources.food = 180;
-        m_resources.ammunition = 80;
-        m_resources.clothing = 2;
-        m_resources.wagonParts = 2;
-        m_resources.medicines = 1;
-    } else if (m_profession == "Farmer") {
-        m_resources.money = 400;
-        m_resources.food = 160;
-        m_resources.ammunition = 60;
-        m_resources.clothing = 1;
-        m_resources.wagonParts = 1;
-        m_resources.medicines = 1;
-    } else {
-        // Default
-        m_resources.money = 1000;
-        m_resources.food = 180;
-        m_resources.ammunition = 80;
-        m_resources.clothing = 2;
-        m_resources.wagonParts = 2;
-        m_resources.medicines = 1;
-    }
+void TravelState::fillView(JourneyView& view) const {
+    view.journey = m_journey;
+    view.statusText = m_statusText;
+    view.highScoreRank = m_highScoreRank;
+    view.haltedTravelRun = m_haltedTravelRun;
 }
 
-void TravelState::advanceDay() {
-    // Increment day counter
-    m_currentDay++;
-    
-    // Update month/year if necessary
-    if (m_currentDay > 30) { // Simplified month length
-        m_currentDay = 1;
-        m_month++;
-        if (m_month > 12) {
-            m_month = 1;
-            m_year++;
-        }
+void TravelState::render() {
+    if (!m_sim) {
+        return;
     }
+    m_view = &m_sim->getView();
+    const Journey& journey = m_view->journey;
     
-    // Update weather based on month
-    updateWeather();
-    
-    // Consume daily resources
-    consumeResources();
-    
-    // Update health of party members
-    updateHealth();
-    
-    // Travel distance for the day
-    int milesForDay = calculateDailyMiles();
-    m_milesTraveled += milesForDay;
+    // Get renderer
+    SDL_Renderer* renderer = m_game->getRenderer();
     
-    std::cout << "Day " << m_currentDay << " of month " << m_month << ": traveled " 
-              << milesForDay << " miles. Total: " << m_milesTraveled << std::endl;
+    // Clear screen to black
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
     
-    // Check if reached Oregon
-    if (m_milesTraveled >= 2040) {
-        m_reachedOregon = true;
-        m_gameOver = true;
-        m_eventMessage = "Congratulations! You have reached Oregon City!";
-        m_subState = TravelSubState::GameOver;
+    TravelScreen screen;
+    screen.journey = &journey;
+    screen.statusText = m_view->statusText.c_str();
+    if (m_travelling) {
+        screen.travelText = m_game->isTravelToggle() ? "Traveling... press SPACE to stop"
+                                                     : "Traveling... release SPACE to stop";
     }
+    screen.helpText = m_helpText.c_str();
+    screen.highScoreRank = m_view->highScoreRank;
+    screen.width = m_game->getWindowWidth();
+    screen.height = m_game->getWindowHeight();
     
-    // Check if all party members are dead
-    bool anyoneAlive = false;
-    for (const auto& member : m_party) {
-        if (member.isAlive) {
-            anyoneAlive = true;
-            break;
-        }
+    SDL_Rect artRect = {0, 0, 0, 0};
+    SDL_Texture* art = nullptr;
+    if (journey.getSubState() == TravelSubState::Location) {
+        art = findLandmarkArt(journey.getNextLandmarkIndex() - 1, artRect);
+        screen.artHeight = artRect.h;
     }
     
-    if (!anyoneAlive) {
-        m_gameOver = true;
-        m_eventMessage = "Game Over. All members of your party have died.";
-        m_subState = TravelSubState::GameOver;
-    }
+    ScreenText text;
+    buildTravelText(screen, m_game->getFrameArena(), text);
     
-    // Check if out of food
-    if (m_resources.food <= 0) {
-        // Reduce health of party members
-        for (auto& member : m_party) {
-            if (member.isAlive) {
-                member.health -= 15;
-                if (member.health <= 0) {
-                    member.isAlive = false;
-                }
-            }
-        }
+    if (art) {
+        artRect.x = (screen.width - artRect.w) / 2;
+        artRect.y = screen.artY;
+        countDrawCall();
+        SDL_RenderCopy(renderer, art, nullptr, &artRect);
     }
-    
-    // Mark that we need to redraw
-    m_needsUpdate = true;
+    if (screen.targetY > 0) {
+        renderHuntingTarget(screen.targetY);
+    }
+    m_game->getTextCache()->draw(m_font, m_textColor, text, screen.width);
 }
 
-void TravelState::consumeResources() {
-    // Count alive party members
-    int aliveMembers = 0;
-    for (const auto& member : m_party) {
-        if (member.isAlive) {
-            aliveMembers++;
-        }
+SDL_Texture* TravelState::findLandmarkArt(int landmarkIndex, SDL_Rect& size) {
+    // Looked up until found, then kept while its landmark is on screen
+    if (landmarkIndex != m_landmarkArtIndex) {
+        m_landmarkArtIndex = landmarkIndex;
+        m_landmarkArt.reset();
     }
     
-    // Each person consumes 2 pounds of food per day
-    int foodConsumed = aliveMembers * 2;
-    m_resources.food = std::max(0, m_resources.food - foodConsumed);
-    
-    // Clothing deteriorates based on weather
-    if (m_currentWeather == Weather::Rainy || m_currentWeather == Weather::Stormy) {
-        // More wear on clothing in bad weather
-        std::uniform_int_distribution<> dis(1, 100);
-        int roll = dis(m_rng);
-        if (roll <= 10) { // 10% chance of clothing wear in bad weather
-            if (m_resources.clothing > 0) {
-                m_resources.clothing--;
-                std::cout << "Some clothing has worn out due to bad weather." << std::endl;
-            }
+    // Only what the streamer has already loaded; drawing never waits on disk
+    const std::vector<AssetRequest>& requests = m_streamer->getAssets(landmarkIndex);
+    for (auto it = requests.begin(); !m_landmarkArt && it != requests.end(); ++it) {
+        if (it->kind != "image") {
+            continue;
         }
-    }
-    
-    // Wagon parts can break on rough terrain
-    if (m_currentWeather == Weather::Stormy) {
-        std::uniform_int_distribution<> dis(1, 100);
-        int roll = dis(m_rng);
-        if (roll <= 5) { // 5% chance of wagon damage in stormy weather
-            if (m_resources.wagonParts > 0) {
-                m_resources.wagonParts--;
-                std::cout << "A wagon part broke during the storm." << std::endl;
-            } else {
-                // If no spare parts, reduce travel pace
-                std::cout << "Your wagon is damaged and slowing you down." << std::endl;
-            }
+        std::shared_ptr<SDL_Texture> art = m_game->getAssets()->getImage(it->path, false);
+        int width = 0;
+        int height = 0;
+        if (art && SDL_QueryTexture(art.get(), nullptr, nullptr, &width, &height) == 0 &&
+            width > 0 && height > 0) {
+            m_landmarkArt = art;
         }
     }
-}
-
-void TravelState::updateWeather() {
-    Weather baseSeason = getWeatherForMonth(m_month);
-    
-    // Slight randomization of weather
-    std::uniform_int_distribution<> dis(1, 100);
-    int roll = dis(m_rng);
-    
-    if (roll <= 70) {
-        // 70% chance of seasonal weather
-        m_currentWeather = baseSeason;
-    } else if (roll <= 85) {
-        // 15% chance of better weather than expected
-        switch (baseSeason) {
-            case Weather::Snowy:
-                m_currentWeather = Weather::Cloudy;
-                break;
-            case Weather::Rainy:
-                m_currentWeather = Weather::Cloudy;
-                break;
-            case Weather::Stormy:
-                m_currentWeather = Weather::Rainy;
-                break;
-            case Weather::Cloudy:
-                m_currentWeather = Weather::Fair;
-                break;
-            default:
-                m_currentWeather = Weather::Fair;
-                break;
-        }
-    } else {
-        // 15% chance of worse weather than expected
-        switch (baseSeason) {
-            case Weather::Fair:
-                m_currentWeather = Weather::Cloudy;
-                break;
-            case Weather::Cloudy:
-                m_currentWeather = Weather::Rainy;
-                break;
-            case Weather::Rainy:
-                m_currentWeather = Weather::Stormy;
-                break;
-            default:
-                m_currentWeather = Weather::Stormy;
-                break;
-        }
+    if (!m_landmarkArt) {
+        return nullptr;
     }
+    
+    int width = 0;
+    int height = 0;
+    SDL_QueryTexture(m_landmarkArt.get(), nullptr, nullptr, &width, &height);
+    float scale = std::min({1.0f, static_cast<float>(LANDMARK_ART_WIDTH) / width,
+                            static_cast<float>(LANDMARK_ART_HEIGHT) / height});
+    size.w = static_cast<int>(width * scale);
+    size.h = static_cast<int>(height * scale);
+    return m_landmarkArt.get();
 }
 
-Weather TravelState::getWeatherForMonth(int month) {
-    // Simplified seasonal weather patterns
-    switch (month) {
-        case 12:
-        case 1:
-        case 2:
-            return Weather::Snowy; // Winter
-        case 3:
-        case 4:
-        case 5:
-            return Weather::Rainy; // Spring
-        case 6:
-        case 7:
-        case 8:
-            return Weather::Fair; // Summer
-        case 9:
-        case 10:
-        case 11:
-            return Weather::Cloudy; // Fall
-        default:
-            return Weather::Fair;
+void TravelState::renderHuntingTarget(int centerY) {
+    SDL_Renderer* renderer = m_game->getRenderer();
+    int centerX = m_game->getWindowWidth() / 2;
+    
+    SDL_SetRenderDrawColor(renderer, 144, 238, 144, 255); // Light green
+    
+    // Draw concentric circles
+    for (int radius = 50; radius > 10; radius -= 10) {
+        for (int i = 0; i < 360; i++) {
+            double angle = i * M_PI / 180.0;
+            int x = centerX + static_cast<int>(radius * cos(angle));
+            int y = centerY + static_cast<int>(radius * sin(angle));
+            countDrawCall();
+            SDL_RenderDrawPoint(renderer, x, y);
+        }
     }
+    
+    // Draw crosshairs
+    countDrawCall();
+    SDL_RenderDrawLine(renderer, centerX - 60, centerY, centerX + 60, centerY);
+    countDrawCall();
+    SDL_RenderDrawLine(renderer, centerX, centerY - 60, centerX, centerY + 60);
 }
 
-void TravelState::updateHealth() {
-    for (auto& member : m_party) {
-        if (!member.isAlive)
-            continue;
-            
-        // Base health change
-        int healthChange = 0;
-        
-        // Health boost if resting
-        if (m_subState == TravelSubState::Resting) {
-            healthChange += 5;
-        }
-        
-        // Health penalty if no food
-        if (m_resources.food <= 0) {
-            healthChange -= 10;
-        }
-        
-        // Health penalty for bad weather without clothing
-        if ((m_currentWeather == Weather::Rainy || m_currentWeather == Weather::Snowy) && 
-            m_resources.clothing <= 0) {
-            healthChange -= 5;
-        }
-        
-        // Random chance of illness
-        std::uniform_int_distribution<> dis(1, 100);
-        int roll = dis(m_rng);
-        if (roll <= 5) { // 5% chance of illness
-            member.health -= 15;
-            member.ailment = "sick";
-            
-            // Medicine can help
-            if (m_resources.medicines > 0) {
-                m_resources.medicines--;
-                member.health += 10; // Medicine alleviates some health loss
-                member.ailment = "recovering";
-            }
-        }
-        
-        // Apply health change
-        member.health += healthChange;
-        
-        // Cap health at 0-100
-        member.health = std::max(0, std::min(100, member.health));
-        
-        // Check if died
-        if (member.health <= 0) {
-            member.isAlive = false;
-            m_eventMessage = member.name + " has died.";
-            m_subState = TravelSubState::Event;
-        }
-    }
+void TravelState::returnToMenu() {
+    std::cout << "Returning to menu from TravelState" << std::endl;
+    m_game->changeState(MENU_STATE_NAME);
 }
 
-int TravelState::calculateDailyMiles() {
-    // Base travel rate
-    int baseMiles = 10;
-    
-    // Weather modifiers
-    switch (m_currentWeather) {
-        case Weather::Fair:
-            baseMiles += 5;
-            break;
-        case Weather::Cloudy:
-            // No modifier
-            break;
-        case Weather::Rainy:
-            baseMiles -= 3;
-            break;
-        case Weather::Stormy:
-            baseMiles -= 7;
-            break;
-        case Weather::Snowy:
-            baseMiles -= 10;
-            break;
+void TravelState::recordScore() {
+    m_scoreRecorded = true;
+    HighScoreTable* highScores = m_game->getHighScores();
+    if (!highScores) {
+        return;
     }
-    
-    // Wagon damage modifier
-    if (m_resources.wagonParts <= 0) {
-        baseMiles = std::max(1, baseMiles - 5); // Damaged wagon slows travel
+    m_highScoreRank = std::max(0, highScores->submit(makeHighScoreEntry(m_journey)));
+    std::cout << "Final score " << m_journey.getScore().total;
+    if (m_highScoreRank > 0) {
+        std::cout << ", #" << m_highScoreRank << " on the high score table";
     }
-    
-    // Ensure minimum travel rate
-    return std::max(1, baseMiles);
+    std::cout << std::endl;
 }
 
-void TravelState::checkForLandmark() {
-    if (m_nextLandmarkIndex >= static_cast<int>(m_landmarks.size()))
+void TravelState::saveToSlot() {
+    SaveSlots* slots = m_game->getSaveSlots();
+    if (!slots || !slots->isOpen()) {
+        m_statusText = "Saving is not available.";
         return;
-        
-    if (m_milesTraveled >= m_landmarks[m_nextLandmarkIndex].distance) {
-        // Reached a landmark
-        Location landmark = m_landmarks[m_nextLandmarkIndex];
-        m_eventMessage = "You have reached " + landmark.name + "!\n" + landmark.description;
-        
-        // Special handling for river crossings
-        if (landmark.isRiver) {
-            m_subState = TravelSubState::River;
-        } else {
-            m_subState = TravelSubState::Location;
-        }
-        
-        m_nextLandmarkIndex++;
     }
-}
-
-void TravelState::triggerRandomEvent() {
-    std::vector<std::string> events = {
-        "One of your oxen is sick. It needs to rest for a day.",
-        "A wheel on your wagon is damaged. You lose a wagon part.",
-        "Heavy rains have washed out part of the trail ahead.",
-        "You found wild berries and gathered some extra food!",
-        "A friendly Native American group shows you a shortcut.",
-        "Your wagon axle breaks! You must repair it to continue.",
-        "Bandits attack your party! You lose some supplies.",
-        "A friendly settler shares some food with your party.",
-        "A snowstorm forces you to take shelter for a day.",
-        "One of your party members has come down with dysentery."
-    };
-    
-    std::uniform_int_distribution<> dis(0, events.size() - 1);
-    int eventIndex = dis(m_rng);
-    m_currentEvent = "Random Event";
-    m_eventMessage = events[eventIndex];
-    
-    // Handle event effects
-    switch (eventIndex) {
-        case 0: // Sick oxen
-            // Lose a day
-            advanceDay();
-            break;
-            
-        case 1: // Wagon wheel damaged
-            if (m_resources.wagonParts > 0) {
-                m_resources.wagonParts--;
-            } else {
-                // No spare parts slows you down
-                m_eventMessage += " Without spare parts, this will slow your journey.";
-            }
-            break;
-            
-        case 2: // Heavy rains
-            // Will affect travel speed through weather
-            m_currentWeather = Weather::Rainy;
-            break;
-            
-        case 3: // Found wild berries
-            m_resources.food += 20;
-            break;
-            
-        case 4: // Shortcut
-            m_milesTraveled += 20;
-            break;
-            
-        case 5: // Broken axle
-            if (m_resources.wagonParts > 0) {
-                m_resources.wagonParts--;
-                m_eventMessage += " You used a spare part to fix it.";
-            } else {
-                // More serious breakdown
-                m_eventMessage += " Without spare parts, your wagon is severely damaged. This will greatly slow your journey.";
-            }
-            break;
-            
-        case 6: // Bandits attack
-            // Lose some resources
-            m_resources.food = std::max(0, m_resources.food - 30);
-            m_resources.ammunition = std::max(0, m_resources.ammunition - 20);
-            m_resources.money = std::max(0, m_resources.money - 25);
-            break;
-            
-        case 7: // Friendly settler shares food
-            m_resources.food += 30;
-            break;
-            
-        case 8: // Snowstorm
-            // Force rest for a few days
-            m_currentWeather = Weather::Snowy;
-            restForDays(2);
-            break;
-            
-        case 9: // Dysentery
-            {
-                // Random party member gets sick
-                std::vector<size_t> aliveIndices;
-                for (size_t i = 0; i < m_party.size(); i++) {
-                    if (m_party[i].isAlive) {
-                        aliveIndices.push_back(i);
-                    }
-                }
-                
-                if (!aliveIndices.empty()) {
-                    std::uniform_int_distribution<> memberDis(0, aliveIndices.size() - 1);
-                    int victimIndex = aliveIndices[memberDis(m_rng)];
-                    m_party[victimIndex].health -= 25;
-                    m_party[victimIndex].ailment = "dysentery";
-                    m_eventMessage += " " + m_party[victimIndex].name + " has caught it.";
-                    
-                    // Medicine can help
-                    if (m_resources.medicines > 0) {
-                        m_resources.medicines--;
-                        m_party[victimIndex].health += 15;
-                        m_eventMessage += " You used medicine to treat them.";
-                    }
-                    
-                    // Check if died
-                    if (m_party[victimIndex].health <= 0) {
-                        m_party[victimIndex].isAlive = false;
-                        m_eventMessage += " Unfortunately, " + m_party[victimIndex].name + " has died.";
-                    }
-                }
-            }
-            break;
+    if (m_journey.isGameOver()) {
+        m_statusText = "This journey is over.";
+        return;
     }
     
-    // Switch to event state to display the result
-    m_subState = TravelSubState::Event;
-}
-
-void TravelState::handleSetupInput(SDL_Keycode key) {
-    if (key == SDLK_SPACE || key == SDLK_RETURN) {
-        // Complete setup and start journey
-        m_subState = TravelSubState::Traveling;
-    } else if (key == SDLK_ESCAPE) {
-        returnToMenu();
-    }
-}
-
-void TravelState::handleTravelInput(SDL_Keycode key) {
-    switch (key) {
-        case SDLK_SPACE:
-            // Continue on the trail (advance one day)
-            advanceDay();
-            break;
-            
-        case SDLK_1:
-            // Rest
-            m_subState = TravelSubState::Resting;
-            break;
-            
-        case SDLK_2:
-            // Hunt
-            m_subState = TravelSubState::Hunting;
-            break;
-            
-        case SDLK_3:
-            // Trade
-            m_subState = TravelSubState::Trading;
-            break;
-            
-        case SDLK_4:
-            // Check supplies
-            m_eventMessage = "Current Supplies:\n"
-                            "Money: $" + std::to_string(m_resources.money) + "\n"
-                            "Food: " + std::to_string(m_resources.food) + " pounds\n"
-                            "Ammunition: " + std::to_string(m_resources.ammunition) + " bullets\n"
-                            "Clothing: " + std::to_string(m_resources.clothing) + " sets\n"
-                            "Wagon Parts: " + std::to_string(m_resources.wagonParts) + "\n"
-                            "Medicines: " + std::to_string(m_resources.medicines);
-            m_subState = TravelSubState::Event;
-            break;
-            
-        case SDLK_ESCAPE:
-            returnToMenu();
-            break;
-            
-        default:
-            break;
+    if (m_saveSlot < 0) {
+        m_saveSlot = slots->chooseSlot();
     }
-}
-
-void TravelState::restForDays(int days) {
-    for (int i = 0; i < days; i++) {
-        // Rest mode improves health but still consumes resources
-        advanceDay();
+    std::string name = m_journey.getProfession() + " party";
+    if (m_journey.getNextLandmarkIndex() > 0) {
+        name += " past " + m_journey.getCurrentLandmark().name;
     }
     
-    m_eventMessage = "You rested for " + std::to_string(days) + " days. Your party's health has improved.";
-    m_subState = TravelSubState::Event;
+    if (slots->save(m_saveSlot, m_session, name)) {
+        m_statusText = "Saved to slot " + std::to_string(m_saveSlot + 1) + ".";
+    } else {
+        m_statusText = "Save failed.";
+    }
 }
 
-void TravelState::returnToMenu() {
-    std::cout << "Returning to menu from TravelState" << std::endl;
-    auto menuState = std::make_unique<MenuState>(m_game);
-    m_game->changeState(std::move(menuState));
-}
+namespace {
 
-// Rendering methods for different sub-states
-void TravelState::renderSetupScreen() {
+// Text of each sub-state's screen
+void buildSetupText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    const Journey& journey = *screen.journey;
+    const Resources& resources = journey.getResources();
+    const Party& party = journey.getParty();
+    
     int y = 100;
     
-    renderTextCentered("THE OREGON TRAIL", 50);
+    text.addCentered("THE OREGON TRAIL", 50);
     
-    renderTextCentered("You are about to embark on the Oregon Trail as a " + m_profession, y);
+    text.addCentered(frame.format("You are about to embark on the Oregon Trail as a %s",
+                                  journey.getProfession().c_str()), y);
     y += 30;
     
-    renderTextCentered("Your party:", y);
+    text.addCentered("Your party:", y);
     y += 30;
     
-    for (const auto& member : m_party) {
-        renderTextCentered(member.name, y);
+    for (const auto& member : party) {
+        text.addCentered(member.name, y);
         y += 20;
     }
     
     y += 20;
-    renderTextCentered("Your supplies:", y);
+    text.addCentered("Your supplies:", y);
     y += 30;
     
-    renderTextCentered("Money: $" + std::to_string(m_resources.money), y); y += 20;
-    renderTextCentered("Food: " + std::to_string(m_resources.food) + " pounds", y); y += 20;
-    renderTextCentered("Ammunition: " + std::to_string(m_resources.ammunition) + " bullets", y); y += 20;
-    renderTextCentered("Clothing: " + std::to_string(m_resources.clothing) + " sets", y); y += 20;
-    renderTextCentered("Wagon Parts: " + std::to_string(m_resources.wagonParts), y); y += 20;
-    renderTextCentered("Medicines: " + std::to_string(m_resources.medicines), y); y += 30;
+    text.addCentered(frame.format("Money: $%d", resources.money), y); y += 20;
+    text.addCentered(frame.format("Food: %d pounds", resources.food), y); y += 20;
+    text.addCentered(frame.format("Ammunition: %d bullets", resources.ammunition), y); y += 20;
+    text.addCentered(frame.format("Clothing: %d sets", resources.clothing), y); y += 20;
+    text.addCentered(frame.format("Wagon Parts: %d", resources.wagonParts), y); y += 20;
+    text.addCentered(frame.format("Medicines: %d", resources.medicines), y); y += 30;
     
-    renderTextCentered("Press SPACE to begin your journey", y + 20);
-    renderTextCentered("Press ESC to return to menu", y + 40);
+    text.addCentered("Press SPACE to begin your journey", y + 20);
+    text.addCentered("Press ESC to return to menu", y + 40);
 }
 
-void TravelState::renderTravelScreen() {
+void buildTrailText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    const Journey& journey = *screen.journey;
+    const Resources& resources = journey.getResources();
+    const Party& party = journey.getParty();
+    
     int y = 50;
     
     // Title
-    renderTextCentered("OREGON TRAIL - ON THE TRAIL", y);
+    text.addCentered("OREGON TRAIL - ON THE TRAIL", y);
     y += 40;
     
     // Date and weather
-    std::string monthNames[] = {"", "January", "February", "March", "April", "May", "June", 
-                              "July", "August", "September", "October", "November", "December"};
-    std::string weatherNames[] = {"Fair", "Cloudy", "Rainy", "Stormy", "Snowy"};
-    
-    renderText("Date: " + monthNames[m_month] + " " + std::to_string(m_currentDay) + ", " + std::to_string(m_year), 50, y);
+    text.add(frame.format("Date: %s %d, %d", MONTH_NAMES[journey.getMonth()], journey.getCurrentDay(),
+                          journey.getYear()), 50, y);
     y += 20;
     
-    renderText("Weather: " + weatherNames[static_cast<int>(m_currentWeather)], 50, y);
+    text.add(frame.format("Weather: %s", WEATHER_NAMES[static_cast<int>(journey.getWeather())]), 50, y);
     y += 20;
     
-    renderText("Miles Traveled: " + std::to_string(m_milesTraveled), 50, y);
+    text.add(frame.format("Miles Traveled: %d", journey.getMilesTraveled()), 50, y);
     y += 20;
     
     // Next landmark
-    if (m_nextLandmarkIndex < static_cast<int>(m_landmarks.size())) {
-        int milesTo = m_landmarks[m_nextLandmarkIndex].distance - m_milesTraveled;
-        renderText("Next Landmark: " + m_landmarks[m_nextLandmarkIndex].name + 
-                   " (" + std::to_string(milesTo) + " miles)", 50, y);
+    const std::vector<Location>& landmarks = journey.getLandmarks();
+    int nextLandmarkIndex = journey.getNextLandmarkIndex();
+    if (nextLandmarkIndex < static_cast<int>(landmarks.size())) {
+        int milesTo = landmarks[nextLandmarkIndex].distance - journey.getMilesTraveled();
+        text.add(frame.format("Next Landmark: %s (%d miles)", landmarks[nextLandmarkIndex].name.c_str(), milesTo),
+                 50, y);
     } else {
-        renderText("You are nearing your destination!", 50, y);
+        text.add("You are nearing your destination!", 50, y);
     }
     y += 40;
     
     // Party status
-    renderText("Party Status:", 50, y);
+    text.add("Party Status:", 50, y);
     y += 20;
     
-    for (const auto& member : m_party) {
-        std::string status = member.name + ": ";
+    for (const auto& member : party) {
+        const char* status;
         if (!member.isAlive) {
-            status += "Dead";
-        } else if (member.health < 20) {
-            status += "Critical (" + std::to_string(member.health) + "%)";
-        } else if (member.health < 50) {
-            status += "Poor (" + std::to_string(member.health) + "%)";
-        } else if (member.health < 80) {
-            status += "Fair (" + std::to_string(member.health) + "%)";
+            status = frame.format("%s: Dead", member.name);
+        } else if (member.ailment[0] != '\0') {
+            status = frame.format("%s: %s (%d%%) - %s", member.name, healthWord(member.health), member.health,
+                                  member.ailment);
         } else {
-            status += "Good (" + std::to_string(member.health) + "%)";
+            status = frame.format("%s: %s (%d%%)", member.name, healthWord(member.health), member.health);
         }
         
-        if (!member.ailment.empty() && member.isAlive) {
-            status += " - " + member.ailment;
-        }
-        
-        renderText(status, 70, y);
+        text.add(status, 70, y);
         y += 20;
     }
     y += 20;
     
     // Supplies
-    renderText("Supplies:", 50, y);
+    text.add("Supplies:", 50, y);
     y += 20;
     
-    renderText("Food: " + std::to_string(m_resources.food) + " pounds", 70, y); y += 20;
-    renderText("Ammunition: " + std::to_string(m_resources.ammunition) + " bullets", 70, y); y += 20;
-    renderText("Money: $" + std::to_string(m_resources.money), 70, y); y += 20;
-    renderText("Wagon Parts: " + std::to_string(m_resources.wagonParts), 70, y); y += 20;
-    renderText("Clothing: " + std::to_string(m_resources.clothing) + " sets", 70, y); y += 20;
-    renderText("Medicines: " + std::to_string(m_resources.medicines), 70, y);
+    text.add(frame.format("Food: %d pounds", resources.food), 70, y); y += 20;
+    text.add(frame.format("Ammunition: %d bullets", resources.ammunition), 70, y); y += 20;
+    text.add(frame.format("Money: $%d", resources.money), 70, y); y += 20;
+    text.add(frame.format("Wagon Parts: %d", resources.wagonParts), 70, y); y += 20;
+    text.add(frame.format("Clothing: %d sets", resources.clothing), 70, y); y += 20;
+    text.add(frame.format("Medicines: %d", resources.medicines), 70, y);
     
     // Options
-    y = m_game->getWindowHeight() - 100;
-    renderTextCentered("What would you like to do?", y);
+    y = screen.height - 100;
+    text.addCentered("What would you like to do?", y);
     y += 30;
     
-    renderText("SPACE - Continue on trail", 200, y); y += 20;
-    renderText("1 - Stop to rest", 200, y); y += 20;
-    renderText("2 - Hunt for food", 200, y); y += 20;
-    renderText("3 - Trade supplies", 200, y);
+    text.add("SPACE - Continue on trail", 200, y); y += 20;
+    text.add("1 - Stop to rest", 200, y); y += 20;
+    text.add("2 - Hunt for food", 200, y); y += 20;
+    text.add("3 - Trade supplies", 200, y);
 }
 
-void TravelState::renderLocationScreen() {
+void buildLocationText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    const Journey& journey = *screen.journey;
     int y = 50;
     
     // Get current landmark
-    int currentLandmarkIndex = std::max(0, m_nextLandmarkIndex - 1);
-    Location landmark = m_landmarks[currentLandmarkIndex];
+    const Location& landmark = journey.getCurrentLandmark();
     
     // Title
-    renderTextCentered("LANDMARK: " + landmark.name, y);
+    text.addCentered(frame.format("LANDMARK: %s", landmark.name.c_str()), y);
     y += 40;
     
     // Date and miles
-    std::string monthNames[] = {"", "January", "February", "March", "April", "May", "June", 
-                              "July", "August", "September", "October", "November", "December"};
-    
-    renderText("Date: " + monthNames[m_month] + " " + std::to_string(m_currentDay) + ", " + std::to_string(m_year), 50, y);
+    text.add(frame.format("Date: %s %d, %d", MONTH_NAMES[journey.getMonth()], journey.getCurrentDay(),
+                          journey.getYear()), 50, y);
     y += 20;
     
-    renderText("Miles Traveled: " + std::to_string(m_milesTraveled), 50, y);
+    text.add(frame.format("Miles Traveled: %d", journey.getMilesTraveled()), 50, y);
     y += 40;
     
     // Landmark description
-    renderTextCentered(landmark.description, y);
+    text.addCentered(landmark.description.c_str(), y);
     y += 40;
     
+    screen.artY = y;
+    if (screen.artHeight > 0) {
+        y += screen.artHeight + 20;
+    }
+    
     // Options that may be available at landmark
     if (landmark.name.find("Fort") != std::string::npos) {
-        renderTextCentered("This fort offers trading opportunities and a chance to rest.", y);
+        text.addCentered("This fort offers trading opportunities and a chance to rest.", y);
         y += 30;
-        renderText("Press 1 to Trade", 200, y); y += 20;
-        renderText("Press 2 to Rest", 200, y); y += 20;
+        text.add("Press 1 to Trade", 200, y); y += 20;
+        text.add("Press 2 to Rest", 200, y); y += 20;
     }
     
     // Continue journey
-    y = m_game->getWindowHeight() - 100;
-    renderTextCentered("Press SPACE to continue your journey", y);
+    y = screen.height - 100;
+    text.addCentered("Press SPACE to continue your journey", y);
 }
 
-void TravelState::renderRiverScreen() {
+void buildRiverText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    const Journey& journey = *screen.journey;
     int y = 50;
     
     // Get current river
-    int currentLandmarkIndex = std::max(0, m_nextLandmarkIndex - 1);
-    Location river = m_landmarks[currentLandmarkIndex];
+    const Location& river = journey.getCurrentLandmark();
     
     // Title
-    renderTextCentered("RIVER CROSSING: " + river.name, y);
+    text.addCentered(frame.format("RIVER CROSSING: %s", river.name.c_str()), y);
     y += 40;
     
     // River info
-    renderTextCentered(river.description, y);
+    text.addCentered(river.description.c_str(), y);
     y += 30;
     
-    std::string weatherNames[] = {"Fair", "Cloudy", "Rainy", "Stormy", "Snowy"};
-    
-    renderText("Weather: " + weatherNames[static_cast<int>(m_currentWeather)], 50, y);
+    text.add(frame.format("Weather: %s", WEATHER_NAMES[static_cast<int>(journey.getWeather())]), 50, y);
     y += 20;
     
-    std::string depthDescription;
+    const char* depthDescription;
     if (river.riverDepth <= 2) depthDescription = "shallow";
     else if (river.riverDepth <= 4) depthDescription = "moderate";
     else depthDescription = "deep";
     
-    renderText("River depth: " + depthDescription, 50, y);
+    text.add(frame.format("River depth: %s", depthDescription), 50, y);
     y += 40;
     
     // Options
-    renderTextCentered("How will you cross the river?", y);
+    text.addCentered("How will you cross the river?", y);
     y += 30;
     
-    renderText("1 - Attempt to ford the river", 200, y); y += 20;
-    renderText("2 - Caulk the wagon and float across", 200, y); y += 20;
-    renderText("3 - Hire a local guide ($40)", 200, y); y += 20;
-    renderText("4 - Wait for conditions to improve", 200, y);
+    text.add("1 - Attempt to ford the river", 200, y); y += 20;
+    text.add("2 - Caulk the wagon and float across", 200, y); y += 20;
+    text.add("3 - Hire a local guide ($40)", 200, y); y += 20;
+    text.add("4 - Wait for conditions to improve", 200, y);
     
     // Risk levels
-    y = m_game->getWindowHeight() - 120;
-    if (m_currentWeather == Weather::Rainy || m_currentWeather == Weather::Stormy) {
-        renderTextCentered("WARNING: The river is running high due to recent rains.", y);
+    y = screen.height - 120;
+    if (journey.getWeather() == Weather::Rainy || journey.getWeather() == Weather::Stormy) {
+        text.addCentered("WARNING: The river is running high due to recent rains.", y);
     } else if (river.riverDepth >= 5) {
-        renderTextCentered("WARNING: This river is very deep and dangerous.", y);
+        text.addCentered("WARNING: This river is very deep and dangerous.", y);
     }
     y += 30;
     
-    renderTextCentered("Your decision may risk lives and supplies.", y);
+    text.addCentered("Your decision may risk lives and supplies.", y);
 }
 
-void TravelState::renderHuntingScreen() {
+void buildHuntingText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    const Journey& journey = *screen.journey;
+    const Resources& resources = journey.getResources();
+    
     int y = 50;
     
     // Title
-    renderTextCentered("HUNTING", y);
+    text.addCentered("HUNTING", y);
     y += 40;
     
     // Hunting info
-    renderTextCentered("You're hunting for food to feed your party.", y);
+    text.addCentered("You're hunting for food to feed your party.", y);
     y += 30;
     
-    renderText("Ammunition: " + std::to_string(m_resources.ammunition) + " bullets", 50, y);
+    text.add(frame.format("Ammunition: %d bullets", resources.ammunition), 50, y);
     y += 40;
     
-    if (m_resources.ammunition <= 0) {
-        renderTextCentered("You don't have any ammunition for hunting!", y);
+    if (resources.ammunition <= 0) {
+        text.addCentered("You don't have any ammunition for hunting!", y);
         y += 30;
-        renderTextCentered("Press ESC to return to travel", y);
+        text.addCentered("Press ESC to return to travel", y);
     } else {
-        renderTextCentered("Press SPACE to fire your rifle", y);
+        text.addCentered("Press SPACE to fire your rifle", y);
         y += 30;
-        renderTextCentered("Each shot uses 1 bullet", y);
+        text.addCentered("Each shot uses 1 bullet", y);
         y += 30;
-        renderTextCentered("Press ESC to cancel hunting and return to travel", y);
-        
-        // Draw a simple target
-        SDL_Renderer* renderer = m_game->getRenderer();
-        int centerX = m_game->getWindowWidth() / 2;
-        int centerY = y + 80;
-        
-        SDL_SetRenderDrawColor(renderer, 144, 238, 144, 255); // Light green
-        
-        // Draw concentric circles
-        for (int radius = 50; radius > 10; radius -= 10) {
-            for (int i = 0; i < 360; i++) {
-                double angle = i * M_PI / 180.0;
-                int x = centerX + static_cast<int>(radius * cos(angle));
-                int y = centerY + static_cast<int>(radius * sin(angle));
-                SDL_RenderDrawPoint(renderer, x, y);
-            }
-        }
+        text.addCentered("Press ESC to cancel hunting and return to travel", y);
         
-        // Draw crosshairs
-        SDL_RenderDrawLine(renderer, centerX - 60, centerY, centerX + 60, centerY);
-        SDL_RenderDrawLine(renderer, centerX, centerY - 60, centerX, centerY + 60);
+        screen.targetY = y + 80;
     }
 }
 
-void TravelState::renderTradingScreen() {
+void buildTradingText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    const Journey& journey = *screen.journey;
+    const Resources& resources = journey.getResources();
+    
     int y = 50;
     
     // Title
-    renderTextCentered("TRADING POST", y);
+    text.addCentered("TRADING POST", y);
     y += 40;
     
     // Trading info
-    renderTextCentered("You can trade for supplies here.", y);
+    text.addCentered("You can trade for supplies here.", y);
     y += 30;
     
-    renderText("Money: $" + std::to_string(m_resources.money), 50, y);
+    text.add(frame.format("Money: $%d", resources.money), 50, y);
     y += 40;
     
     // Items for sale
-    renderTextCentered("Items for Sale:", y);
+    text.addCentered("Items for Sale:", y);
     y += 30;
     
-    renderText("1 - Food (50 pounds) - $20", 200, y); y += 20;
-    renderText("2 - Ammunition (20 bullets) - $10", 200, y); y += 20;
-    renderText("3 - Clothing (1 set) - $15", 200, y); y += 20;
-    renderText("4 - Wagon Parts (1) - $35", 200, y); y += 20;
-    renderText("5 - Medicine (1) - $25", 200, y); y += 20;
+    text.add("1 - Food (50 pounds) - $20", 200, y); y += 20;
+    text.add("2 - Ammunition (20 bullets) - $10", 200, y); y += 20;
+    text.add("3 - Clothing (1 set) - $15", 200, y); y += 20;
+    text.add("4 - Wagon Parts (1) - $35", 200, y); y += 20;
+    text.add("5 - Medicine (1) - $25", 200, y); y += 20;
     
     // Current supplies
     y += 20;
-    renderTextCentered("Current Supplies:", y);
+    text.addCentered("Current Supplies:", y);
     y += 30;
     
-    renderText("Food: " + std::to_string(m_resources.food) + " pounds", 200, y); y += 20;
-    renderText("Ammunition: " + std::to_string(m_resources.ammunition) + " bullets", 200, y); y += 20;
-    renderText("Clothing: " + std::to_string(m_resources.clothing) + " sets", 200, y); y += 20;
-    renderText("Wagon Parts: " + std::to_string(m_resources.wagonParts), 200, y); y += 20;
-    renderText("Medicines: " + std::to_string(m_resources.medicines), 200, y);
+    text.add(frame.format("Food: %d pounds", resources.food), 200, y); y += 20;
+    text.add(frame.format("Ammunition: %d bullets", resources.ammunition), 200, y); y += 20;
+    text.add(frame.format("Clothing: %d sets", resources.clothing), 200, y); y += 20;
+    text.add(frame.format("Wagon Parts: %d", resources.wagonParts), 200, y); y += 20;
+    text.add(frame.format("Medicines: %d", resources.medicines), 200, y);
     
     // Exit
-    y = m_game->getWindowHeight() - 70;
-    renderTextCentered("Press ESC to exit trading", y);
+    y = screen.height - 70;
+    text.addCentered("Press ESC to exit trading", y);
 }
 
-void TravelState::renderEventScreen() {
+void buildEventText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    const Journey& journey = *screen.journey;
     int y = 100;
     
     // Title - event type
-    renderTextCentered(m_currentEvent.empty() ? "EVENT" : m_currentEvent, y);
+    text.addCentered(journey.getCurrentEvent()[0] == '\0' ? "EVENT" : journey.getCurrentEvent(), y);
     y += 40;
     
     // Break message into lines for better readability
-    std::istringstream stream(m_eventMessage);
-    std::string line;
-    while (std::getline(stream, line)) {
-        renderTextCentered(line, y);
+    const std::string& message = journey.getEventMessage();
+    for (size_t start = 0; start < message.size();) {
+        size_t end = message.find('\n', start);
+        if (end == std::string::npos) {
+            end = message.size();
+        }
+        text.addCentered(frame.copy(message.data() + start, end - start), y);
         y += 25;
+        start = end + 1;
     }
     
     // Exit
-    y = m_game->getWindowHeight() - 70;
-    renderTextCentered("Press SPACE to continue", y);
+    y = screen.height - 70;
+    text.addCentered("Press SPACE to continue", y);
 }
 
-void TravelState::renderRestingScreen() {
+void buildRestingText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    const Journey& journey = *screen.journey;
+    const Resources& resources = journey.getResources();
+    const Party& party = journey.getParty();
+    
     int y = 50;
     
     // Title
-    renderTextCentered("REST", y);
+    text.addCentered("REST", y);
     y += 40;
     
     // Resting info
-    renderTextCentered("Resting will improve your party's health but consume supplies.", y);
+    text.addCentered("Resting will improve your party's health but consume supplies.", y);
     y += 30;
     
     // Party health info
-    renderTextCentered("Party Health:", y);
+    text.addCentered("Party Health:", y);
     y += 30;
     
-    for (const auto& member : m_party) {
+    for (const auto& member : party) {
         if (member.isAlive) {
-            std::string status = member.name + ": ";
-            
-            if (member.health < 20) {
-                status += "Critical (" + std::to_string(member.health) + "%)";
-            } else if (member.health < 50) {
-                status += "Poor (" + std::to_string(member.health) + "%)";
-            } else if (member.health < 80) {
-                status += "Fair (" + std::to_string(member.health) + "%)";
+            const char* status;
+            if (member.ailment[0] != '\0') {
+                status = frame.format("%s: %s (%d%%) - %s", member.name, healthWord(member.health),
+                                      member.health, member.ailment);
             } else {
-                status += "Good (" + std::to_string(member.health) + "%)";
-            }
-            
-            if (!member.ailment.empty()) {
-                status += " - " + member.ailment;
+                status = frame.format("%s: %s (%d%%)", member.name, healthWord(member.health), member.health);
             }
             
-            renderTextCentered(status, y);
+            text.addCentered(status, y);
             y += 20;
         }
     }
@@ -1323,78 +787,69 @@ void TravelState::renderRestingScreen() {
     y += 30;
     
     // Rest options
-    renderTextCentered("How long would you like to rest?", y);
+    text.addCentered("How long would you like to rest?", y);
     y += 30;
     
-    renderText("1 - Rest for 1 day", 200, y); y += 20;
-    renderText("2 - Rest for 3 days", 200, y); y += 20;
-    renderText("3 - Rest for a week (7 days)", 200, y); y += 20;
-    renderText("ESC - Cancel resting", 200, y);
+    text.add("1 - Rest for 1 day", 200, y); y += 20;
+    text.add("2 - Rest for 3 days", 200, y); y += 20;
+    text.add("3 - Rest for a week (7 days)", 200, y); y += 20;
+    text.add("ESC - Cancel resting", 200, y);
     
     // Warning for long rests
-    if (m_resources.food < 50) {
+    if (resources.food < 50) {
         y += 40;
-        renderTextCentered("WARNING: You have limited food supplies!", y);
+        text.addCentered("WARNING: You have limited food supplies!", y);
     }
 }
 
-void TravelState::renderGameOverScreen() {
+void buildGameOverText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    const Journey& journey = *screen.journey;
+    const Resources& resources = journey.getResources();
+    const Party& party = journey.getParty();
+    
     int y = 100;
     
-    if (m_reachedOregon) {
+    if (journey.hasReachedOregon()) {
         // Victory screen
-        renderTextCentered("CONGRATULATIONS!", y);
+        text.addCentered("CONGRATULATIONS!", y);
         y += 40;
         
-        renderTextCentered("You have successfully completed the Oregon Trail!", y);
+        text.addCentered("You have successfully completed the Oregon Trail!", y);
         y += 30;
         
-        // Calculate final score
-        int partyScore = 0;
-        int aliveCount = 0;
-        for (const auto& member : m_party) {
-            if (member.isAlive) {
-                aliveCount++;
-                partyScore += member.health;
-            }
-        }
-        
-        int resourceScore = m_resources.food / 5 + m_resources.money / 5 + 
-                           m_resources.ammunition / 10 + 
-                           m_resources.clothing * 10 + 
-                           m_resources.wagonParts * 15 + 
-                           m_resources.medicines * 20;
-        
-        // Final score calculation
-        int professionMultiplier = 1;
-        if (m_profession == "Farmer") {
-            professionMultiplier = 3;  // Harder start, better score
-        } else if (m_profession == "Carpenter") {
-            professionMultiplier = 2;  // Medium difficulty
-        }
-        
-        int totalScore = (partyScore + resourceScore) * professionMultiplier;
+        // Final score
+        JourneyScore score = journey.getScore();
+        int aliveCount = journey.getAliveCount();
         
         // Display party status
-        renderTextCentered("Party Members Who Survived: " + std::to_string(aliveCount) + 
-                           " out of " + std::to_string(m_party.size()), y);
+        text.addCentered(frame.format("Party Members Who Survived: %d out of %zu", aliveCount, party.size()), y);
         y += 30;
         
         // Display resources
-        renderTextCentered("Remaining Resources:", y);
+        text.addCentered("Remaining Resources:", y);
         y += 30;
         
-        renderText("Food: " + std::to_string(m_resources.food) + " pounds", 200, y); y += 20;
-        renderText("Money: $" + std::to_string(m_resources.money), 200, y); y += 20;
-        renderText("Other supplies value: " + std::to_string(resourceScore - m_resources.food/5 - m_resources.money/5), 200, y);
+        text.add(frame.format("Food: %d pounds", resources.food), 200, y); y += 20;
+        text.add(frame.format("Money: $%d", resources.money), 200, y); y += 20;
+        text.add(frame.format("Other supplies value: %d",
+                              score.resourceScore - resources.food/5 - resources.money/5), 200, y);
+        y += 20;
+        text.add(frame.format("Days on the trail: %d (time bonus %d)", journey.getDaysElapsed(), score.timeBonus),
+                 200, y);
         y += 30;
         
         // Display score
-        renderTextCentered("Your final score: " + std::to_string(totalScore), y);
+        int totalScore = score.total;
+        text.addCentered(frame.format("Your final score: %d", totalScore), y);
         y += 30;
         
+        if (screen.highScoreRank > 0) {
+            text.addCentered(frame.format("New high score! You placed #%d", screen.highScoreRank), y);
+            y += 30;
+        }
+        
         // Rating based on score
-        std::string rating;
+        const char* rating;
         if (totalScore > 1000) {
             rating = "Trail Guide - Outstanding!";
         } else if (totalScore > 750) {
@@ -1407,24 +862,75 @@ void TravelState::renderGameOverScreen() {
             rating = "Surviving Pioneer - At least you're alive!";
         }
         
-        renderTextCentered("Rating: " + rating, y);
+        text.addCentered(frame.format("Rating: %s", rating), y);
     } else {
         // Game over screen
-        renderTextCentered("GAME OVER", y);
+        text.addCentered("GAME OVER", y);
         y += 40;
         
-        renderTextCentered(m_eventMessage, y);
+        text.addCentered(journey.getEventMessage().c_str(), y);
         y += 40;
         
         // Calculate how far they got
-        double percentComplete = static_cast<double>(m_milesTraveled) / 2040.0 * 100.0;
-        renderTextCentered("You traveled " + std::to_string(m_milesTraveled) + " miles.", y);
+        double percentComplete = static_cast<double>(journey.getMilesTraveled()) /
+                                 std::max(1, journey.getTrail().getTotalDistance()) * 100.0;
+        text.addCentered(frame.format("You traveled %d miles.", journey.getMilesTraveled()), y);
         y += 30;
-        renderTextCentered("Journey completion: " + 
-                           std::to_string(static_cast<int>(percentComplete)) + "%", y);
+        text.addCentered(frame.format("Journey completion: %d%%", static_cast<int>(percentComplete)), y);
     }
     
     // Button to return to main menu
-    y = m_game->getWindowHeight() - 100;
-    renderTextCentered("Press SPACE or ESC to return to the main menu", y);
+    y = screen.height - 100;
+    text.addCentered("Press SPACE or ESC to return to the main menu", y);
+}
+
+} // namespace
+
+void buildTravelText(TravelScreen& screen, FrameArena& frame, ScreenText& text) {
+    switch (screen.journey->getSubState()) {
+        case TravelSubState::Setup:
+            buildSetupText(screen, frame, text);
+            break;
+            
+        case TravelSubState::Traveling:
+            buildTrailText(screen, frame, text);
+            break;
+            
+        case TravelSubState::Location:
+            buildLocationText(screen, frame, text);
+            break;
+            
+        case TravelSubState::River:
+            buildRiverText(screen, frame, text);
+            break;
+            
+        case TravelSubState::Hunting:
+            buildHuntingText(screen, frame, text);
+            break;
+            
+        case TravelSubState::Trading:
+            buildTradingText(screen, frame, text);
+            break;
+            
+        case TravelSubState::Event:
+            buildEventText(screen, frame, text);
+            break;
+            
+        case TravelSubState::Resting:
+            buildRestingText(screen, frame, text);
+            break;
+            
+        case TravelSubState::GameOver:
+            buildGameOverText(screen, frame, text);
+            break;
+    }
+    
+    if (screen.statusText[0] != '\0') {
+        text.addCentered(screen.statusText, screen.height - 55);
+    } else {
+        text.addCentered(screen.travelText, screen.height - 55);
+    }
+    
+    // Always help text at bottom
+    text.addCentered(screen.helpText, screen.height - 30);
 }
@@ -1,239 +1,48 @@
 #ifndef TRAVEL_STATE_HPP
 #define TRAVEL_STATE_HPP
 
+#include "asset_streamer.hpp"
 #include "game_state.hpp"
+#include "journey_session.hpp"
+#include "screen_text.hpp"
+#include "sim_thread.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <string>
 #include <vector>
-#include <random>
 #include <memory>
 
+class FrameArena;
 class Game;
 
 // Forward declarations
 class MenuState;
 
-// Represents a party member on the journey
-struct PartyMember {
-    std::string name;
-    int health = 100;       // 0-100 where 100 is perfect health
-    bool isAlive = true;
-    std::string ailment = "";
-    
-    PartyMember(const std::string& name) : name(name) {}
-};
-
-// Represents the player's resources
-struct Resources {
-    int money = 0;          // Cash on hand
-    int food = 0;           // Pounds of food
-    int ammunition = 0;     // Bullets for hunting
-    int clothing = 0;       // Sets of clothing
-    int wagonParts = 0;     // Spare parts for the wagon
-    int medicines = 0;      // Medical supplies
-
-    Resources(int startingMoney = 1600) : money(startingMoney) {}
-};
-
-// Weather conditions
-enum class Weather {
-    Fair,
-    Cloudy,
-    Rainy,
-    Stormy,
-    Snowy
-};
-
-// Represents a location on the trail
-struct Location {
-    std::string name;
-    int distance;       // Miles from start
-    std::string description;
-    bool isLandmark;
-    bool isRiver;
-    int riverDepth;     // If isRiver is true
-
-    Location(const std::string& name, int distance, const std::string& description, 
-             bool isLandmark = false, bool isRiver = false, int riverDepth = 0)
-        : name(name), distance(distance), description(description), 
-          isLandmark(isLandmark), isRiver(isRiver), riverDepth(riverDepth) {}
-};
-
-class TravelState : public GameState {
-public:
-    TravelState(Game* game, const std::string& profession = "Banker");
-    virtual ~TravelState();
-    
-    // GameState interface implementation
-    virtual void enter() override;
-    virtual void exit() override;
-    virtual void handleEvent(const SDL_Event& event) override;
-    virtual void update(float deltaTime) override;
-    virtual void render() override;
-    virtual std::string getName() const override { return "TravelState"; }
-    
-private:
-    // States within the travel state
-    enum class TravelSubState {
-        Setup,          // Initial setup (naming party, etc)
-        Traveling,      // Normal traveling
-        Location,       // At a landmark or fort
-        River,          // At a river crossing
-        Hunting,        // In hunting mini-game
-        Trading,        // Trading with others
-        Event,          // Random event occurring
-        Resting,        // Resting to recover health
-        GameOver        // End of game (death or reached Oregon)
-    };
-    
-    // Helper methods
-    void renderText(const std::string& text, int x, int y);
-    void renderTextCentered(const std::string& text, int y);
-    
-    // Game mechanics
-    void advanceDay();
-    void consumeResources();
-    void updateWeather();
-    Weather getWeatherForMonth(int month);
-    void updateHealth();
-    int calculateDailyMiles();
-    void checkForLandmark();
-    void checkForRivers();
-    void triggerRandomEvent();
-    void handleRiverCrossing();
-    void startHunting();
-    void handleTrading();
-    void restForDays(int days);
-    void setupInitialJourney();
-    void returnToMenu();
-    
-    // User interface methods
-    void renderTravelScreen();
-    void renderSetupScreen();
-    void renderLocationScreen();
-    void renderRiverScreen();
-    void renderHuntingScreen();
-    void renderTradingScreen();
-    void renderEventScreen();
-    void renderRestingScreen();
-    void renderGameOverScreen();
-    void handleTravelInput(SDL_Keycode key);
-    void handleSetupInput(SDL_Keycode key);
-    
-    // Random event generation
-    void generateRandomEvents();
-    std::string getRandomEvent();
-    
-    // Resource management
-    void setupStartingResources();
-    
-    // Member variables
-    std::string m_profession;
-    std::vector<PartyMember> m_party;
-    Resources m_resources;
-    
-    int m_currentDay = 1;          // Game starts on day 1
-    int m_month = 3;               // Start in March
-    int m_year = 1848;
-    int m_milesTraveled = 0;
-    int m_nextLandmarkIndex = 0;
-    std::vector<Location> m_landmarks;
-    Weather m_currentWeather = Weather::Fair;
-    TravelSubState m_subState = TravelSubState::Setup;
-    
-    // For random events
-    std::mt19937 m_rng;
-    
-    // For event handling
-    std::string m_currentEvent;
-    std::string m_eventMessage;
-    
-    // For UI
-    TTF_Font* m_font = nullptr;
-    SDL_Color m_textColor = {144, 238, 144, 255}; // Light green
-    
-    // Navigation help
-    std::string m_helpText;
-    
-    // Setup state
-    int m_setupStage = 0;
-    std::vector<std::string> m_setupInputs;
-    std::string m_currentInput;
-    
-    // Flags
-    bool m_needsUpdate = true;
-    bool m_gameOver = false;
-    bool m_reachedOregon = false;
+// What a travel screen shows besides the journey, for buildTravelText()
+struct TravelScreen {
+    const Journey* journey = nullptr;
+    const char* statusText = "";    // Shown until the next key
+    const char* travelText = "";    // While the wagon travels on its own
+    const char* helpText = "";
+    int highScoreRank = 0;          // Place on the high-score table, 0 if none
+    int artHeight = 0;              // Landmark art on the landmark screen, 0 if none
+    int width = 0;                  // Of the window
+    int height = 0;
+    
+    // Set by buildTravelText(): where the pictures go
+    int artY = 0;                   // Top of the landmark art
+    int targetY = 0;                // Center of the hunting target, 0 if none
 };
 
-#endif // TRAVEL_STATE_HPP
-
-#ifndef TRAVEL_STATE_HPP
-#define TRAVEL_STATE_HPP
-
-#include "game_state.hpp"
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <string>
-#include <vector>
-#include <random>
-#include <memory>
-
-class Game;
-
-// Forward declarations
-class MenuState;
-
-// Represents a party member on the journey
-struct PartyMember {
-    std::string name;
-    int health = 100;       // 0-100 where 100 is perfect health
-    bool isAlive = true;
-    std::string ailment = "";
-    
-    PartyMember(const std::string& name) : name(name) {}
-};
-
-// Represents the player's resources
-struct Resources {
-    int money = 0;          // Cash on hand
-    int food = 0;           // Pounds of food
-    int ammunition = 0;     // Bullets for hunting
-    int clothing = 0;       // Sets of clothing
-    int wagonParts = 0;     // Spare parts for the wagon
-    int medicines = 0;      // Medical supplies
-
-    Resources(int startingMoney = 1600) : money(startingMoney) {}
-};
-
-// Weather conditions
-enum class Weather {
-    Fair,
-    Cloudy,
-    Rainy,
-    Stormy,
-    Snowy
-};
-
-// Represents a location on the trail
-struct Location {
-    std::string name;
-    int distance;       // Miles from start
-    std::string description;
-    bool isLandmark;
-    bool isRiver;
-    int riverDepth;     // If isRiver is true
-
-    Location(const std::string& name, int distance, const std::string& description, 
-             bool isLandmark = false, bool isRiver = false, int riverDepth = 0)
-        : name(name), distance(distance), description(description), 
-          isLandmark(isLandmark), isRiver(isRiver), riverDepth(riverDepth) {}
-};
+// The text of the journey's current sub-state screen for one frame
+void buildTravelText(TravelScreen& screen, FrameArena& frame, ScreenText& text);
 
 class TravelState : public GameState {
 public:
     TravelState(Game* game, const std::string& profession = "Banker");
+    // Continue a journey already in progress (a recovered autosave, or a
+    // save slot that further saves go back to)
+    TravelState(Game* game, JourneySession session, int saveSlot = -1);
     virtual ~TravelState();
     
     // GameState interface implementation
@@ -242,101 +51,60 @@ public:
     virtual void handleEvent(const SDL_Event& event) override;
     virtual void update(float deltaTime) override;
     virtual void render() override;
+    virtual bool isAnimating() const override;
     virtual std::string getName() const override { return "TravelState"; }
     
 private:
-    // States within the travel state
-    enum class TravelSubState {
-        Setup,          // Initial setup (naming party, etc)
-        Traveling,      // Normal traveling
-        Location,       // At a landmark or fort
-        River,          // At a river crossing
-        Hunting,        // In hunting mini-game
-        Trading,        // Trading with others
-        Event,          // Random event occurring
-        Resting,        // Resting to recover health
-        GameOver        // End of game (death or reached Oregon)
-    };
-    
     // Helper methods
-    void renderText(const std::string& text, int x, int y);
-    void renderTextCentered(const std::string& text, int y);
-    
-    // Game mechanics
-    void advanceDay();
-    void consumeResources();
-    void updateWeather();
-    Weather getWeatherForMonth(int month);
-    void updateHealth();
-    int calculateDailyMiles();
-    void checkForLandmark();
-    void checkForRivers();
-    void triggerRandomEvent();
-    void handleRiverCrossing();
-    void startHunting();
-    void handleTrading();
-    void restForDays(int days);
-    void setupInitialJourney();
+    SDL_Texture* findLandmarkArt(int landmarkIndex, SDL_Rect& size);
+    void renderHuntingTarget(int centerY);
     void returnToMenu();
-    
-    // User interface methods
-    void renderTravelScreen();
-    void renderSetupScreen();
-    void renderLocationScreen();
-    void renderRiverScreen();
-    void renderHuntingScreen();
-    void renderTradingScreen();
-    void renderEventScreen();
-    void renderRestingScreen();
-    void renderGameOverScreen();
-    void handleTravelInput(SDL_Keycode key);
-    void handleSetupInput(SDL_Keycode key);
-    
-    // Random event generation
-    void generateRandomEvents();
-    std::string getRandomEvent();
-    
-    // Resource management
-    void setupStartingResources();
-    
-    // Member variables
-    std::string m_profession;
-    std::vector<PartyMember> m_party;
-    Resources m_resources;
-    
-    int m_currentDay = 1;          // Game starts on day 1
-    int m_month = 3;               // Start in March
-    int m_year = 1848;
-    int m_milesTraveled = 0;
-    int m_nextLandmarkIndex = 0;
-    std::vector<Location> m_landmarks;
-    Weather m_currentWeather = Weather::Fair;
-    TravelSubState m_subState = TravelSubState::Setup;
-    
-    // For random events
-    std::mt19937 m_rng;
-    
-    // For event handling
-    std::string m_currentEvent;
-    std::string m_eventMessage;
+    void recordScore();
+    void saveToSlot();
+    void setupHelpText();
+    void startTravel();
+    void stopTravel();
+    
+    // Simulation thread side
+    void simulateInput(const SimInput& input);
+    void stepJourney(SDL_Keycode key);
+    void fillView(JourneyView& view) const;
+    
+    // Member variables. The session and everything up to m_statusText
+    // belong to the simulation thread while it runs; rendering reads only
+    // the view it publishes.
+    JourneySession m_session;
+    Journey& m_journey;             // m_session's journey
+    bool m_needsSetup = true;       // New journey, not yet set up
+    bool m_scoreRecorded = false;
+    int m_highScoreRank = 0;        // Place on the high-score table, 0 if none
+    int m_saveSlot = -1;            // Slot this journey saves to, once chosen
+    std::string m_statusText;       // Shown until the next key
+    uint32_t m_haltedTravelRun = 0; // Continuous travel run stopped by the journey
     
     // For UI
-    TTF_Font* m_font = nullptr;
+    std::shared_ptr<TTF_Font> m_font;
     SDL_Color m_textColor = {144, 238, 144, 255}; // Light green
     
     // Navigation help
     std::string m_helpText;
     
-    // Setup state
-    int m_setupStage = 0;
-    std::vector<std::string> m_setupInputs;
-    std::string m_currentInput;
-    
-    // Flags
-    bool m_needsUpdate = true;
-    bool m_gameOver = false;
-    bool m_reachedOregon = false;
+    // Art and audio of the landmarks around the wagon, loaded ahead of it
+    std::unique_ptr<AssetStreamer> m_streamer;
+    std::shared_ptr<SDL_Texture> m_landmarkArt;     // Found for m_landmarkArtIndex
+    int m_landmarkArtIndex = -1;
+    
+    // Latest view from the simulation thread, between enter() and exit()
+    std::unique_ptr<SimulationThread> m_sim;
+    const JourneyView* m_view = nullptr;    // Set at the start of each render()
+    uint64_t m_handledSteps = 0;            // Keys included in the last view update() saw
+    
+    // Continuous travel (render thread)
+    bool m_spaceHeld = false;
+    float m_holdTime = 0.0f;                // Seconds SPACE has been down
+    bool m_travelling = false;
+    uint32_t m_travelRun = 0;               // Number of the current or last run
+    float m_travelClock = 0.0f;             // Days due to be sent
 };
 
 #endif // TRAVEL_STATE_HPP
-
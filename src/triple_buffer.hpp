@@ -0,0 +1,51 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <atomic>
+
+// Lock-free hand-off of the latest value from one writer thread to one
+// reader thread. The writer fills a back slot and publishes it; the reader
+// takes whatever was published last. Neither side ever waits for the
+// other, and a slow reader simply skips values it was too late to see.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side: the slot to fill next. It may hold an older value.
+    T& getBackBuffer() { return m_slots[m_back].value; }
+
+    // Writer side: make the back slot the newest value
+    void publish() {
+        int previous = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    // Reader side: the newest published value. It stays put until the
+    // next call, however many times the writer publishes meanwhile.
+    const T& acquire() {
+        if (m_middle.load(std::memory_order_relaxed) & FRESH) {
+            int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & INDEX_MASK;
+        }
+        return m_slots[m_front].value;
+    }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;             // Middle slot not yet acquired
+
+    // Own cache lines, so the two threads never write the same one
+    struct alignas(64) Slot {
+        T value;
+    };
+
+    Slot m_slots[3];
+    alignas(64) std::atomic<int> m_middle{1};
+    alignas(64) int m_back = 2;             // Writer only
+    alignas(64) int m_front = 0;            // Reader only
+};
+
+#endif // TRIPLE_BUFFER_HPP
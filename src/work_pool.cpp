@@ -0,0 +1,131 @@
+#include "work_pool.hpp"
+#include "batch.hpp"
+
+namespace {
+
+thread_local int t_workerIndex = -1;
+thread_local const void* t_workerPool = nullptr;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    unsigned count = resolveThreadCount(threads);
+    for (unsigned i = 0; i < count; ++i) {
+        m_queues.emplace_back(new WorkerQueue());
+    }
+    for (unsigned i = 0; i < count; ++i) {
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+int WorkStealingPool::currentWorker() {
+    return t_workerIndex;
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    unsigned index;
+    if (t_workerPool == this) {
+        index = static_cast<unsigned>(t_workerIndex);
+    } else {
+        index = m_nextQueue.fetch_add(1) % getWorkerCount();
+    }
+
+    m_unfinished++;
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+        m_queued++;
+    }
+
+    // Taking the lock orders this wake-up after a sleeper's check
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    m_allDone.wait(lock, [this] { return m_unfinished.load() == 0; });
+}
+
+bool WorkStealingPool::popLocal(unsigned index, std::function<void()>& task) {
+    WorkerQueue& queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    // Newest first: its data is most likely still in this core's cache
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief, std::function<void()>& task) {
+    unsigned count = getWorkerCount();
+    for (unsigned offset = 1; offset < count; ++offset) {
+        WorkerQueue& queue = *m_queues[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            // Oldest first: usually the biggest remaining piece of work
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::runPendingTask() {
+    std::function<void()> task;
+    bool found;
+    if (t_workerPool == this) {
+        unsigned index = static_cast<unsigned>(t_workerIndex);
+        found = popLocal(index, task) || steal(index, task);
+    } else {
+        // steal() skips the thief's own deque, so try that one first
+        unsigned index = m_nextQueue.load() % getWorkerCount();
+        found = popLocal(index, task) || steal(index, task);
+    }
+    if (found) {
+        runTask(task);
+    }
+    return found;
+}
+
+void WorkStealingPool::runTask(std::function<void()>& task) {
+    m_queued--;
+    task();
+    if (--m_unfinished == 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_allDone.notify_all();
+    }
+}
+
+void WorkStealingPool::workerLoop(unsigned index) {
+    t_workerIndex = static_cast<int>(index);
+    t_workerPool = this;
+
+    for (;;) {
+        std::function<void()> task;
+        if (popLocal(index, task) || steal(index, task)) {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_workAvailable.wait(lock, [this] { return m_stopping || m_queued.load() > 0; });
+        if (m_stopping && m_queued.load() == 0) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef WORK_POOL_HPP
+#define WORK_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker runs
+// its newest task first and, when its deque is empty, steals the oldest
+// task from another worker, so uneven tasks still keep every core busy.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = 0);   // 0 = all cores
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned getWorkerCount() const { return static_cast<unsigned>(m_queues.size()); }
+
+    // Queue a task. From a worker thread it goes to that worker's own deque;
+    // from any other thread the deques are filled round-robin.
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task (including ones submitted by tasks)
+    // has finished
+    void wait();
+
+    // Run one queued task on the calling thread, if there is one. Lets a
+    // thread that is waiting for some of the pool's work help with it
+    // instead of blocking a worker.
+    bool runPendingTask();
+
+    // Index of the pool worker running the calling thread, or -1
+    static int currentWorker();
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popLocal(unsigned index, std::function<void()>& task);
+    bool steal(unsigned thief, std::function<void()>& task);
+    void runTask(std::function<void()>& task);
+    void workerLoop(unsigned index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<size_t> m_queued{0};        // Tasks waiting in a deque
+    std::atomic<size_t> m_unfinished{0};    // Tasks submitted but not finished
+    std::atomic<unsigned> m_nextQueue{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_allDone;
+    bool m_stopping = false;
+};
+
+#endif // WORK_POOL_HPP